@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+////////////////////////
+/// ALIGNED ALLOCATOR
+////////////////////////
+
+/**
+ * A standard allocator handing out storage aligned to ( at least ) Alignment bytes.
+ * The default keeps the storage on its own cache lines.
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+	static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+public:
+	using value_type = T;
+
+	static constexpr std::align_val_t alignment{ Alignment < alignof(T) ? alignof(T) : Alignment };
+
+	template <typename U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() noexcept = default;
+
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+	{
+	}
+
+	[[nodiscard]] T* allocate(std::size_t n)
+	{
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+			throw std::bad_array_new_length();
+
+		return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+	}
+
+	void deallocate(T* ptr, std::size_t) noexcept
+	{
+		::operator delete(ptr, alignment);
+	}
+
+	template <typename U>
+	friend bool operator==(const AlignedAllocator&, const AlignedAllocator<U, Alignment>&) noexcept { return true; }
+
+	template <typename U>
+	friend bool operator!=(const AlignedAllocator&, const AlignedAllocator<U, Alignment>&) noexcept { return false; }
+};
+
+////////////////////////
+/// HUGE PAGE ALLOCATOR
+////////////////////////
+
+/**
+ * A standard allocator for large, long lived buffers.
+ *
+ * On Linux the storage is mapped directly, rounded up to whole huge pages and
+ * advised as MADV_HUGEPAGE so transparent huge pages can back it ( fewer TLB misses ).
+ * Elsewhere it falls back to huge page aligned operator new.
+ */
+template <typename T>
+class HugePageAllocator
+{
+public:
+	using value_type = T;
+
+	static constexpr std::size_t HugePageSize = std::size_t{ 2 } << 20;
+
+	HugePageAllocator() noexcept = default;
+
+	template <typename U>
+	HugePageAllocator(const HugePageAllocator<U>&) noexcept
+	{
+	}
+
+	[[nodiscard]] T* allocate(std::size_t n)
+	{
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T) - HugePageSize)
+			throw std::bad_array_new_length();
+
+#if defined(__linux__)
+		const std::size_t bytes = roundUp(n * sizeof(T));
+
+		// Over-map by one huge page so the start can be aligned, then give the slack back
+		void* raw = mmap(nullptr, bytes + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw == MAP_FAILED)
+			throw std::bad_alloc();
+
+		const auto address = reinterpret_cast<std::uintptr_t>(raw);
+		const auto aligned = (address + HugePageSize - 1) & ~(HugePageSize - 1);
+
+		if (aligned != address)
+			munmap(raw, aligned - address);
+		if (const std::size_t after = HugePageSize - (aligned - address); after != 0)
+			munmap(reinterpret_cast<void*>(aligned + bytes), after);
+
+#if defined(MADV_HUGEPAGE)
+		madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+
+		return reinterpret_cast<T*>(aligned);
+#else
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ HugePageSize }));
+#endif
+	}
+
+	void deallocate(T* ptr, std::size_t n) noexcept
+	{
+#if defined(__linux__)
+		munmap(ptr, roundUp(n * sizeof(T)));
+#else
+		::operator delete(ptr, std::align_val_t{ HugePageSize });
+#endif
+	}
+
+	template <typename U>
+	friend bool operator==(const HugePageAllocator&, const HugePageAllocator<U>&) noexcept { return true; }
+
+	template <typename U>
+	friend bool operator!=(const HugePageAllocator&, const HugePageAllocator<U>&) noexcept { return false; }
+
+private:
+	static constexpr std::size_t roundUp(std::size_t bytes) noexcept
+	{
+		return bytes == 0 ? HugePageSize : (bytes + HugePageSize - 1) & ~(HugePageSize - 1);
+	}
+};
+
+////////////////////////
+/// DEFAULT INIT ALLOCATOR
+////////////////////////
+
+/**
+ * An allocator adaptor which default-initializes instead of value-initializing, so resizing
+ * a container of trivial elements leaves them uninitialized instead of zeroing them.
+ * Lets the first write to a fresh buffer happen where ( and on which thread ) it matters.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class DefaultInitAllocator : public Allocator
+{
+	using Traits = std::allocator_traits<Allocator>;
+
+public:
+	template <typename U>
+	struct rebind
+	{
+		using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+	};
+
+	using Allocator::Allocator;
+
+	template <typename U>
+	void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+	{
+		::new (static_cast<void*>(ptr)) U;
+	}
+
+	template <typename U, typename... Args>
+	void construct(U* ptr, Args&&... args)
+	{
+		Traits::construct(static_cast<Allocator&>(*this), ptr, std::forward<Args>(args)...);
+	}
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+////////////////////////
+/// BLOCK COMPRESSION
+////////////////////////
+
+/**
+ * A byte-oriented LZ77 block codec in the LZ4 block format: sequences of a token, literals and a
+ * back-reference of up to 64 KiB, no entropy coding. Greedy single-probe matching makes it run at
+ * memory speed in both directions, which is what checkpointing wants more than the best ratio.
+ */
+namespace lz
+{
+	inline constexpr std::size_t MinMatch = 4;
+	inline constexpr std::size_t MaxOffset = 65535;
+	inline constexpr std::size_t LastLiterals = 5;		///< The format ends every block with at least this many literals.
+	inline constexpr std::size_t MatchFindLimit = 12;	///< No match starts in the last bytes of a block.
+	inline constexpr unsigned HashBits = 12;
+
+	/**
+	 * Largest compressed size of n bytes ( incompressible input grows slightly ).
+	 */
+	constexpr std::size_t compressBound(std::size_t n) noexcept
+	{
+		return n + n / 255 + 16;
+	}
+
+	inline std::uint32_t read32(const std::byte* p) noexcept
+	{
+		std::uint32_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	inline std::uint64_t read64(const std::byte* p) noexcept
+	{
+		std::uint64_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	inline std::uint32_t hash(std::uint32_t sequence) noexcept
+	{
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	/**
+	 * Writes a length past the 15 held by a token nibble, in 255 steps.
+	 */
+	inline std::byte* writeLength(std::byte* out, std::size_t length) noexcept
+	{
+		for (; length >= 255; length -= 255)
+			*out++ = std::byte{ 255 };
+		*out++ = static_cast<std::byte>(length);
+		return out;
+	}
+
+	inline std::byte* writeSequence(std::byte* out, const std::byte* literals, std::size_t literalLength, std::size_t offset, std::size_t matchLength) noexcept
+	{
+		std::byte* token = out++;
+		const std::size_t matchCode = matchLength - MinMatch;
+		*token = static_cast<std::byte>(((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+
+		if (literalLength >= 15)
+			out = writeLength(out, literalLength - 15);
+		std::memcpy(out, literals, literalLength);
+		out += literalLength;
+
+		*out++ = static_cast<std::byte>(offset & 0xFF);
+		*out++ = static_cast<std::byte>(offset >> 8);
+
+		if (matchCode >= 15)
+			out = writeLength(out, matchCode - 15);
+		return out;
+	}
+
+	/**
+	 * Compresses n bytes from src into dst, which must hold compressBound( n ) bytes. Returns the compressed size.
+	 */
+	inline std::size_t compress(const std::byte* src, std::size_t n, std::byte* dst)
+	{
+		std::byte* out = dst;
+		std::size_t anchor = 0;
+
+		if (n >= MatchFindLimit + 1)
+		{
+			std::vector<std::uint32_t> table(std::size_t{ 1 } << HashBits, 0);
+			const std::size_t matchLimit = n - MatchFindLimit;
+			const std::size_t matchEnd = n - LastLiterals;
+
+			std::size_t ip = 1;
+			while (ip < matchLimit)
+			{
+				const std::uint32_t sequence = read32(src + ip);
+				const std::uint32_t h = hash(sequence);
+				std::size_t candidate = table[h];
+				table[h] = static_cast<std::uint32_t>(ip);
+
+				if (ip - candidate > MaxOffset || read32(src + candidate) != sequence)
+				{
+					// Skip faster through data that does not compress
+					ip += 1 + ((ip - anchor) >> 6);
+					continue;
+				}
+
+				// Extend backwards over literals, then forwards 8 bytes at a time
+				while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1])
+				{
+					--ip;
+					--candidate;
+				}
+
+				std::size_t length = MinMatch;
+				while (ip + length + 8 <= matchEnd && read64(src + ip + length) == read64(src + candidate + length))
+					length += 8;
+				while (ip + length < matchEnd && src[ip + length] == src[candidate + length])
+					++length;
+
+				out = writeSequence(out, src + anchor, ip - anchor, ip - candidate, length);
+				ip += length;
+				anchor = ip;
+
+				if (ip - 2 < matchLimit)
+					table[hash(read32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 2);
+			}
+		}
+
+		// The last literals, in a sequence without a match
+		const std::size_t literalLength = n - anchor;
+		*out++ = static_cast<std::byte>((literalLength < 15 ? literalLength : 15) << 4);
+		if (literalLength >= 15)
+			out = writeLength(out, literalLength - 15);
+		if (literalLength != 0)	// src may be null for an empty block
+			std::memcpy(out, src + anchor, literalLength);
+		out += literalLength;
+
+		return static_cast<std::size_t>(out - dst);
+	}
+
+	/**
+	 * Decompresses the n byte block at src into exactly rawSize bytes at dst.
+	 * Throws std::runtime_error on malformed input rather than reading or writing out of bounds.
+	 */
+	inline void decompress(const std::byte* src, std::size_t n, std::byte* dst, std::size_t rawSize)
+	{
+		const auto corrupt = []() { throw std::runtime_error("Corrupt compressed block"); };
+
+		const auto readLength = [&](std::size_t& ip, std::size_t length)
+		{
+			if (length != 15)
+				return length;
+
+			std::byte next;
+			do
+			{
+				if (ip == n)
+					corrupt();
+				next = src[ip++];
+				length += static_cast<std::size_t>(next);
+			} while (next == std::byte{ 255 });
+			return length;
+		};
+
+		std::size_t ip = 0;
+		std::size_t op = 0;
+		for (;;)
+		{
+			if (ip == n)
+				corrupt();
+			const auto token = static_cast<std::size_t>(src[ip++]);
+
+			const std::size_t literalLength = readLength(ip, token >> 4);
+			if (literalLength > n - ip || literalLength > rawSize - op)
+				corrupt();
+			if (literalLength != 0)	// dst may be null for an empty block
+				std::memcpy(dst + op, src + ip, literalLength);
+			ip += literalLength;
+			op += literalLength;
+
+			if (ip == n)
+				break;
+
+			if (n - ip < 2)
+				corrupt();
+			const std::size_t offset = static_cast<std::size_t>(src[ip]) | (static_cast<std::size_t>(src[ip + 1]) << 8);
+			ip += 2;
+
+			const std::size_t matchLength = readLength(ip, token & 15) + MinMatch;
+			if (offset == 0 || offset > op || matchLength > rawSize - op)
+				corrupt();
+
+			std::byte* out = dst + op;
+			const std::byte* match = out - offset;
+			// Overlapping matches repeat the last offset bytes, copied in doubling whole periods
+			for (std::size_t copied = 0; copied < matchLength;)
+			{
+				const std::size_t chunk = std::min(copied + offset, matchLength - copied);
+				std::memcpy(out + copied, match, chunk);
+				copied += chunk;
+			}
+			op += matchLength;
+		}
+
+		if (op != rawSize)
+			corrupt();
+	}
+}
@@ -1,20 +1,270 @@
 #pragma once
 
+#include "AlignedAllocator.hpp"
+
 #include <optional>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 ////////////////////////
-/// CIRCULAR BUFFER
+/// BUFFER SPAN
 ////////////////////////
 
+/**
+ * A non-owning view over a contiguous run of elements ( a minimal std::span ).
+ */
+template <typename T>
+class BufferSpan
+{
+public:
+	using value_type = std::remove_cv_t<T>;
+	using iterator = T*;
+
+	constexpr BufferSpan() noexcept = default;
+
+	constexpr BufferSpan(T* ptr, size_t count) noexcept
+		: ptr{ ptr }
+		, count{ count }
+	{
+	}
+
+	[[nodiscard]] constexpr T* data() const noexcept { return ptr; }
+	[[nodiscard]] constexpr size_t size() const noexcept { return count; }
+	[[nodiscard]] constexpr size_t size_bytes() const noexcept { return count * sizeof(T); }
+	[[nodiscard]] constexpr bool empty() const noexcept { return count == 0; }
+
+	constexpr T& operator[](size_t index) const noexcept { return ptr[index]; }
+
+	constexpr iterator begin() const noexcept { return ptr; }
+	constexpr iterator end() const noexcept { return ptr + count; }
+
+private:
+	T* ptr = nullptr;
+	size_t count = 0;
+};
+
+////////////////////////
+/// CIRCULAR BUFFER STORAGE
+////////////////////////
+
+/**
+ * Inline storage for N elements. Extent is the compile time size ( 0 when only known at runtime ).
+ */
 template <typename T, size_t N>
-class CircularBuffer
+class FixedStorage
 {
+	static_assert(N > 0, "Capacity must be positive");
+
 public:
-	CircularBuffer()
-		: capacity{ N }
+	static constexpr size_t Extent = N;
+
+	T* data() noexcept { return elements.data(); }
+	const T* data() const noexcept { return elements.data(); }
+	[[nodiscard]] static constexpr size_t size() noexcept { return N; }
+
+	T& operator[](size_t index) noexcept { return elements[index]; }
+	const T& operator[](size_t index) const noexcept { return elements[index]; }
+
+private:
+	std::array<T, N> elements;
+};
+
+/**
+ * Heap storage for a capacity chosen at runtime, obtained from Allocator.
+ * Elements are value initialized up front, mirroring std::array.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class HeapStorage
+{
+	using Traits = std::allocator_traits<Allocator>;
+
+public:
+	static constexpr size_t Extent = 0;
+
+	HeapStorage(size_t count, const Allocator& alloc = Allocator())
+		: allocator{ alloc }
+		, count{ count }
+	{
+		if (count == 0)
+			throw std::invalid_argument("Size must be positive");
+
+		create();
+	}
+
+	/**
+	 * Copies of moved-from storage are empty too.
+	 */
+	HeapStorage(const HeapStorage& other)
+		: allocator{ Traits::select_on_container_copy_construction(other.allocator) }
+		, count{ other.count }
+	{
+		if (count == 0)
+			return;
+
+		create();
+		std::copy(other.elements, other.elements + count, elements);
+	}
+
+	HeapStorage(HeapStorage&& other) noexcept
+		: allocator{ std::move(other.allocator) }
+		, elements{ std::exchange(other.elements, nullptr) }
+		, count{ std::exchange(other.count, 0) }
+	{
+	}
+
+	HeapStorage& operator=(HeapStorage other) noexcept
+	{
+		std::swap(allocator, other.allocator);
+		std::swap(elements, other.elements);
+		std::swap(count, other.count);
+		return *this;
+	}
+
+	~HeapStorage()
+	{
+		destroy(count);
+	}
+
+	T* data() noexcept { return elements; }
+	const T* data() const noexcept { return elements; }
+	[[nodiscard]] size_t size() const noexcept { return count; }
+
+	T& operator[](size_t index) noexcept { return elements[index]; }
+	const T& operator[](size_t index) const noexcept { return elements[index]; }
+
+private:
+	void create()
+	{
+		elements = Traits::allocate(allocator, count);
+		size_t constructed = 0;
+		try
+		{
+			for (; constructed < count; ++constructed)
+				Traits::construct(allocator, elements + constructed);
+		}
+		catch (...)
+		{
+			destroy(constructed);
+			throw;
+		}
+	}
+
+	void destroy(size_t constructed) noexcept
+	{
+		if (elements == nullptr)
+			return;
+
+		for (size_t i = 0; i < constructed; ++i)
+			Traits::destroy(allocator, elements + i);
+
+		Traits::deallocate(allocator, elements, count);
+		elements = nullptr;
+	}
+
+	Allocator allocator;
+	T* elements = nullptr;
+	size_t count;
+};
+
+////////////////////////
+/// CIRCULAR BUFFER
+////////////////////////
+
+/**
+ * The circular buffer logic, shared by every storage. Use CircularBuffer or DynamicCircularBuffer.
+ */
+template <typename T, typename Storage>
+class BasicCircularBuffer
+{
+	static constexpr size_t Extent = Storage::Extent;
+
+	/**
+	 * Power of two buffers which have not been resized wrap with a mask instead of a division.
+	 * Fixed buffers know this at compile time, runtime sized ones keep a mask around.
+	 */
+	static constexpr bool IsPowerOfTwo = Extent != 0 && (Extent & (Extent - 1)) == 0;
+
+	template <bool IsConst>
+	class Iterator;
+
+public:
+	/**
+	 * STL compatible. Iterators walk the elements in logical order ( oldest first ).
+	 */
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	/**
+	 * @brief The largest size the buffer can be resized to
+	 */
+	[[nodiscard]] size_t maxSize() const noexcept { return storage.size(); }
+
+	iterator begin() noexcept
+	{
+		return { this, 0 };
+	}
+
+	[[nodiscard]] const_iterator begin() const noexcept
+	{
+		return { this, 0 };
+	}
+
+	[[nodiscard]] const_iterator cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	iterator end() noexcept
+	{
+		return { this, size() };
+	}
+
+	[[nodiscard]] const_iterator end() const noexcept
+	{
+		return { this, size() };
+	}
+
+	[[nodiscard]] const_iterator cend() const noexcept
+	{
+		return end();
+	}
+
+	reverse_iterator rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	[[nodiscard]] const_reverse_iterator rbegin() const noexcept
 	{
+		return const_reverse_iterator(end());
+	}
+
+	reverse_iterator rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	[[nodiscard]] const_reverse_iterator rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
 	}
 
 	/**
@@ -25,16 +275,23 @@ public:
 	 */
 	std::optional<T> add(T elem)
 	{
+		if constexpr (Extent == 0)
+		{
+			// Moved-from heap storage holds nothing, the element is ejected straight away
+			if (capacity == 0)
+				return elem;
+		}
+
 		std::optional<T> old_elem;
 
-		if (current == capacity)
+		if (tail - head == capacity)
 		{
-			old_elem = std::move(data[current % capacity]);
-			start = (start + 1) % capacity;
+			old_elem = std::move(storage[wrap(head)]);
+			++head;
 		}
 
-		data[current % capacity] = std::move(elem);
-		++current;
+		storage[wrap(tail)] = std::move(elem);
+		++tail;
 
 		return old_elem;
 	}
@@ -47,7 +304,7 @@ public:
 	 */
 	T& operator[](int index)
 	{
-		return data[(start + index) % capacity];
+		return storage[wrap(head + index)];
 	}
 
 	/**
@@ -58,7 +315,7 @@ public:
 	 */
 	const T& operator[](int index) const
 	{
-		return data[(start + index) % capacity];
+		return storage[wrap(head + index)];
 	}
 
 	/**
@@ -69,7 +326,7 @@ public:
 	 */
 	const T& at(int index) const
 	{
-		if (index < 0 || index >= size())
+		if (index < 0 || static_cast<size_t>(index) >= size())
 			throw std::out_of_range("Index out of range");
 
 		return (*this)[index];
@@ -83,7 +340,7 @@ public:
 	 */
 	T& at(int index)
 	{
-		if (index < 0 || index >= size())
+		if (index < 0 || static_cast<size_t>(index) >= size())
 			throw std::out_of_range("Index out of range");
 
 		return (*this)[index];
@@ -96,10 +353,10 @@ public:
 	 */
 	T& top()
 	{
-		if (current == 0)
+		if (empty())
 			throw std::underflow_error("Buffer is empty");
 
-		return data[start];
+		return storage[wrap(head)];
 	}
 
 	/**
@@ -109,29 +366,143 @@ public:
 	 */
 	T pop()
 	{
-		if (current == 0)
+		if (empty())
 			throw std::underflow_error("Buffer is empty");
 
-		--current;
-		return data[current % capacity];
+		--tail;
+		return std::move(storage[wrap(tail)]);
 	}
 
-	int startPos() const noexcept { return start; }
-	[[nodiscard]] size_t realSize() const noexcept { return current; }
-	[[nodiscard]] size_t size() const noexcept { return current > capacity ? capacity : current; }
-	[[nodiscard]] bool empty() const noexcept { return current == 0; }
+	/**
+	 * @brief Adds a run of elements, equivalent to calling add() on each but without returning the ejected ones
+	 *
+	 * @param elems The elements being added
+	 * @param n Number of elements
+	 * @return size_t Number of elements ejected
+	 */
+	size_t push_bulk(const T* elems, size_t n)
+	{
+		const size_t before = size();
+
+		// Only the newest capacity elements can survive
+		const size_t written = std::min(n, capacity);
+		elems += n - written;
+		tail += n;
+		if (tail - head > capacity)
+			head = tail - capacity;
+
+		const size_t pos = wrap(tail - written);
+		const size_t first = std::min(written, capacity - pos);
+		copyElements(storage.data() + pos, elems, first);
+		copyElements(storage.data(), elems + first, written - first);
+
+		return before + n - size();
+	}
+
+	/**
+	 * @brief Removes up to n of the oldest elements, in order. Unlike pop(), this consumes from the front
+	 *
+	 * @param out Destination for the elements
+	 * @param n Maximum number of elements
+	 * @return size_t Number of elements removed
+	 */
+	size_t pop_bulk(T* out, size_t n)
+	{
+		const size_t count = std::min(n, size());
+		const auto [first, second] = spans();
+		const size_t fromFirst = std::min(count, first.size());
+
+		moveElements(out, first.data(), fromFirst);
+		moveElements(out + fromFirst, second.data(), count - fromFirst);
+
+		head += count;
+		return count;
+	}
+
+	/**
+	 * @brief Discards up to n of the oldest elements, e.g. once they were written out through spans()
+	 *
+	 * @param n Maximum number of elements
+	 * @return size_t Number of elements discarded
+	 */
+	size_t consume(size_t n) noexcept
+	{
+		const size_t count = std::min(n, size());
+		head += count;
+		return count;
+	}
+
+	/**
+	 * @brief The elements in order as ( at most ) two contiguous runs, the second is empty unless the buffer wraps
+	 *
+	 * @return std::pair<BufferSpan<T>, BufferSpan<T>> The runs
+	 */
+	std::pair<BufferSpan<T>, BufferSpan<T>> spans() noexcept
+	{
+		const size_t pos = wrap(head);
+		const size_t first = std::min(size(), capacity - pos);
+		return { { storage.data() + pos, first }, { storage.data(), size() - first } };
+	}
+
+	/**
+	 * @brief The elements in order as ( at most ) two contiguous runs, the second is empty unless the buffer wraps
+	 *
+	 * @return std::pair<BufferSpan<const T>, BufferSpan<const T>> The runs
+	 */
+	std::pair<BufferSpan<const T>, BufferSpan<const T>> spans() const noexcept
+	{
+		const size_t pos = wrap(head);
+		const size_t first = std::min(size(), capacity - pos);
+		return { { storage.data() + pos, first }, { storage.data(), size() - first } };
+	}
+
+	/**
+	 * @brief Calls f once per contiguous run of elements ( at most twice ), in order.
+	 * Lets per-element loops vectorize instead of wrapping every index.
+	 *
+	 * @param f Callable taking a BufferSpan<T>
+	 */
+	template <typename F>
+	void forEachSegment(F&& f)
+	{
+		auto [first, second] = spans();
+		if (!first.empty())
+			f(first);
+		if (!second.empty())
+			f(second);
+	}
+
+	/**
+	 * @brief Calls f once per contiguous run of elements ( at most twice ), in order.
+	 *
+	 * @param f Callable taking a BufferSpan<const T>
+	 */
+	template <typename F>
+	void forEachSegment(F&& f) const
+	{
+		auto [first, second] = spans();
+		if (!first.empty())
+			f(first);
+		if (!second.empty())
+			f(second);
+	}
+
+	int startPos() const noexcept { return static_cast<int>(wrap(head)); }
+	[[nodiscard]] size_t realSize() const noexcept { return tail; }
+	[[nodiscard]] size_t size() const noexcept { return tail - head; }
+	[[nodiscard]] bool empty() const noexcept { return tail == head; }
 
 	/**
 	 * @brief Removes all elements from the buffer
 	 */
 	void clear()
 	{
-		current = 0;
-		start = 0;
+		head = 0;
+		tail = 0;
 	}
 
 	/**
-	 * @brief Changes the size of the buffer
+	 * @brief Changes the size of the buffer, keeping the newest elements if it shrinks
 	 *
 	 * @param new_size The new size of the buffer
 	 */
@@ -140,23 +511,639 @@ public:
 		if (new_size <= 0)
 			throw std::invalid_argument("Size must be positive");
 
-		if (new_size > N)
+		if (new_size > storage.size())
 			throw std::length_error("Size exceeds maximum capacity");
 
-		if (new_size < size())
+		const size_t count = size();
+		const size_t kept = std::min(count, new_size);
+
+		// Unwrap so the oldest element sits at the front, then drop what no longer fits
+		std::rotate(storage.data(), storage.data() + wrap(head), storage.data() + capacity);
+		std::move(storage.data() + (count - kept), storage.data() + count, storage.data());
+
+		head = tail - kept;
+		setCapacity(new_size);
+
+		// Wrap again so that element i lives at ( head + i ) % capacity
+		std::rotate(storage.data(), storage.data() + (capacity - wrap(head)) % capacity, storage.data() + capacity);
+	}
+
+	BasicCircularBuffer(const BasicCircularBuffer&) = default;
+	BasicCircularBuffer& operator=(const BasicCircularBuffer&) = default;
+
+	/**
+	 * @brief Takes the elements of other, which is left empty with whatever capacity its storage kept
+	 * ( none for heap storage, add() then ejects every element straight away )
+	 */
+	BasicCircularBuffer(BasicCircularBuffer&& other) noexcept(std::is_nothrow_move_constructible_v<Storage>)
+		: head{ std::exchange(other.head, 0) }
+		, tail{ std::exchange(other.tail, 0) }
+		, capacity{ other.capacity }
+		, mask{ other.mask }
+		, storage(std::move(other.storage))
+	{
+		other.setCapacity(other.storage.size());
+	}
+
+	BasicCircularBuffer& operator=(BasicCircularBuffer&& other) noexcept(std::is_nothrow_move_assignable_v<Storage>)
+	{
+		if (this != &other)
+		{
+			storage = std::move(other.storage);
+			head = std::exchange(other.head, 0);
+			tail = std::exchange(other.tail, 0);
+			setCapacity(other.capacity);
+			other.setCapacity(other.storage.size());
+		}
+		return *this;
+	}
+
+protected:
+	template <typename... Args>
+	explicit BasicCircularBuffer(std::in_place_t, Args&&... args)
+		: storage(std::forward<Args>(args)...)
+	{
+		setCapacity(storage.size());
+	}
+
+private:
+	/**
+	 * Random access iterator over the logical ( unwrapped ) order of the elements.
+	 */
+	template <bool IsConst>
+	class Iterator
+	{
+		using Buffer = std::conditional_t<IsConst, const BasicCircularBuffer, BasicCircularBuffer>;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<IsConst, const T*, T*>;
+		using reference = std::conditional_t<IsConst, const T&, T&>;
+
+		Iterator() noexcept = default;
+
+		Iterator(Buffer* buffer, size_t index) noexcept
+			: buffer{ buffer }
+			, index{ index }
+		{
+		}
+
+		/**
+		 * Allow iterator -> const_iterator.
+		 */
+		template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: buffer{ other.buffer }
+			, index{ other.index }
+		{
+		}
+
+		reference operator*() const { return buffer->storage[buffer->wrap(buffer->head + index)]; }
+		pointer operator->() const { return &**this; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		Iterator& operator++() noexcept { ++index; return *this; }
+		Iterator& operator--() noexcept { --index; return *this; }
+		Iterator operator++(int) noexcept { auto old = *this; ++index; return old; }
+		Iterator operator--(int) noexcept { auto old = *this; --index; return old; }
+
+		Iterator& operator+=(difference_type n) noexcept { index += n; return *this; }
+		Iterator& operator-=(difference_type n) noexcept { index -= n; return *this; }
+
+		friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+		friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+		friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+
+		friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept
 		{
-			current = new_size;
-			start = 0;
+			return static_cast<difference_type>(lhs.index) - static_cast<difference_type>(rhs.index);
+		}
+
+		friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index == rhs.index; }
+		friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index != rhs.index; }
+		friend bool operator<(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index < rhs.index; }
+		friend bool operator>(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index > rhs.index; }
+		friend bool operator<=(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index <= rhs.index; }
+		friend bool operator>=(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index >= rhs.index; }
+
+	private:
+		friend class Iterator<!IsConst>;
+
+		Buffer* buffer = nullptr;
+		size_t index = 0;
+	};
+
+	static void copyElements(T* dst, const T* src, size_t n)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			if (n != 0)
+				std::memcpy(dst, src, n * sizeof(T));
 		}
 		else
 		{
-			capacity = new_size;
+			std::copy(src, src + n, dst);
 		}
 	}
 
+	static void moveElements(T* dst, T* src, size_t n)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			if (n != 0)
+				std::memcpy(dst, src, n * sizeof(T));
+		}
+		else
+		{
+			std::move(src, src + n, dst);
+		}
+	}
+
+	/**
+	 * @brief Maps a monotonic counter onto the storage
+	 */
+	[[nodiscard]] size_t wrap(std::uint64_t counter) const noexcept
+	{
+		if constexpr (IsPowerOfTwo)
+		{
+			if (capacity == Extent)
+				return static_cast<size_t>(counter & (Extent - 1));
+		}
+		else if constexpr (Extent == 0)
+		{
+			if (mask != 0)
+				return static_cast<size_t>(counter & mask);
+			if (capacity == 0)
+				return 0;
+		}
+
+		return static_cast<size_t>(counter % capacity);
+	}
+
+	void setCapacity(size_t new_capacity) noexcept
+	{
+		capacity = new_capacity;
+		mask = capacity != 0 && (capacity & (capacity - 1)) == 0 ? capacity - 1 : 0;
+	}
+
+	std::uint64_t head = 0;	///< Counter of the oldest element.
+	std::uint64_t tail = 0;	///< Counter one past the newest element, also the real size.
+	size_t capacity = 0;
+	size_t mask = 0;	///< capacity - 1 for power of two capacities, only used by runtime sized storage.
+	Storage storage;
+};
+
+/**
+ * A fixed capacity circular buffer, stored inline.
+ */
+template <typename T, size_t N>
+class CircularBuffer : public BasicCircularBuffer<T, FixedStorage<T, N>>
+{
+public:
+	CircularBuffer()
+		: BasicCircularBuffer<T, FixedStorage<T, N>>(std::in_place)
+	{
+	}
+};
+
+/**
+ * A circular buffer whose capacity is chosen at runtime, stored on the heap through Allocator.
+ *
+ * Pass AlignedAllocator or HugePageAllocator to control where large buffers live.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class DynamicCircularBuffer : public BasicCircularBuffer<T, HeapStorage<T, Allocator>>
+{
+public:
+	explicit DynamicCircularBuffer(size_t capacity, const Allocator& alloc = Allocator())
+		: BasicCircularBuffer<T, HeapStorage<T, Allocator>>(std::in_place, capacity, alloc)
+	{
+	}
+};
+
+////////////////////////
+/// SPSC CIRCULAR BUFFER
+////////////////////////
+
+/**
+ * Size used to keep independently written atomics on separate cache lines.
+ * (std::hardware_destructive_interference_size is not reliably available, and is ABI unstable)
+ */
+inline constexpr std::size_t CacheLineSize = 64;
+
+/**
+ * A lock-free single-producer/single-consumer ring with the same fixed storage as CircularBuffer.
+ *
+ * Exactly one thread may call try_push() and exactly one (other) thread may call try_pop().
+ * Unlike CircularBuffer::add(), a full buffer never overwrites, try_push() fails instead.
+ */
+template <typename T, size_t N>
+class SpscCircularBuffer
+{
+	static_assert(N > 0, "Capacity must be positive");
+
+public:
+	SpscCircularBuffer() = default;
+	SpscCircularBuffer(const SpscCircularBuffer&) = delete;
+	SpscCircularBuffer& operator=(const SpscCircularBuffer&) = delete;
+
+	/**
+	 * @brief Pushes an element if there is room ( producer only )
+	 *
+	 * @param elem The element being added
+	 * @return bool Whether the element was added
+	 */
+	bool try_push(const T& elem)
+	{
+		return emplace(elem);
+	}
+
+	/**
+	 * @brief Pushes an element if there is room ( producer only )
+	 *
+	 * @param elem The element being added, only moved from on success
+	 * @return bool Whether the element was added
+	 */
+	bool try_push(T&& elem)
+	{
+		return emplace(std::move(elem));
+	}
+
+	/**
+	 * @brief Removes the oldest element if there is one ( consumer only )
+	 *
+	 * @return std::optional<T> The element, or empty if the buffer is empty
+	 */
+	std::optional<T> try_pop()
+	{
+		const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+
+		if (head == consumer.cachedTail)
+		{
+			consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+			if (head == consumer.cachedTail)
+				return std::nullopt;
+		}
+
+		std::optional<T> elem{ std::move(data[head % N]) };
+		consumer.head.store(head + 1, std::memory_order_release);
+		return elem;
+	}
+
+	/**
+	 * @brief Approximate number of elements, exact only when called by either end while the other is idle
+	 */
+	[[nodiscard]] size_t size() const noexcept
+	{
+		const std::size_t head = consumer.head.load(std::memory_order_acquire);
+		const std::size_t tail = producer.tail.load(std::memory_order_acquire);
+		return tail - head;
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+	[[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+
 private:
-	int current = 0;
-	int start = 0;
-	size_t capacity;
+	template <typename U>
+	bool emplace(U&& elem)
+	{
+		const std::size_t tail = producer.tail.load(std::memory_order_relaxed);
+
+		if (tail - producer.cachedHead == N)
+		{
+			producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+			if (tail - producer.cachedHead == N)
+				return false;
+		}
+
+		data[tail % N] = std::forward<U>(elem);
+		producer.tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Each side owns its index plus a cached copy of the other side's index,
+	 * so the shared cache line is only touched when the cache looks full/empty.
+	 */
+	struct alignas(CacheLineSize) ProducerState
+	{
+		std::atomic<std::size_t> tail{ 0 };
+		std::size_t cachedHead = 0;
+	};
+
+	struct alignas(CacheLineSize) ConsumerState
+	{
+		std::atomic<std::size_t> head{ 0 };
+		std::size_t cachedTail = 0;
+	};
+
+	ProducerState producer;
+	ConsumerState consumer;
 	std::array<T, N> data;
 };
+
+////////////////////////
+/// MPMC CIRCULAR BUFFER
+////////////////////////
+
+/**
+ * A bounded multi-producer/multi-consumer ring ( Dmitry Vyukov's design ).
+ *
+ * Every slot carries a sequence number telling producers and consumers whose turn it is,
+ * so the only contended operations are a CAS on the enqueue or dequeue position.
+ * Like SpscCircularBuffer, a full buffer never overwrites.
+ */
+template <typename T, size_t N>
+class MpmcCircularBuffer
+{
+	static_assert(N > 0, "Capacity must be positive");
+
+public:
+	MpmcCircularBuffer()
+	{
+		for (std::size_t i = 0; i < N; ++i)
+			data[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MpmcCircularBuffer(const MpmcCircularBuffer&) = delete;
+	MpmcCircularBuffer& operator=(const MpmcCircularBuffer&) = delete;
+
+	/**
+	 * @brief Pushes an element if there is room
+	 *
+	 * @param elem The element being added
+	 * @return bool Whether the element was added
+	 */
+	bool try_push(const T& elem)
+	{
+		return emplace(elem);
+	}
+
+	/**
+	 * @brief Pushes an element if there is room
+	 *
+	 * @param elem The element being added, only moved from on success
+	 * @return bool Whether the element was added
+	 */
+	bool try_push(T&& elem)
+	{
+		return emplace(std::move(elem));
+	}
+
+	/**
+	 * @brief Pushes an element, waiting for room if the buffer is full
+	 *
+	 * @param elem The element being added
+	 */
+	void push(T elem)
+	{
+		for (unsigned spins = 0; !emplace(std::move(elem)); ++spins)
+			backoff(spins);
+	}
+
+	/**
+	 * @brief Removes the oldest element if there is one
+	 *
+	 * @return std::optional<T> The element, or empty if the buffer is empty
+	 */
+	std::optional<T> try_pop()
+	{
+		std::size_t pos = dequeuePos.value.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			Slot& slot = data[pos % N];
+			const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+
+			if (diff == 0)
+			{
+				if (dequeuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					std::optional<T> elem{ std::move(slot.value) };
+					slot.sequence.store(pos + N, std::memory_order_release);
+					return elem;
+				}
+			}
+			else if (diff < 0)
+			{
+				return std::nullopt;
+			}
+			else
+			{
+				pos = dequeuePos.value.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * @brief Removes the oldest element, waiting for one if the buffer is empty
+	 *
+	 * @return T The element
+	 */
+	T pop()
+	{
+		for (unsigned spins = 0;; ++spins)
+		{
+			if (auto elem = try_pop())
+				return std::move(*elem);
+
+			backoff(spins);
+		}
+	}
+
+	/**
+	 * @brief Approximate number of elements, only a snapshot while other threads are active
+	 */
+	[[nodiscard]] size_t size() const noexcept
+	{
+		const std::size_t head = dequeuePos.value.load(std::memory_order_acquire);
+		const std::size_t tail = enqueuePos.value.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+	[[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+
+private:
+	template <typename U>
+	bool emplace(U&& elem)
+	{
+		std::size_t pos = enqueuePos.value.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			Slot& slot = data[pos % N];
+			const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+			if (diff == 0)
+			{
+				if (enqueuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					slot.value = std::forward<U>(elem);
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = enqueuePos.value.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * Spin briefly before giving the core away, waiting is expected to be short under load.
+	 */
+	static void backoff(unsigned spins)
+	{
+		if (spins >= 64)
+			std::this_thread::yield();
+	}
+
+	struct Slot
+	{
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+
+	struct alignas(CacheLineSize) Position
+	{
+		std::atomic<std::size_t> value{ 0 };
+	};
+
+	Position enqueuePos;
+	Position dequeuePos;
+	std::array<Slot, N> data;
+};
+
+////////////////////////
+/// SEQLOCK CIRCULAR BUFFER
+////////////////////////
+
+/**
+ * An overwrite-on-full ring for a single writer and any number of readers ( e.g. a flight recorder ).
+ *
+ * The writer never blocks or waits for readers. Every slot is guarded by its own seqlock,
+ * so readers copy entries out optimistically and detect ones that were torn or overwritten meanwhile.
+ * Entries are identified by their position, the number of add() calls before them.
+ */
+template <typename T, size_t N>
+class SeqlockCircularBuffer
+{
+	static_assert(N > 0, "Capacity must be positive");
+	static_assert(std::is_trivially_copyable_v<T>, "Entries are copied byte wise, T must be trivially copyable");
+
+public:
+	SeqlockCircularBuffer() = default;
+	SeqlockCircularBuffer(const SeqlockCircularBuffer&) = delete;
+	SeqlockCircularBuffer& operator=(const SeqlockCircularBuffer&) = delete;
+
+	/**
+	 * @brief Adds an entry, overwriting the oldest one when full ( writer only )
+	 *
+	 * @param elem The entry being added
+	 */
+	void add(const T& elem) noexcept
+	{
+		const std::uint64_t pos = writePos;
+		Slot& slot = data[pos % N];
+
+		Word words[WordCount] = {};
+		std::memcpy(words, &elem, sizeof(T));
+
+		// An odd sequence marks the slot as being written
+		slot.sequence.store(2 * pos + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (size_t i = 0; i < WordCount; ++i)
+			slot.words[i].store(words[i], std::memory_order_relaxed);
+
+		slot.sequence.store(2 * pos + 2, std::memory_order_release);
+		writePos = pos + 1;
+		published.store(pos + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Reads the entry at a position
+	 *
+	 * @param pos Position of the entry
+	 * @return std::optional<T> The entry, or empty if it was not written yet, was overwritten, or is being written
+	 */
+	std::optional<T> read(std::uint64_t pos) const noexcept
+	{
+		const Slot& slot = data[pos % N];
+
+		const std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+		if (before != 2 * pos + 2)
+			return std::nullopt;
+
+		Word words[WordCount];
+		for (size_t i = 0; i < WordCount; ++i)
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != before)
+			return std::nullopt;
+
+		// T need not be default constructible, its bytes are copied into raw storage instead
+		alignas(T) std::byte elem[sizeof(T)];
+		std::memcpy(elem, words, sizeof(T));
+		return *std::launder(reinterpret_cast<const T*>(elem));
+	}
+
+	/**
+	 * @brief Copies out ( up to ) the latest count entries, oldest first, skipping any that could not be read consistently
+	 *
+	 * @param out Destination for the entries
+	 * @param count Maximum number of entries
+	 * @return size_t Number of entries copied
+	 */
+	size_t snapshot(T* out, size_t count) const noexcept
+	{
+		const std::uint64_t end = written();
+		const std::uint64_t begin = end - std::min<std::uint64_t>({ count, N, end });
+
+		size_t copied = 0;
+		for (std::uint64_t pos = begin; pos < end; ++pos)
+		{
+			if (auto elem = read(pos))
+				out[copied++] = *elem;
+		}
+
+		return copied;
+	}
+
+	/**
+	 * @brief Total number of entries added, the next entry's position
+	 */
+	[[nodiscard]] std::uint64_t written() const noexcept { return published.load(std::memory_order_acquire); }
+
+	[[nodiscard]] size_t size() const noexcept { return static_cast<size_t>(std::min<std::uint64_t>(written(), N)); }
+	[[nodiscard]] bool empty() const noexcept { return written() == 0; }
+	[[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+
+private:
+	/**
+	 * Payloads are stored as relaxed atomic words so optimistic reads are not data races.
+	 */
+	using Word = std::uint64_t;
+	static constexpr size_t WordCount = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+	struct Slot
+	{
+		std::atomic<std::uint64_t> sequence{ 0 };
+		std::atomic<Word> words[WordCount];
+	};
+
+	alignas(CacheLineSize) std::uint64_t writePos = 0;	///< The writer's own copy of published.
+	std::atomic<std::uint64_t> published{ 0 };
+	alignas(CacheLineSize) std::array<Slot, N> data;
+};
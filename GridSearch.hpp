@@ -0,0 +1,905 @@
+#pragma once
+
+#include "Parallel.hpp"
+#include "Vec2D.hpp"
+#include "Vec2DView.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+////////////////////////
+/// GRID SEARCH
+////////////////////////
+
+/**
+ * Searches over grids: scanline flood fill, breadth-first distances, shortest paths ( A* and Jump
+ * Point Search ) and connected-component labelling.
+ *
+ * A GridSearch owns every buffer the searches need, sized for one grid dimension when constructed,
+ * so searches reuse them and allocate nothing. Per-node search state is stamped with a query number
+ * instead of being cleared, so starting a path search costs the same whatever the grid size.
+ * Which cells can be entered is a predicate on the elements, e.g. []( std::uint8_t c ) { return c == 0; }
+ * for occupancy grids, evaluated during the search so the grid may change between queries.
+ */
+namespace vec2d
+{
+	/**
+	 * Which neighbours of a cell are adjacent to it.
+	 */
+	enum class Connectivity
+	{
+		Four,	///< Left, right, up and down.
+		Eight,	///< Diagonals too. Paths never cut corners: a diagonal step needs both cells beside it free.
+	};
+
+	/**
+	 * Path costs are in thousandths of a straight step, 64-bit so the longest path of a grid never wraps.
+	 */
+	using PathCost = std::uint64_t;
+
+	inline constexpr PathCost StraightCost = 1000;
+	inline constexpr PathCost DiagonalCost = 1414;
+
+	class GridSearch
+	{
+	public:
+		using Point = std::pair<std::size_t, std::size_t>;	///< x, y.
+
+		static constexpr std::uint32_t Unreached = std::numeric_limits<std::uint32_t>::max();
+
+		/**
+		 * Allocates everything searches over width x height grids need.
+		 */
+		GridSearch(std::size_t width, std::size_t height)
+			: width(checkedWidth(width, height))
+			, height(height)
+			, rowWords((width + 63) / 64)
+			, unvisited(rowWords * height)
+			, frontier(rowWords * height)
+			, next(rowWords * height)
+			, frontierWords(height)
+			, nextWords(height)
+			, cells(width * height)
+			, distanceGrid(width, height, Unreached)
+			, labelGrid(width, height, 0)
+			, sets(width * height + 1)
+			, cost(width * height)
+			, parent(width * height)
+			, openStamp(width * height, 0)
+			, closedStamp(width * height, 0)
+		{
+			// Deep enough for most fills, they grow it if not. Never more than there are cells, an empty grid
+			// may still be long in one dimension
+			const std::size_t depth = std::min(width + height, width * height);
+			spans.reserve(depth);
+			open.reserve(depth);
+			route.reserve(depth);
+		}
+
+		[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const noexcept
+		{
+			return { width, height };
+		}
+
+		////////////////////////
+		/// FLOOD FILL
+		////////////////////////
+
+		/**
+		 * Sets the 4-connected region of cells equal to the one at x, y to value, returns how many cells changed.
+		 * Works span by span ( scanline ): each row segment is found with one walk left and right, and only
+		 * the ends of segments above and below are pushed, not every cell. Any size of view.
+		 */
+		template <typename T>
+		std::size_t fill(const Vec2DView<T>& view, std::size_t x, std::size_t y, const T& value)
+		{
+			const std::size_t w = view.dim().first;
+			const std::size_t h = view.dim().second;
+			if (x >= w || y >= h)
+				throw std::out_of_range("Fill start out of range");
+
+			const T target = view.at(y, x);
+			if (target == value)
+				return 0;
+
+			const auto inside = [&](std::ptrdiff_t cx, std::ptrdiff_t cy)
+			{
+				return cx >= 0 && cy >= 0 && static_cast<std::size_t>(cx) < w && static_cast<std::size_t>(cy) < h
+					&& view.at(static_cast<std::size_t>(cy), static_cast<std::size_t>(cx)) == target;
+			};
+			const auto set = [&](std::ptrdiff_t cx, std::ptrdiff_t cy)
+			{
+				view.at(static_cast<std::size_t>(cy), static_cast<std::size_t>(cx)) = value;
+			};
+
+			// Spans x1..x2 of row y to look at, reached moving dy from the row they were found next to
+			std::size_t filled = 0;
+			spans.clear();
+			const auto sx = static_cast<std::ptrdiff_t>(x);
+			const auto sy = static_cast<std::ptrdiff_t>(y);
+			spans.push_back({ sx, sx, sy, 1 });
+			spans.push_back({ sx, sx, sy - 1, -1 });
+
+			while (!spans.empty())
+			{
+				auto [x1, x2, cy, dy] = spans.back();
+				spans.pop_back();
+
+				std::ptrdiff_t cx = x1;
+				if (inside(cx, cy))
+				{
+					while (inside(cx - 1, cy))
+					{
+						set(cx - 1, cy);
+						++filled;
+						--cx;
+					}
+					if (cx < x1)
+						spans.push_back({ cx, x1 - 1, cy - dy, -dy });
+				}
+
+				while (x1 <= x2)
+				{
+					while (inside(x1, cy))
+					{
+						set(x1, cy);
+						++filled;
+						++x1;
+					}
+					if (x1 > cx)
+						spans.push_back({ cx, x1 - 1, cy + dy, dy });
+					if (x1 - 1 > x2)
+						spans.push_back({ x2 + 1, x1 - 1, cy - dy, -dy });
+
+					++x1;
+					while (x1 < x2 && !inside(x1, cy))
+						++x1;
+					cx = x1;
+				}
+			}
+
+			return filled;
+		}
+
+		////////////////////////
+		/// BREADTH-FIRST SEARCH
+		////////////////////////
+
+		/**
+		 * Steps from x, y to every reachable cell ( 4-connected ), see distances(). Returns how many cells were reached.
+		 *
+		 * Passable cells are packed into a bitset first, 64 a word. Sequential searches then walk a FIFO of
+		 * cells, testing and clearing neighbours in the bitset. Parallel ones keep the frontier as a bitset
+		 * too and grow it a level at a time with shifts and ORs of its rows, spreading the rows of each
+		 * level over the threads; each row remembers which of its words hold frontier cells, so a level only
+		 * touches the words around the wavefront.
+		 */
+		template <typename Policy, typename T, typename Passable, parallel::EnableIfExecutionPolicy<Policy> = 0>
+		std::size_t distancesFrom(Policy&&, const Vec2DView<T>& view, std::size_t x, std::size_t y, Passable isPassable)
+		{
+			this->checkSize(view);
+			if (x >= width || y >= height)
+				throw std::out_of_range("Search start out of range");
+
+			constexpr bool split = parallel::IsParallelPolicy<Policy>;
+
+			// Passable cells unvisited, the frontier empty, every distance unreached
+			parallel::forBlocks(split, height, parallel::rowGrain(width), [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t row = begin; row < end; ++row)
+				{
+					std::uint64_t* bits = &unvisited[row * rowWords];
+					std::fill_n(bits, rowWords, 0);
+					for (std::size_t col = 0; col < width; ++col)
+					{
+						if (isPassable(view.at(row, col)))
+							bits[col / 64] |= std::uint64_t{ 1 } << (col % 64);
+					}
+
+					if constexpr (split)
+					{
+						std::fill_n(&frontier[row * rowWords], rowWords, 0);
+						std::fill_n(&next[row * rowWords], rowWords, 0);
+						frontierWords[row] = {};
+						nextWords[row] = {};
+					}
+					std::fill_n(&distanceGrid.at(row, 0), width, Unreached);
+				}
+			});
+
+			if (!this->test(unvisited, x, y))
+				return 0;
+
+			unvisited[y * rowWords + x / 64] &= ~(std::uint64_t{ 1 } << (x % 64));
+			distanceGrid.at(y, x) = 0;
+			return split ? this->growLevels(x, y) : this->walkQueue(x, y);
+		}
+
+		template <typename T, typename Passable>
+		std::size_t distancesFrom(const Vec2DView<T>& view, std::size_t x, std::size_t y, Passable isPassable)
+		{
+			return this->distancesFrom(std::execution::seq, view, x, y, isPassable);
+		}
+
+		/**
+		 * Steps from the start of the last distancesFrom() to every cell, Unreached where it could not go.
+		 */
+		[[nodiscard]] const Vec2D<std::uint32_t>& distances() const noexcept
+		{
+			return distanceGrid;
+		}
+
+		////////////////////////
+		/// SHORTEST PATHS
+		////////////////////////
+
+		/**
+		 * Cost of a cheapest path from start to goal ( see StraightCost ), with A*, if there is one; path() has its cells.
+		 * The open list is a binary heap in a buffer kept between searches, entries made stale by a
+		 * cheaper path are skipped when popped rather than searched for.
+		 */
+		template <typename T, typename Passable>
+		std::optional<PathCost> aStar(const Vec2DView<T>& view, Point start, Point goal, Passable isPassable, Connectivity connectivity = Connectivity::Eight)
+		{
+			this->beginPath(view, start, goal);
+
+			const auto walkable = [&](std::ptrdiff_t cx, std::ptrdiff_t cy) { return this->walkable(view, isPassable, cx, cy); };
+			if (!walkable(static_cast<std::ptrdiff_t>(start.first), static_cast<std::ptrdiff_t>(start.second)) || !walkable(static_cast<std::ptrdiff_t>(goal.first), static_cast<std::ptrdiff_t>(goal.second)))
+				return std::nullopt;
+
+			const std::uint32_t goalNode = this->node(goal.first, goal.second);
+			this->push(this->node(start.first, start.second), 0, this->node(start.first, start.second), goal);
+
+			while (const auto current = this->pop())
+			{
+				if (*current == goalNode)
+					return this->finishPath(goalNode);
+
+				const auto cx = static_cast<std::ptrdiff_t>(*current % width);
+				const auto cy = static_cast<std::ptrdiff_t>(*current / width);
+				for (std::ptrdiff_t dy = -1; dy <= 1; ++dy)
+				{
+					for (std::ptrdiff_t dx = -1; dx <= 1; ++dx)
+					{
+						if ((dx == 0 && dy == 0) || !walkable(cx + dx, cy + dy))
+							continue;
+
+						const bool diagonal = dx != 0 && dy != 0;
+						if (diagonal && (connectivity == Connectivity::Four || !walkable(cx + dx, cy) || !walkable(cx, cy + dy)))
+							continue;
+
+						const auto neighbour = static_cast<std::uint32_t>(*current + dx + dy * static_cast<std::ptrdiff_t>(width));
+						this->push(neighbour, cost[*current] + (diagonal ? DiagonalCost : StraightCost), *current, goal, connectivity);
+					}
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		/**
+		 * Cost of a cheapest 8-connected path from start to goal, with Jump Point Search, if there is one;
+		 * path() has its cells. The same costs as aStar( ..., Connectivity::Eight ), on open grids with far
+		 * fewer nodes: straight and diagonal runs with nothing to decide are skipped ( jumped ) without
+		 * touching the open list, only cells where an obstacle forces a turn become nodes.
+		 */
+		template <typename T, typename Passable>
+		std::optional<PathCost> jumpPointSearch(const Vec2DView<T>& view, Point start, Point goal, Passable isPassable)
+		{
+			this->beginPath(view, start, goal);
+
+			const auto walkable = [&](std::ptrdiff_t cx, std::ptrdiff_t cy) { return this->walkable(view, isPassable, cx, cy); };
+			if (!walkable(static_cast<std::ptrdiff_t>(start.first), static_cast<std::ptrdiff_t>(start.second)) || !walkable(static_cast<std::ptrdiff_t>(goal.first), static_cast<std::ptrdiff_t>(goal.second)))
+				return std::nullopt;
+
+			const auto gx = static_cast<std::ptrdiff_t>(goal.first);
+			const auto gy = static_cast<std::ptrdiff_t>(goal.second);
+
+			// Runs straight from cx, cy until a forced neighbour, the goal, or a wall
+			const auto jumpStraight = [&](std::ptrdiff_t cx, std::ptrdiff_t cy, std::ptrdiff_t dx, std::ptrdiff_t dy) -> std::optional<std::pair<std::ptrdiff_t, std::ptrdiff_t>>
+			{
+				for (;; cx += dx, cy += dy)
+				{
+					if (!walkable(cx, cy))
+						return std::nullopt;
+					if (cx == gx && cy == gy)
+						return std::make_pair(cx, cy);
+
+					if (dx != 0)
+					{
+						if ((walkable(cx, cy - 1) && !walkable(cx - dx, cy - 1)) || (walkable(cx, cy + 1) && !walkable(cx - dx, cy + 1)))
+							return std::make_pair(cx, cy);
+					}
+					else
+					{
+						if ((walkable(cx - 1, cy) && !walkable(cx - 1, cy - dy)) || (walkable(cx + 1, cy) && !walkable(cx + 1, cy - dy)))
+							return std::make_pair(cx, cy);
+					}
+				}
+			};
+
+			// Runs diagonally, stopping where a straight run off the diagonal finds something
+			const auto jump = [&](std::ptrdiff_t cx, std::ptrdiff_t cy, std::ptrdiff_t dx, std::ptrdiff_t dy) -> std::optional<std::pair<std::ptrdiff_t, std::ptrdiff_t>>
+			{
+				if (dx == 0 || dy == 0)
+					return jumpStraight(cx, cy, dx, dy);
+
+				for (;; cx += dx, cy += dy)
+				{
+					if (!walkable(cx, cy))
+						return std::nullopt;
+					if ((cx == gx && cy == gy) || jumpStraight(cx + dx, cy, dx, 0) || jumpStraight(cx, cy + dy, 0, dy))
+						return std::make_pair(cx, cy);
+					if (!walkable(cx + dx, cy) || !walkable(cx, cy + dy))
+						return std::nullopt;
+				}
+			};
+
+			const std::uint32_t startNode = this->node(start.first, start.second);
+			const std::uint32_t goalNode = this->node(goal.first, goal.second);
+			this->push(startNode, 0, startNode, goal);
+
+			std::pair<std::ptrdiff_t, std::ptrdiff_t> directions[8];
+			while (const auto current = this->pop())
+			{
+				if (*current == goalNode)
+					return this->finishPath(goalNode);
+
+				const auto cx = static_cast<std::ptrdiff_t>(*current % width);
+				const auto cy = static_cast<std::ptrdiff_t>(*current / width);
+
+				// Directions worth searching from here, given the direction it was reached in
+				std::size_t count = 0;
+				const auto add = [&](std::ptrdiff_t dx, std::ptrdiff_t dy) { directions[count++] = { dx, dy }; };
+				if (*current == startNode)
+				{
+					for (std::ptrdiff_t dy = -1; dy <= 1; ++dy)
+						for (std::ptrdiff_t dx = -1; dx <= 1; ++dx)
+							if ((dx != 0 || dy != 0) && walkable(cx + dx, cy + dy) && (dx == 0 || dy == 0 || (walkable(cx + dx, cy) && walkable(cx, cy + dy))))
+								add(dx, dy);
+				}
+				else
+				{
+					const auto px = static_cast<std::ptrdiff_t>(parent[*current] % width);
+					const auto py = static_cast<std::ptrdiff_t>(parent[*current] / width);
+					const std::ptrdiff_t dx = (cx > px) - (cx < px);
+					const std::ptrdiff_t dy = (cy > py) - (cy < py);
+
+					if (dx != 0 && dy != 0)
+					{
+						if (walkable(cx, cy + dy))
+							add(0, dy);
+						if (walkable(cx + dx, cy))
+							add(dx, 0);
+						if (walkable(cx, cy + dy) && walkable(cx + dx, cy))
+							add(dx, dy);
+					}
+					else if (dx != 0)
+					{
+						const bool ahead = walkable(cx + dx, cy);
+						const bool below = walkable(cx, cy + 1);
+						const bool above = walkable(cx, cy - 1);
+						if (ahead)
+						{
+							add(dx, 0);
+							if (below)
+								add(dx, 1);
+							if (above)
+								add(dx, -1);
+						}
+						if (below)
+							add(0, 1);
+						if (above)
+							add(0, -1);
+					}
+					else
+					{
+						const bool ahead = walkable(cx, cy + dy);
+						const bool right = walkable(cx + 1, cy);
+						const bool left = walkable(cx - 1, cy);
+						if (ahead)
+						{
+							add(0, dy);
+							if (right)
+								add(1, dy);
+							if (left)
+								add(-1, dy);
+						}
+						if (right)
+							add(1, 0);
+						if (left)
+							add(-1, 0);
+					}
+				}
+
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					const auto [dx, dy] = directions[i];
+					const auto point = jump(cx + dx, cy + dy, dx, dy);
+					if (!point)
+						continue;
+
+					// Jump points are reached in a straight or diagonal line
+					const auto along = static_cast<PathCost>(std::abs(point->first - cx));
+					const auto across = static_cast<PathCost>(std::abs(point->second - cy));
+					const PathCost step = std::min(along, across) * DiagonalCost + (std::max(along, across) - std::min(along, across)) * StraightCost;
+					this->push(this->node(static_cast<std::size_t>(point->first), static_cast<std::size_t>(point->second)), cost[*current] + step, *current, goal);
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		/**
+		 * Cells of the last path found, start to goal, every step one cell apart. Empty if none was found.
+		 */
+		[[nodiscard]] const std::vector<Point>& path() const noexcept
+		{
+			return route;
+		}
+
+		////////////////////////
+		/// CONNECTED COMPONENTS
+		////////////////////////
+
+		/**
+		 * Labels the connected regions of cells where inside( element ) holds, 1, 2, ... in row-major order
+		 * of their first cell, every other cell 0 ( see labels() ). Returns the number of regions.
+		 *
+		 * Two passes: the first gives each cell the label of a labelled neighbour above or to the left,
+		 * or a new one, and records labels meeting in a union-find forest; the second replaces every label by
+		 * its root's, renumbered densely.
+		 */
+		template <typename T, typename Inside>
+		std::size_t label(const Vec2DView<T>& view, Inside inside, Connectivity connectivity = Connectivity::Four)
+		{
+			this->checkSize(view);
+
+			std::uint32_t labels = 0;
+			const auto find = [&](std::uint32_t l)
+			{
+				// Path halving
+				while (sets[l] != l)
+				{
+					sets[l] = sets[sets[l]];
+					l = sets[l];
+				}
+				return l;
+			};
+			const auto unite = [&](std::uint32_t a, std::uint32_t b)
+			{
+				a = find(a);
+				b = find(b);
+				// The smaller root wins, so roots stay in order of first appearance
+				if (a < b)
+					sets[b] = a;
+				else if (b < a)
+					sets[a] = b;
+				return std::min(a, b);
+			};
+
+			for (std::size_t row = 0; row < height; ++row)
+			{
+				std::uint32_t* out = &labelGrid.at(row, 0);
+				const std::uint32_t* above = row == 0 ? nullptr : &labelGrid.at(row - 1, 0);
+
+				for (std::size_t col = 0; col < width; ++col)
+				{
+					if (!inside(view.at(row, col)))
+					{
+						out[col] = 0;
+						continue;
+					}
+
+					std::uint32_t l = 0;
+					const auto join = [&](std::uint32_t neighbour)
+					{
+						if (neighbour != 0)
+							l = l == 0 ? find(neighbour) : unite(l, neighbour);
+					};
+
+					if (col > 0)
+						join(out[col - 1]);
+					if (above != nullptr)
+					{
+						join(above[col]);
+						if (connectivity == Connectivity::Eight)
+						{
+							if (col > 0)
+								join(above[col - 1]);
+							if (col + 1 < width)
+								join(above[col + 1]);
+						}
+					}
+
+					if (l == 0)
+					{
+						l = ++labels;
+						sets[l] = l;
+					}
+					out[col] = l;
+				}
+			}
+
+			// Every label's parent is a smaller label, so in one pass in order each root takes the next
+			// number and every other label the number its parent already took
+			std::uint32_t regions = 0;
+			sets[0] = 0;
+			for (std::uint32_t l = 1; l <= labels; ++l)
+				sets[l] = sets[l] == l ? ++regions : sets[sets[l]];
+
+			for (auto& l : labelGrid)
+				l = sets[l];
+
+			return regions;
+		}
+
+		/**
+		 * Region of every cell from the last label(), 0 outside every region.
+		 */
+		[[nodiscard]] const Vec2D<std::uint32_t>& labels() const noexcept
+		{
+			return labelGrid;
+		}
+
+	private:
+		struct Span
+		{
+			std::ptrdiff_t x1;
+			std::ptrdiff_t x2;
+			std::ptrdiff_t y;
+			std::ptrdiff_t dy;
+		};
+
+		struct WordSpan
+		{
+			std::uint32_t first = std::numeric_limits<std::uint32_t>::max();	///< Empty spans are max, 0 so spans merge with min and max.
+			std::uint32_t last = 0;
+
+			bool empty() const noexcept { return first >= last; }
+		};
+
+		struct OpenEntry
+		{
+			PathCost total;		///< Estimated total cost.
+			PathCost cost;		///< Cost when pushed, stale once the node was reached cheaper.
+			std::uint32_t node;
+
+			/**
+			 * Least total first, ties broken towards the goal: the most spent, i.e. the least estimate left.
+			 */
+			bool operator>(const OpenEntry& other) const noexcept
+			{
+				return total != other.total ? total > other.total : cost < other.cost;
+			}
+		};
+
+		/**
+		 * width, once width x height was checked to fit the 32-bit node indices. Each side is bounded on
+		 * its own too, some buffers are sized by one side even when the other is 0. Called first thing in
+		 * the constructor, before any buffer is allocated.
+		 */
+		static std::size_t checkedWidth(std::size_t width, std::size_t height)
+		{
+			constexpr std::size_t MaxCells = std::numeric_limits<std::uint32_t>::max() - 1;
+			if (width > MaxCells || height > MaxCells || (height != 0 && width > MaxCells / height))
+				throw std::invalid_argument("Grids are limited to 2^32 - 1 cells");
+			return width;
+		}
+
+		template <typename T>
+		void checkSize(const Vec2DView<T>& view) const
+		{
+			if (view.dim() != this->dim())
+				throw std::invalid_argument("Grid size does not match the search");
+		}
+
+		bool test(const std::vector<std::uint64_t>& bits, std::size_t x, std::size_t y) const noexcept
+		{
+			return (bits[y * rowWords + x / 64] >> (x % 64)) & 1;
+		}
+
+		/**
+		 * Breadth-first from x, y ( already marked ) with a FIFO of cells, returns how many were reached.
+		 */
+		std::size_t walkQueue(std::size_t x, std::size_t y)
+		{
+			std::uint32_t* distance = distanceGrid.getData().data();
+			std::size_t head = 0;
+			std::size_t tail = 0;
+			cells[tail++] = this->node(x, y);
+
+			const auto visit = [&](std::size_t cx, std::size_t cy, std::uint32_t steps)
+			{
+				std::uint64_t& word = unvisited[cy * rowWords + cx / 64];
+				const std::uint64_t bit = std::uint64_t{ 1 } << (cx % 64);
+				if ((word & bit) == 0)
+					return;
+
+				word &= ~bit;
+				distance[cx + cy * width] = steps;
+				cells[tail++] = this->node(cx, cy);
+			};
+
+			while (head < tail)
+			{
+				const std::uint32_t cell = cells[head++];
+				const std::size_t cx = cell % width;
+				const std::size_t cy = cell / width;
+				const std::uint32_t steps = distance[cell] + 1;
+
+				if (cx > 0)
+					visit(cx - 1, cy, steps);
+				if (cx + 1 < width)
+					visit(cx + 1, cy, steps);
+				if (cy > 0)
+					visit(cx, cy - 1, steps);
+				if (cy + 1 < height)
+					visit(cx, cy + 1, steps);
+			}
+
+			return tail;
+		}
+
+		/**
+		 * Breadth-first from x, y ( already marked ) a level at a time, the rows of a level in parallel.
+		 */
+		std::size_t growLevels(std::size_t x, std::size_t y)
+		{
+			const std::size_t grain = parallel::rowGrain(width);
+			frontier[y * rowWords + x / 64] |= std::uint64_t{ 1 } << (x % 64);
+			frontierWords[y] = { static_cast<std::uint32_t>(x / 64), static_cast<std::uint32_t>(x / 64 + 1) };
+
+			// Rows holding the frontier
+			std::size_t first = y;
+			std::size_t last = y;
+			std::size_t reached = 1;
+
+			for (std::uint32_t level = 1;; ++level)
+			{
+				const std::size_t begin = first == 0 ? 0 : first - 1;
+				const std::size_t end = std::min(height, last + 2);
+
+				std::atomic<std::size_t> grown{ 0 };
+				parallel::forBlocks(true, end - begin, grain, [&](std::size_t blockBegin, std::size_t blockEnd)
+				{
+					std::size_t count = 0;
+					for (std::size_t row = begin + blockBegin; row < begin + blockEnd; ++row)
+						count += this->growRow(row, level);
+					grown.fetch_add(count, std::memory_order_relaxed);
+				});
+
+				if (grown.load(std::memory_order_relaxed) == 0)
+					break;
+				reached += grown.load(std::memory_order_relaxed);
+
+				// The old frontier becomes the next empty bitset
+				for (std::size_t row = first; row <= last; ++row)
+				{
+					const WordSpan words = frontierWords[row];
+					if (!words.empty())
+						std::fill(&frontier[row * rowWords + words.first], &frontier[row * rowWords + words.last], 0);
+					frontierWords[row] = {};
+				}
+				std::swap(frontier, next);
+				std::swap(frontierWords, nextWords);
+
+				first = begin;
+				while (frontierWords[first].empty())
+					++first;
+				last = end - 1;
+				while (frontierWords[last].empty())
+					--last;
+			}
+
+			return reached;
+		}
+
+		/**
+		 * Grows the frontier into row of next, marks the new cells visited at distance level, returns how many.
+		 */
+		std::size_t growRow(std::size_t row, std::uint32_t level)
+		{
+			const std::uint64_t* current = &frontier[row * rowWords];
+			const std::uint64_t* up = row == 0 ? nullptr : current - rowWords;
+			const std::uint64_t* down = row + 1 == height ? nullptr : current + rowWords;
+			std::uint64_t* grown = &next[row * rowWords];
+			std::uint64_t* open = &unvisited[row * rowWords];
+			std::uint32_t* distance = &distanceGrid.at(row, 0);
+
+			// Words next to a frontier cell of this row or the ones above and below
+			const WordSpan own = frontierWords[row];
+			const WordSpan above = up == nullptr ? WordSpan{} : frontierWords[row - 1];
+			const WordSpan below = down == nullptr ? WordSpan{} : frontierWords[row + 1];
+			std::uint32_t lo = std::min({ own.first, above.first, below.first });
+			std::uint32_t hi = std::max({ own.last, above.last, below.last });
+			if (lo >= hi)
+			{
+				nextWords[row] = {};
+				return 0;
+			}
+
+			// And the words cells at the ends of this row's span spill into
+			if (own.first == lo && lo > 0 && (current[lo] & 1) != 0)
+				--lo;
+			if (own.last == hi && hi < rowWords && (current[hi - 1] >> 63) != 0)
+				++hi;
+
+			std::size_t count = 0;
+			WordSpan touched{ static_cast<std::uint32_t>(rowWords), 0 };
+			for (std::size_t i = lo; i < hi; ++i)
+			{
+				const std::uint64_t word = current[i];
+				std::uint64_t spread = word | (word << 1) | (word >> 1);
+				if (i > 0)
+					spread |= current[i - 1] >> 63;
+				if (i + 1 < rowWords)
+					spread |= current[i + 1] << 63;
+				if (up != nullptr)
+					spread |= up[i];
+				if (down != nullptr)
+					spread |= down[i];
+
+				std::uint64_t fresh = spread & open[i];
+				if (fresh == 0)
+					continue;
+
+				grown[i] = fresh;
+				open[i] &= ~fresh;
+				touched.first = std::min(touched.first, static_cast<std::uint32_t>(i));
+				touched.last = static_cast<std::uint32_t>(i + 1);
+
+				for (; fresh != 0; fresh &= fresh - 1)
+				{
+					distance[i * 64 + static_cast<std::size_t>(__builtin_ctzll(fresh))] = level;
+					++count;
+				}
+			}
+
+			nextWords[row] = count != 0 ? touched : WordSpan{};
+			return count;
+		}
+
+		std::uint32_t node(std::size_t x, std::size_t y) const noexcept
+		{
+			return static_cast<std::uint32_t>(x + y * width);
+		}
+
+		template <typename T, typename Passable>
+		bool walkable(const Vec2DView<T>& view, Passable& isPassable, std::ptrdiff_t x, std::ptrdiff_t y) const
+		{
+			return x >= 0 && y >= 0 && static_cast<std::size_t>(x) < width && static_cast<std::size_t>(y) < height
+				&& isPassable(view.at(static_cast<std::size_t>(y), static_cast<std::size_t>(x)));
+		}
+
+		template <typename T>
+		void beginPath(const Vec2DView<T>& view, Point start, Point goal)
+		{
+			this->checkSize(view);
+			if (start.first >= width || start.second >= height || goal.first >= width || goal.second >= height)
+				throw std::out_of_range("Path end out of range");
+
+			route.clear();
+			open.clear();
+
+			// A new query number invalidates every node's state at once
+			if (++query == 0)
+			{
+				std::fill(openStamp.begin(), openStamp.end(), 0);
+				std::fill(closedStamp.begin(), closedStamp.end(), 0);
+				query = 1;
+			}
+		}
+
+		/**
+		 * Octile distance to the goal, exact on an empty grid, never more than the real cost.
+		 */
+		PathCost estimate(std::uint32_t n, Point goal, Connectivity connectivity) const noexcept
+		{
+			const std::size_t x = n % width;
+			const std::size_t y = n / width;
+			const auto dx = static_cast<PathCost>(x > goal.first ? x - goal.first : goal.first - x);
+			const auto dy = static_cast<PathCost>(y > goal.second ? y - goal.second : goal.second - y);
+			if (connectivity == Connectivity::Four)
+				return (dx + dy) * StraightCost;
+			return std::min(dx, dy) * DiagonalCost + (std::max(dx, dy) - std::min(dx, dy)) * StraightCost;
+		}
+
+		/**
+		 * Opens n at cost g from parent from, unless it is closed or already open at no more.
+		 */
+		void push(std::uint32_t n, PathCost g, std::uint32_t from, Point goal, Connectivity connectivity = Connectivity::Eight)
+		{
+			if (closedStamp[n] == query || (openStamp[n] == query && cost[n] <= g))
+				return;
+
+			openStamp[n] = query;
+			cost[n] = g;
+			parent[n] = from;
+
+			open.push_back({ g + this->estimate(n, goal, connectivity), g, n });
+			std::push_heap(open.begin(), open.end(), std::greater<>());
+		}
+
+		/**
+		 * The open node of least estimated total cost, closed, skipping stale entries.
+		 */
+		std::optional<std::uint32_t> pop()
+		{
+			while (!open.empty())
+			{
+				std::pop_heap(open.begin(), open.end(), std::greater<>());
+				const OpenEntry entry = open.back();
+				open.pop_back();
+
+				if (closedStamp[entry.node] == query || entry.cost != cost[entry.node])
+					continue;
+
+				closedStamp[entry.node] = query;
+				return entry.node;
+			}
+
+			return std::nullopt;
+		}
+
+		/**
+		 * Walks the parents back from the goal into route, filling in the cells between jump points.
+		 */
+		PathCost finishPath(std::uint32_t goalNode)
+		{
+			for (std::uint32_t n = goalNode;; n = parent[n])
+			{
+				const auto x = static_cast<std::ptrdiff_t>(n % width);
+				const auto y = static_cast<std::ptrdiff_t>(n / width);
+				route.emplace_back(static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+				if (parent[n] == n)
+					break;
+
+				const auto px = static_cast<std::ptrdiff_t>(parent[n] % width);
+				const auto py = static_cast<std::ptrdiff_t>(parent[n] / width);
+				const std::ptrdiff_t dx = (px > x) - (px < x);
+				const std::ptrdiff_t dy = (py > y) - (py < y);
+				for (std::ptrdiff_t cx = x + dx, cy = y + dy; cx != px || cy != py; cx += dx, cy += dy)
+					route.emplace_back(static_cast<std::size_t>(cx), static_cast<std::size_t>(cy));
+			}
+
+			std::reverse(route.begin(), route.end());
+			return cost[goalNode];
+		}
+
+		std::size_t width;		///< Width of the grids searched.
+		std::size_t height;		///< Height of the grids searched.
+		std::size_t rowWords;	///< 64-bit words per bitset row.
+
+		std::vector<Span> spans;	///< Fill work list.
+
+		std::vector<std::uint64_t> unvisited;	///< BFS bitsets, rowWords per row.
+		std::vector<std::uint64_t> frontier;
+		std::vector<std::uint64_t> next;
+		std::vector<WordSpan> frontierWords;	///< Words [first, last) of a frontier row that hold cells.
+		std::vector<WordSpan> nextWords;
+		std::vector<std::uint32_t> cells;		///< FIFO of sequential BFS, every cell enters once.
+		Vec2D<std::uint32_t> distanceGrid;
+
+		Vec2D<std::uint32_t> labelGrid;
+		std::vector<std::uint32_t> sets;		///< Union-find parents of provisional labels.
+
+		std::vector<PathCost> cost;				///< Cheapest known path cost, valid where openStamp is query.
+		std::vector<std::uint32_t> parent;		///< Previous node on that path, the start is its own parent.
+		std::vector<std::uint32_t> openStamp;	///< Query that last opened a node.
+		std::vector<std::uint32_t> closedStamp;	///< Query that last closed a node.
+		std::vector<OpenEntry> open;			///< Binary min-heap, capacity kept between queries.
+		std::vector<Point> route;
+		std::uint32_t query = 0;
+	};
+}
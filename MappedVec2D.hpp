@@ -0,0 +1,340 @@
+#pragma once
+
+#include "Vec2D.hpp"
+#include "Vec2DFile.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vec2d
+{
+	/**
+	 * How a mapped grid will be read, passed on to madvise.
+	 */
+	enum class Access
+	{
+		Normal,			///< No hint, the kernel default read-ahead.
+		Sequential,		///< Row after row, read ahead aggressively and drop pages behind.
+		Random,			///< Scattered accesses, no read-ahead.
+		WillNeed,		///< Start reading the whole file in now.
+		DontNeed		///< Done for now, pages are first in line for reclaim. Written elements are kept.
+	};
+
+	/**
+	 * Whether writes to a mapped grid reach the file.
+	 */
+	enum class MapMode
+	{
+		Shared,			///< Writes go to the file ( and to every other mapping of it ).
+		Private			///< Writes are copy-on-write, the file is only read.
+	};
+
+	/**
+	 * An open file descriptor, closed on destruction.
+	 */
+	class FileHandle
+	{
+	public:
+		FileHandle(const std::string& path, int flags, mode_t mode = 0644)
+			: fd(::open(path.c_str(), flags | O_CLOEXEC, mode))
+		{
+			if (fd == -1)
+				throw std::system_error(errno, std::generic_category(), "open " + path);
+		}
+
+		FileHandle(const FileHandle&) = delete;
+		FileHandle& operator=(const FileHandle&) = delete;
+
+		~FileHandle()
+		{
+			::close(fd);
+		}
+
+		[[nodiscard]] int get() const noexcept { return fd; }
+
+		[[nodiscard]] std::size_t size() const
+		{
+			struct stat status;
+			if (::fstat(fd, &status) != 0)
+				throw std::system_error(errno, std::generic_category(), "fstat");
+			return static_cast<std::size_t>(status.st_size);
+		}
+
+	private:
+		int fd;
+	};
+}
+
+////////////////////////
+/// MAPPED STORAGE
+////////////////////////
+
+/**
+ * Vec2D storage living in a memory mapping instead of on the heap.
+ *
+ * Mapped from a file, nothing is read up front: pages are faulted in on first access and the
+ * kernel's page cache decides what stays resident, so grids larger than RAM work and opening
+ * one costs the same whatever its size. Constructed from a count ( as Vec2D does for copies and
+ * results ), the mapping is anonymous memory instead, zeroed lazily by the kernel.
+ */
+template <typename T>
+class MappedStorage
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Mapped elements are raw bytes, T must be trivially copyable");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	MappedStorage() noexcept = default;
+
+	/**
+	 * count elements of anonymous memory, zero until written.
+	 */
+	explicit MappedStorage(std::size_t count)
+	{
+		if (count == 0)
+			return;
+
+		this->map(count * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1);
+		elements = reinterpret_cast<T*>(base);
+		elementCount = count;
+	}
+
+	/**
+	 * count elements of anonymous memory, all equal to value.
+	 */
+	MappedStorage(std::size_t count, const T& value)
+		: MappedStorage(count)
+	{
+		std::fill(this->begin(), this->end(), value);
+	}
+
+	/**
+	 * Maps file, which is fileBytes long, with count elements starting offset bytes in.
+	 * The mapping outlives the handle.
+	 */
+	MappedStorage(const vec2d::FileHandle& file, std::size_t fileBytes, std::size_t offset, std::size_t count, vec2d::MapMode mode)
+	{
+		if (offset > fileBytes || count > (fileBytes - offset) / sizeof(T))
+			throw std::invalid_argument("Elements past the end of the file");
+		if (fileBytes == 0)
+			return;
+
+		this->map(fileBytes, PROT_READ | PROT_WRITE, mode == vec2d::MapMode::Shared ? MAP_SHARED : MAP_PRIVATE, file.get());
+		elements = reinterpret_cast<T*>(base + offset);
+		elementCount = count;
+	}
+
+	/**
+	 * Copies into anonymous memory, a copy of a file-backed grid is not backed by the file.
+	 */
+	MappedStorage(const MappedStorage& other)
+		: MappedStorage(other.size())
+	{
+		std::copy(other.begin(), other.end(), this->begin());
+	}
+
+	MappedStorage(MappedStorage&& other) noexcept
+		: base{ std::exchange(other.base, nullptr) }
+		, bytes{ std::exchange(other.bytes, 0) }
+		, elements{ std::exchange(other.elements, nullptr) }
+		, elementCount{ std::exchange(other.elementCount, 0) }
+	{
+	}
+
+	MappedStorage& operator=(MappedStorage other) noexcept
+	{
+		std::swap(base, other.base);
+		std::swap(bytes, other.bytes);
+		std::swap(elements, other.elements);
+		std::swap(elementCount, other.elementCount);
+		return *this;
+	}
+
+	~MappedStorage()
+	{
+		this->clear();
+	}
+
+	T* data() noexcept { return elements; }
+	const T* data() const noexcept { return elements; }
+	[[nodiscard]] std::size_t size() const noexcept { return elementCount; }
+	[[nodiscard]] bool empty() const noexcept { return elementCount == 0; }
+
+	iterator begin() noexcept { return elements; }
+	const_iterator begin() const noexcept { return elements; }
+	iterator end() noexcept { return elements + elementCount; }
+	const_iterator end() const noexcept { return elements + elementCount; }
+
+	T& operator[](std::size_t index) noexcept { return elements[index]; }
+	const T& operator[](std::size_t index) const noexcept { return elements[index]; }
+
+	/**
+	 * Unmaps everything. Writes to a shared file mapping are kept by the file.
+	 */
+	void clear() noexcept
+	{
+		if (base != nullptr)
+			munmap(base, bytes);
+
+		base = nullptr;
+		bytes = 0;
+		elements = nullptr;
+		elementCount = 0;
+	}
+
+	/**
+	 * Mappings are sized when made, there is nothing to reserve.
+	 */
+	void reserve(std::size_t) noexcept
+	{
+	}
+
+	/**
+	 * Tells the kernel how the elements will be accessed next, so it can tune read-ahead and eviction.
+	 */
+	void advise(vec2d::Access access) const
+	{
+		if (base == nullptr)
+			return;
+
+		int advice = MADV_NORMAL;
+		switch (access)
+		{
+		case vec2d::Access::Normal: advice = MADV_NORMAL; break;
+		case vec2d::Access::Sequential: advice = MADV_SEQUENTIAL; break;
+		case vec2d::Access::Random: advice = MADV_RANDOM; break;
+		case vec2d::Access::WillNeed: advice = MADV_WILLNEED; break;
+		case vec2d::Access::DontNeed:
+			// Not MADV_DONTNEED, which throws away what was written to private and anonymous mappings
+#if defined(MADV_COLD)
+			advice = MADV_COLD;
+			break;
+#else
+			return;
+#endif
+		}
+
+		if (madvise(base, bytes, advice) != 0)
+		{
+			// Only a hint: kernels before 5.4 do not know MADV_COLD
+			if (errno == EINVAL && access == vec2d::Access::DontNeed)
+				return;
+			throw std::system_error(errno, std::generic_category(), "madvise");
+		}
+	}
+
+	/**
+	 * Writes dirty pages of a shared file mapping back to the file and waits for them.
+	 */
+	void flush() const
+	{
+		if (base != nullptr && msync(base, bytes, MS_SYNC) != 0)
+			throw std::system_error(errno, std::generic_category(), "msync");
+	}
+
+private:
+	void map(std::size_t length, int protection, int flags, int fd)
+	{
+		void* mapping = mmap(nullptr, length, protection, flags, fd, 0);
+		if (mapping == MAP_FAILED)
+			throw std::system_error(errno, std::generic_category(), "mmap");
+
+		base = static_cast<std::byte*>(mapping);
+		bytes = length;
+	}
+
+	std::byte* base = nullptr;		///< Start of the mapping ( page aligned ).
+	std::size_t bytes = 0;			///< Length of the mapping.
+	T* elements = nullptr;			///< The first element, past any file header.
+	std::size_t elementCount = 0;	///< Number of elements.
+};
+
+////////////////////////
+/// MAPPED VECTOR2D
+////////////////////////
+
+/**
+ * A Vec2D over mapped storage, with the whole Vec2D interface. Mappings cannot grow in place, so
+ * resize() moves the elements into anonymous memory, leaving the file as it was.
+ * Tuning hints and write-back go through getData().advise() and getData().flush().
+ */
+template <typename T, typename Layout = RowMajor>
+using MappedVec2D = Vec2D<T, Layout, MappedStorage<T>>;
+
+namespace vec2d
+{
+	/**
+	 * Maps a grid file ( see Vec2DFile.hpp ) without reading it, throws std::runtime_error if it holds
+	 * another element type or layout or is compressed, std::system_error if it cannot be mapped.
+	 * Mapping shared drops the file's checksum, the elements may change behind it.
+	 */
+	template <typename T, typename Layout = RowMajor>
+	MappedVec2D<T, Layout> openMapped(const std::string& path, MapMode mode = MapMode::Shared, Access access = Access::Normal)
+	{
+		const FileHandle file(path, mode == MapMode::Shared ? O_RDWR : O_RDONLY);
+		const std::size_t fileBytes = file.size();
+
+		FileHeader header;
+		if (fileBytes < sizeof(header) || ::pread(file.get(), &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+			throw std::runtime_error("Not a grid file");
+		checkHeader<T, Layout>(header);
+
+		if ((header.flags & FileHeader::Compressed) != 0)
+			throw std::runtime_error("Compressed grid files cannot be mapped");
+		if (header.dataOffset > fileBytes || payloadBytes<T, Layout>(header) > fileBytes - header.dataOffset)
+			throw std::runtime_error("Grid file is truncated");
+
+		// Writes through a shared mapping would make the checksum stale
+		if (mode == MapMode::Shared && (header.flags & FileHeader::Checksummed) != 0)
+		{
+			header.flags &= ~FileHeader::Checksummed;
+			if (::pwrite(file.get(), &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+				throw std::system_error(errno, std::generic_category(), "pwrite");
+		}
+
+		const auto width = static_cast<std::size_t>(header.width);
+		const auto height = static_cast<std::size_t>(header.height);
+		MappedStorage<T> storage(file, fileBytes, static_cast<std::size_t>(header.dataOffset), Layout::size(width, height), mode);
+		storage.advise(access);
+		return MappedVec2D<T, Layout>(adopt, width, height, std::move(storage));
+	}
+
+	/**
+	 * Creates ( or truncates ) a grid file of width x height elements and maps it shared.
+	 * The file is sized with a hole, so this takes the same time whatever the size, elements start as zero bytes.
+	 */
+	template <typename T, typename Layout = RowMajor>
+	MappedVec2D<T, Layout> createMapped(const std::string& path, std::size_t width, std::size_t height, Access access = Access::Normal)
+	{
+		{
+			const FileHandle file(path, O_RDWR | O_CREAT | O_TRUNC);
+			const FileHeader header = makeHeader<T, Layout>(width, height);
+			const auto fileBytes = static_cast<off_t>(header.dataOffset + Layout::size(width, height) * sizeof(T));
+
+			if (::ftruncate(file.get(), fileBytes) != 0)
+				throw std::system_error(errno, std::generic_category(), "ftruncate");
+			if (::pwrite(file.get(), &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+				throw std::system_error(errno, std::generic_category(), "pwrite");
+		}
+
+		return openMapped<T, Layout>(path, MapMode::Shared, access);
+	}
+}
+
+#endif
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CircularBuffer.hpp"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <numeric>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+////////////////////////
+/// MIRRORED STORAGE
+////////////////////////
+
+/**
+ * Storage whose pages are mapped twice, back to back, so element i and element i + size()
+ * share the same memory. Any run of up to size() elements is contiguous, wherever it starts.
+ *
+ * The capacity is rounded up so that it spans whole pages.
+ */
+template <typename T>
+class MirroredStorage
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Mirrored storage is shared memory, T must be trivially copyable");
+
+public:
+	static constexpr size_t Extent = 0;
+
+	explicit MirroredStorage(size_t count)
+	{
+		if (count == 0)
+			throw std::invalid_argument("Size must be positive");
+
+		const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		const size_t granularity = std::lcm(page, sizeof(T));
+		bytes = (count * sizeof(T) + granularity - 1) / granularity * granularity;
+
+		const int fd = memfd_create("CircularBuffer", MFD_CLOEXEC);
+		if (fd == -1)
+			throw std::system_error(errno, std::generic_category(), "memfd_create");
+
+		// Reserve the address range for both halves first so nothing else can land in between
+		void* reserved = MAP_FAILED;
+		if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+			reserved = mmap(nullptr, bytes * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (reserved == MAP_FAILED)
+			fail(fd, nullptr, "mmap");
+
+		auto* base = static_cast<std::byte*>(reserved);
+		if (mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+			|| mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+			fail(fd, base, "mmap");
+
+		// The mappings keep the memory alive
+		close(fd);
+		elements = reinterpret_cast<T*>(base);
+	}
+
+	MirroredStorage(const MirroredStorage&) = delete;
+	MirroredStorage& operator=(const MirroredStorage&) = delete;
+
+	MirroredStorage(MirroredStorage&& other) noexcept
+		: elements{ std::exchange(other.elements, nullptr) }
+		, bytes{ std::exchange(other.bytes, 0) }
+	{
+	}
+
+	MirroredStorage& operator=(MirroredStorage&& other) noexcept
+	{
+		std::swap(elements, other.elements);
+		std::swap(bytes, other.bytes);
+		return *this;
+	}
+
+	~MirroredStorage()
+	{
+		if (elements != nullptr)
+			munmap(elements, bytes * 2);
+	}
+
+	T* data() noexcept { return elements; }
+	const T* data() const noexcept { return elements; }
+	[[nodiscard]] size_t size() const noexcept { return bytes / sizeof(T); }
+
+	T& operator[](size_t index) noexcept { return elements[index]; }
+	const T& operator[](size_t index) const noexcept { return elements[index]; }
+
+private:
+	[[noreturn]] void fail(int fd, std::byte* base, const char* what)
+	{
+		const int error = errno;
+		if (base != nullptr)
+			munmap(base, bytes * 2);
+		close(fd);
+		throw std::system_error(error, std::generic_category(), what);
+	}
+
+	T* elements = nullptr;
+	size_t bytes = 0;
+};
+
+////////////////////////
+/// MIRRORED CIRCULAR BUFFER
+////////////////////////
+
+/**
+ * A "magic" ring buffer: the CircularBuffer semantics ( add() overwrites the oldest element )
+ * over MirroredStorage, so the readable region is always one contiguous run and never
+ * needs split handling.
+ *
+ * The capacity is fixed at construction, resize() is not available.
+ */
+template <typename T>
+class MirroredCircularBuffer : public BasicCircularBuffer<T, MirroredStorage<T>>
+{
+	using Base = BasicCircularBuffer<T, MirroredStorage<T>>;
+
+public:
+	/**
+	 * @param capacity The minimum capacity, rounded up to whole pages ( see maxSize() )
+	 */
+	explicit MirroredCircularBuffer(size_t capacity)
+		: Base(std::in_place, capacity)
+	{
+	}
+
+	/**
+	 * @brief Every element, oldest first, as a single contiguous run
+	 *
+	 * @return BufferSpan<T> The run
+	 */
+	BufferSpan<T> readable() noexcept
+	{
+		return { this->spans().first.data(), this->size() };
+	}
+
+	/**
+	 * @brief Every element, oldest first, as a single contiguous run
+	 *
+	 * @return BufferSpan<const T> The run
+	 */
+	BufferSpan<const T> readable() const noexcept
+	{
+		return { this->spans().first.data(), this->size() };
+	}
+
+	void resize(size_t) = delete;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <execution>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////
+/// PARALLEL
+////////////////////////
+
+namespace parallel
+{
+	/**
+	 * A fork-join pool of worker threads, created on first use and shared by every parallel algorithm.
+	 *
+	 * run() splits a job into tasks which the workers and the calling thread claim one at a time,
+	 * and returns once all of them finished. Only one job runs at a time; a job started from inside
+	 * a task runs on the calling thread instead ( no nested parallelism, no deadlock ).
+	 *
+	 * If a task throws, the remaining tasks of the job are claimed but skipped, and run() rethrows
+	 * the first exception on the calling thread once every thread let go of the job.
+	 */
+	class ThreadPool
+	{
+	public:
+		static ThreadPool& instance()
+		{
+			static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+			return pool;
+		}
+
+		explicit ThreadPool(unsigned threads)
+		{
+			// The calling thread works too
+			for (unsigned i = 1; i < threads; ++i)
+				workers.emplace_back([this] { work(); });
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+
+			for (auto& worker : workers)
+				worker.join();
+		}
+
+		/**
+		 * Number of threads a job is spread over, the caller included.
+		 */
+		[[nodiscard]] std::size_t size() const noexcept { return workers.size() + 1; }
+
+		/**
+		 * Calls task( i ) for every i in [0, tasks), spread over the pool.
+		 */
+		void run(std::size_t tasks, const std::function<void(std::size_t)>& task)
+		{
+			if (tasks == 0)
+				return;
+
+			if (tasks == 1 || workers.empty() || insideTask)
+			{
+				for (std::size_t i = 0; i < tasks; ++i)
+					task(i);
+				return;
+			}
+
+			std::lock_guard serial(jobMutex);
+			{
+				std::lock_guard lock(mutex);
+				job = &task;
+				jobTasks = tasks;
+				next = 0;
+				finished = 0;
+				error = nullptr;
+				failed = false;
+				++generation;
+			}
+			wake.notify_all();
+
+			const std::size_t completed = claim(task, tasks);
+
+			// Wait for the other tasks, and for every worker to let go of this job before it goes out of scope
+			std::exception_ptr thrown;
+			{
+				std::unique_lock lock(mutex);
+				finished += completed;
+				done.wait(lock, [&] { return finished == tasks && active == 0; });
+				job = nullptr;
+				thrown = std::exchange(error, nullptr);
+			}
+
+			if (thrown)
+				std::rethrow_exception(thrown);
+		}
+
+	private:
+		void work()
+		{
+			std::size_t seen = 0;
+			for (;;)
+			{
+				const std::function<void(std::size_t)>* task;
+				std::size_t tasks;
+				{
+					std::unique_lock lock(mutex);
+					wake.wait(lock, [&] { return stopping || (job != nullptr && generation != seen); });
+					if (stopping)
+						return;
+
+					seen = generation;
+					task = job;
+					tasks = jobTasks;
+					++active;
+				}
+
+				const std::size_t completed = claim(*task, tasks);
+
+				{
+					std::lock_guard lock(mutex);
+					finished += completed;
+					--active;
+				}
+				done.notify_one();
+			}
+		}
+
+		std::size_t claim(const std::function<void(std::size_t)>& task, std::size_t tasks)
+		{
+			insideTask = true;
+
+			std::size_t completed = 0;
+			for (std::size_t i = next.fetch_add(1); i < tasks; i = next.fetch_add(1))
+			{
+				// Every claimed task counts as finished, run or skipped, so run() never waits forever
+				++completed;
+				if (failed.load(std::memory_order_relaxed))
+					continue;
+
+				try
+				{
+					task(i);
+				}
+				catch (...)
+				{
+					std::lock_guard lock(mutex);
+					if (!error)
+						error = std::current_exception();
+					failed.store(true, std::memory_order_relaxed);
+				}
+			}
+
+			insideTask = false;
+			return completed;
+		}
+
+		static inline thread_local bool insideTask = false;
+
+		std::vector<std::thread> workers;
+		std::mutex jobMutex;	///< Serializes jobs.
+		std::mutex mutex;		///< Guards the job description below.
+		std::condition_variable wake;
+		std::condition_variable done;
+
+		const std::function<void(std::size_t)>* job = nullptr;
+		std::size_t jobTasks = 0;
+		std::size_t finished = 0;
+		std::size_t active = 0;	///< Workers currently holding the job.
+		std::size_t generation = 0;
+		std::atomic<std::size_t> next{ 0 };
+		std::exception_ptr error;	///< First exception thrown by a task of the current job.
+		std::atomic<bool> failed{ false };
+		bool stopping = false;
+	};
+
+	/**
+	 * Whether Policy asks for parallel execution ( anything but std::execution::seq ).
+	 */
+	template <typename Policy>
+	inline constexpr bool IsParallelPolicy = std::is_execution_policy_v<std::decay_t<Policy>>
+		&& !std::is_same_v<std::decay_t<Policy>, std::execution::sequenced_policy>;
+
+	template <typename Policy>
+	using EnableIfExecutionPolicy = std::enable_if_t<std::is_execution_policy_v<std::decay_t<Policy>>, int>;
+
+	/**
+	 * Splits [0, count) into contiguous blocks of at least grain items and calls f( begin, end ) for each.
+	 * Blocks run on the pool when Parallel is set, otherwise in order on the calling thread.
+	 * The split only depends on count and grain, never on the number of threads.
+	 */
+	template <typename F>
+	void forBlocks(bool parallel, std::size_t count, std::size_t grain, F&& f)
+	{
+		if (count == 0)
+			return;
+
+		grain = std::max<std::size_t>(grain, 1);
+		const std::size_t blocks = (count + grain - 1) / grain;
+
+		const auto block = [&](std::size_t i)
+		{
+			const std::size_t begin = i * grain;
+			f(begin, std::min(count, begin + grain));
+		};
+
+		if (!parallel || blocks == 1)
+		{
+			for (std::size_t i = 0; i < blocks; ++i)
+				block(i);
+			return;
+		}
+
+		ThreadPool::instance().run(blocks, block);
+	}
+
+	/**
+	 * Rows per block so that a block holds roughly 64K elements ( amortizes scheduling, keeps blocks in L2 ).
+	 */
+	inline std::size_t rowGrain(std::size_t width) noexcept
+	{
+		constexpr std::size_t elementsPerBlock = std::size_t{ 1 } << 16;
+		return std::max<std::size_t>(1, elementsPerBlock / std::max<std::size_t>(width, 1));
+	}
+}
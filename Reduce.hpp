@@ -0,0 +1,565 @@
+#pragma once
+
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "Vec2D.hpp"
+#include "Vec2DView.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////
+/// REDUCTIONS
+////////////////////////
+
+/**
+ * Whole-view, per-row and per-column reductions over views of row-major grids ( a whole grid is
+ * grid.view(), a region grid.subview( x, y, w, h ) ), and summed-area tables for O(1) region sums.
+ *
+ * Contiguous rows are folded with the SIMD reduction kernels, strided views element by element.
+ * Parallel policies spread blocks of rows over the thread pool. Blocks only depend on the view's
+ * dimensions and partial results are combined in row order, so every policy gives the same result,
+ * floating point sums included.
+ */
+namespace vec2d
+{
+	/**
+	 * What sums of T accumulate in: 64-bit integers for integers, double for float.
+	 */
+	template <typename T>
+	using SumType = std::conditional_t<std::is_floating_point_v<T>,
+		std::conditional_t<(sizeof(T) < sizeof(double)), double, T>,
+		std::conditional_t<std::is_integral_v<T>,
+			std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>,
+			T>>;
+
+	/**
+	 * Folds the elements of row y into init.
+	 */
+	template <simd::Reduction r, typename S, typename Acc>
+	Acc reduceRow(const Vec2DView<S>& view, std::size_t y, Acc init)
+	{
+		const std::size_t width = view.dim().first;
+		if (view.step() == 1)
+			return simd::reduce<r>(&view.at(y, 0), width, init);
+
+		for (std::size_t x = 0; x < width; ++x)
+			init = simd::combineScalar<r>(init, view.at(y, x));
+		return init;
+	}
+
+	/**
+	 * Columns per band when walking rows over a band of column accumulators: 16 KiB of them, so
+	 * they stay in L1 while each row contributes a long contiguous run.
+	 */
+	template <typename Acc>
+	constexpr std::size_t columnBand() noexcept
+	{
+		return std::max<std::size_t>(64, (std::size_t{ 16 } << 10) / sizeof(Acc));
+	}
+
+	/**
+	 * Calls block( rowBegin, rowEnd ) for blocks of rows, in parallel unless Policy is sequenced,
+	 * and folds their results with combine, in row order.
+	 */
+	template <typename Policy, typename Acc, typename Block, typename Combine>
+	Acc reduceRowBlocks(std::size_t width, std::size_t height, Acc init, Block block, Combine combine)
+	{
+		const std::size_t grain = parallel::rowGrain(width);
+		if (height <= grain)
+			return height == 0 ? init : combine(init, block(std::size_t{ 0 }, height));
+
+		std::vector<std::optional<Acc>> partials((height + grain - 1) / grain);
+		parallel::forBlocks(parallel::IsParallelPolicy<Policy>, height, grain, [&](std::size_t begin, std::size_t end)
+		{
+			partials[begin / grain] = block(begin, end);
+		});
+
+		for (const auto& partial : partials)
+			init = combine(init, *partial);
+		return init;
+	}
+
+	/**
+	 * Sum of the elements of a view, accumulated in SumType.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] SumType<std::remove_const_t<S>> sum(Policy&&, const Vec2DView<S>& view)
+	{
+		using Acc = SumType<std::remove_const_t<S>>;
+
+		const auto [width, height] = view.dim();
+		return reduceRowBlocks<Policy>(width, height, Acc{}, [&](std::size_t begin, std::size_t end)
+		{
+			Acc acc{};
+			for (std::size_t y = begin; y < end; ++y)
+				acc = reduceRow<simd::Reduction::Sum>(view, y, acc);
+			return acc;
+		}, [](Acc a, Acc b) { return a + b; });
+	}
+
+	template <typename S>
+	[[nodiscard]] SumType<std::remove_const_t<S>> sum(const Vec2DView<S>& view)
+	{
+		return vec2d::sum(std::execution::seq, view);
+	}
+
+	/**
+	 * Mean of the elements of a view, NaN if it is empty.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] double mean(Policy&& policy, const Vec2DView<S>& view)
+	{
+		const auto [width, height] = view.dim();
+		return static_cast<double>(vec2d::sum(policy, view)) / static_cast<double>(width * height);
+	}
+
+	template <typename S>
+	[[nodiscard]] double mean(const Vec2DView<S>& view)
+	{
+		return vec2d::mean(std::execution::seq, view);
+	}
+
+	/**
+	 * Smallest ( r is Min ) or largest ( Max ) element of a non-empty view.
+	 */
+	template <simd::Reduction r, typename Policy, typename S>
+	std::remove_const_t<S> extremum(const Vec2DView<S>& view)
+	{
+		using T = std::remove_const_t<S>;
+
+		const auto [width, height] = view.dim();
+		const T first = view.at(0, 0);
+		return reduceRowBlocks<Policy>(width, height, first, [&](std::size_t begin, std::size_t end)
+		{
+			T acc = first;
+			for (std::size_t y = begin; y < end; ++y)
+				acc = reduceRow<r>(view, y, acc);
+			return acc;
+		}, [](T a, T b) { return simd::combineScalar<r>(a, b); });
+	}
+
+	/**
+	 * Smallest element of a view, if it is not empty.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::optional<std::remove_const_t<S>> min(Policy&&, const Vec2DView<S>& view)
+	{
+		if (view.empty())
+			return std::nullopt;
+		return extremum<simd::Reduction::Min, Policy>(view);
+	}
+
+	template <typename S>
+	[[nodiscard]] std::optional<std::remove_const_t<S>> min(const Vec2DView<S>& view)
+	{
+		return vec2d::min(std::execution::seq, view);
+	}
+
+	/**
+	 * Largest element of a view, if it is not empty.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::optional<std::remove_const_t<S>> max(Policy&&, const Vec2DView<S>& view)
+	{
+		if (view.empty())
+			return std::nullopt;
+		return extremum<simd::Reduction::Max, Policy>(view);
+	}
+
+	template <typename S>
+	[[nodiscard]] std::optional<std::remove_const_t<S>> max(const Vec2DView<S>& view)
+	{
+		return vec2d::max(std::execution::seq, view);
+	}
+
+	/**
+	 * Position ( x, y ) of the first extremum in row-major order: each block finds its extremum with
+	 * the vector kernels, then the first row holding it, rather than tracking an index per element.
+	 */
+	template <simd::Reduction r, typename Policy, typename S>
+	std::optional<std::pair<std::size_t, std::size_t>> argExtremum(const Vec2DView<S>& view)
+	{
+		using T = std::remove_const_t<S>;
+		using Candidate = std::pair<T, std::pair<std::size_t, std::size_t>>;
+
+		if (view.empty())
+			return std::nullopt;
+
+		const std::size_t width = view.dim().first;
+		const std::size_t height = view.dim().second;
+
+		const Candidate none{ view.at(0, 0), { 0, 0 } };
+		return reduceRowBlocks<Policy>(width, height, none, [&](std::size_t begin, std::size_t end)
+		{
+			T best = view.at(begin, 0);
+			for (std::size_t y = begin; y < end; ++y)
+				best = reduceRow<r>(view, y, best);
+
+			for (std::size_t y = begin;; ++y)
+			{
+				for (std::size_t x = 0; x < width; ++x)
+				{
+					if (!(view.at(y, x) < best) && !(best < view.at(y, x)))
+						return Candidate{ best, { x, y } };
+				}
+			}
+		}, [](const Candidate& a, const Candidate& b)
+		{
+			// Ties keep the earlier block
+			const bool better = r == simd::Reduction::Min ? b.first < a.first : a.first < b.first;
+			return better ? b : a;
+		}).second;
+	}
+
+	/**
+	 * Position ( x, y ) of the first smallest element of a view in row-major order, if it is not empty.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> argmin(Policy&&, const Vec2DView<S>& view)
+	{
+		return argExtremum<simd::Reduction::Min, Policy>(view);
+	}
+
+	template <typename S>
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> argmin(const Vec2DView<S>& view)
+	{
+		return vec2d::argmin(std::execution::seq, view);
+	}
+
+	/**
+	 * Position ( x, y ) of the first largest element of a view in row-major order, if it is not empty.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> argmax(Policy&&, const Vec2DView<S>& view)
+	{
+		return argExtremum<simd::Reduction::Max, Policy>(view);
+	}
+
+	template <typename S>
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> argmax(const Vec2DView<S>& view)
+	{
+		return vec2d::argmax(std::execution::seq, view);
+	}
+
+	/**
+	 * Number of elements of a view for which pred( element ) is true.
+	 */
+	template <typename Policy, typename S, typename Pred, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::size_t countIf(Policy&&, const Vec2DView<S>& view, Pred pred)
+	{
+		const std::size_t width = view.dim().first;
+		const std::size_t height = view.dim().second;
+		return reduceRowBlocks<Policy>(width, height, std::size_t{ 0 }, [&](std::size_t begin, std::size_t end)
+		{
+			std::size_t count = 0;
+			for (std::size_t y = begin; y < end; ++y)
+			{
+				if (view.step() == 1)
+				{
+					const S* row = &view.at(y, 0);
+					for (std::size_t x = 0; x < width; ++x)
+						count += pred(row[x]) ? 1 : 0;
+				}
+				else
+				{
+					for (std::size_t x = 0; x < width; ++x)
+						count += pred(view.at(y, x)) ? 1 : 0;
+				}
+			}
+			return count;
+		}, [](std::size_t a, std::size_t b) { return a + b; });
+	}
+
+	template <typename S, typename Pred>
+	[[nodiscard]] std::size_t countIf(const Vec2DView<S>& view, Pred pred)
+	{
+		return vec2d::countIf(std::execution::seq, view, pred);
+	}
+
+	/**
+	 * One result per row: init folded with every element of the row, op( acc, element ) -> acc, left to right.
+	 * Rows are spread over the threads, each row folds on one, so op needs no associativity.
+	 * e.g. per-row maxima: reduceRows( view, lowest, []( T a, T b ) { return std::max( a, b ); } ).
+	 */
+	template <typename Policy, typename S, typename Acc, typename Op, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::vector<Acc> reduceRows(Policy&&, const Vec2DView<S>& view, Acc init, Op op)
+	{
+		const std::size_t width = view.dim().first;
+		const std::size_t height = view.dim().second;
+		std::vector<Acc> results(height, init);
+		parallel::forBlocks(parallel::IsParallelPolicy<Policy>, height, parallel::rowGrain(width), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t y = begin; y < end; ++y)
+			{
+				Acc acc = init;
+				for (std::size_t x = 0; x < width; ++x)
+					acc = op(acc, view.at(y, x));
+				results[y] = acc;
+			}
+		});
+		return results;
+	}
+
+	template <typename S, typename Acc, typename Op>
+	[[nodiscard]] std::vector<Acc> reduceRows(const Vec2DView<S>& view, Acc init, Op op)
+	{
+		return vec2d::reduceRows(std::execution::seq, view, init, op);
+	}
+
+	/**
+	 * One result per column: init folded with every element of the column, op( acc, element ) -> acc, top to bottom.
+	 * The view is still read row by row, each row updating a band of column accumulators ( which
+	 * vectorizes for simple ops ), and bands of columns are spread over the threads.
+	 */
+	template <typename Policy, typename S, typename Acc, typename Op, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::vector<Acc> reduceColumns(Policy&&, const Vec2DView<S>& view, Acc init, Op op)
+	{
+		const std::size_t width = view.dim().first;
+		const std::size_t height = view.dim().second;
+		std::vector<Acc> results(width, init);
+
+		const std::size_t band = columnBand<Acc>();
+		parallel::forBlocks(parallel::IsParallelPolicy<Policy>, width, band, [&](std::size_t begin, std::size_t end)
+		{
+			Acc* acc = results.data();
+			for (std::size_t y = 0; y < height; ++y)
+			{
+				if (view.step() == 1)
+				{
+					const S* row = &view.at(y, 0);
+					for (std::size_t x = begin; x < end; ++x)
+						acc[x] = op(acc[x], row[x]);
+				}
+				else
+				{
+					for (std::size_t x = begin; x < end; ++x)
+						acc[x] = op(acc[x], view.at(y, x));
+				}
+			}
+		});
+		return results;
+	}
+
+	template <typename S, typename Acc, typename Op>
+	[[nodiscard]] std::vector<Acc> reduceColumns(const Vec2DView<S>& view, Acc init, Op op)
+	{
+		return vec2d::reduceColumns(std::execution::seq, view, init, op);
+	}
+
+	/**
+	 * Sum of every row of a view, accumulated in SumType.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::vector<SumType<std::remove_const_t<S>>> rowSums(Policy&&, const Vec2DView<S>& view)
+	{
+		using Acc = SumType<std::remove_const_t<S>>;
+
+		const auto [width, height] = view.dim();
+		std::vector<Acc> results(height);
+		parallel::forBlocks(parallel::IsParallelPolicy<Policy>, height, parallel::rowGrain(width), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t y = begin; y < end; ++y)
+				results[y] = reduceRow<simd::Reduction::Sum>(view, y, Acc{});
+		});
+		return results;
+	}
+
+	template <typename S>
+	[[nodiscard]] std::vector<SumType<std::remove_const_t<S>>> rowSums(const Vec2DView<S>& view)
+	{
+		return vec2d::rowSums(std::execution::seq, view);
+	}
+
+	/**
+	 * Sum of every column of a view, accumulated in SumType.
+	 */
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::vector<SumType<std::remove_const_t<S>>> columnSums(Policy&& policy, const Vec2DView<S>& view)
+	{
+		using Acc = SumType<std::remove_const_t<S>>;
+		return vec2d::reduceColumns(policy, view, Acc{}, [](Acc acc, const S& value) { return acc + static_cast<Acc>(value); });
+	}
+
+	template <typename S>
+	[[nodiscard]] std::vector<SumType<std::remove_const_t<S>>> columnSums(const Vec2DView<S>& view)
+	{
+		return vec2d::columnSums(std::execution::seq, view);
+	}
+
+	////////////////////////
+	/// SUMMED-AREA TABLES
+	////////////////////////
+
+	/**
+	 * An integral image: entry x, y holds the sum of every element above and left of x, y, so the sum
+	 * of any rectangle is four lookups. Built in a single pass writing every entry once, and for
+	 * parallel policies one band of rows per thread, fixed up by a second pass adding the totals of the
+	 * bands above ( floating point entries may then differ from a sequential build in the last bits ).
+	 *
+	 * Entries grow with the area, integer tables can overflow Acc long before the elements do, and
+	 * floating point ones lose precision in the far corner: a region sum is a difference of large values.
+	 */
+	template <typename Acc>
+	class SummedAreaTable
+	{
+	public:
+		SummedAreaTable() = default;
+
+		/**
+		 * Builds the table of a view, the passes spread over the threads of the policy.
+		 */
+		template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+		SummedAreaTable(Policy&& policy, const Vec2DView<S>& view)
+		{
+			this->rebuild(policy, view);
+		}
+
+		/**
+		 * Builds the table of a view.
+		 */
+		template <typename S>
+		explicit SummedAreaTable(const Vec2DView<S>& view)
+			: SummedAreaTable(std::execution::seq, view)
+		{
+		}
+
+		/**
+		 * Rebuilds the table for a view, in place when the dimensions are unchanged ( e.g. once per frame ).
+		 */
+		template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+		void rebuild(Policy&&, const Vec2DView<S>& view)
+		{
+			if (view.dim() != this->dim())
+			{
+				width = view.dim().first;
+				height = view.dim().second;
+				table = Vec2D<Acc>(vec2d::uninitialized, width + 1, height + 1);
+			}
+
+			const std::size_t stride = width + 1;
+			Acc* entries = table.getData().data();
+			std::fill_n(entries, stride, Acc{});
+
+			// One band of rows per thread, each built as if it were the top of the table: a row is its
+			// running sum plus the row above, so every entry is written once while the row above is in cache
+			constexpr bool split = parallel::IsParallelPolicy<Policy>;
+			const std::size_t bands = split ? parallel::ThreadPool::instance().size() : 1;
+			const std::size_t grain = std::max<std::size_t>(1, (height + bands - 1) / bands);
+			parallel::forBlocks(split, height, grain, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t y = begin; y < end; ++y)
+				{
+					Acc* out = entries + (y + 1) * stride;
+					const Acc* above = out - stride;
+					const bool first = y == begin;
+
+					Acc acc{};
+					out[0] = acc;
+					for (std::size_t x = 0; x < width; ++x)
+					{
+						acc += static_cast<Acc>(view.at(y, x));
+						out[x + 1] = first ? acc : above[x + 1] + acc;
+					}
+				}
+			});
+
+			if (grain >= height)
+				return;
+
+			// Carry the totals of the bands above down: their last rows first, in order, then every other row
+			const auto lastRow = [&](std::size_t begin) { return entries + std::min(begin + grain, height) * stride; };
+			for (std::size_t begin = grain; begin < height; begin += grain)
+			{
+				const Acc* carry = lastRow(begin - grain);
+				Acc* out = lastRow(begin);
+				for (std::size_t x = 0; x < stride; ++x)
+					out[x] += carry[x];
+			}
+
+			parallel::forBlocks(split, height, grain, [&](std::size_t begin, std::size_t end)
+			{
+				if (begin == 0)
+					return;
+
+				const Acc* carry = entries + begin * stride;
+				for (std::size_t y = begin + 1; y < end; ++y)
+				{
+					Acc* out = entries + y * stride;
+					for (std::size_t x = 0; x < stride; ++x)
+						out[x] += carry[x];
+				}
+			});
+		}
+
+		/**
+		 * Rebuilds the table for a view.
+		 */
+		template <typename S>
+		void rebuild(const Vec2DView<S>& view)
+		{
+			this->rebuild(std::execution::seq, view);
+		}
+
+		/**
+		 * Sum of the w x h rectangle whose top left element is at x, y. O(1).
+		 */
+		[[nodiscard]] Acc sum(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const
+		{
+			if (x > width || w > width - x || y > height || h > height - y)
+				throw std::out_of_range("Rectangle out of range");
+
+			return table(x + w, y + h) - table(x, y + h) - table(x + w, y) + table(x, y);
+		}
+
+		/**
+		 * Mean of the w x h rectangle whose top left element is at x, y, NaN if it is empty. O(1).
+		 */
+		[[nodiscard]] double mean(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const
+		{
+			return static_cast<double>(this->sum(x, y, w, h)) / static_cast<double>(w * h);
+		}
+
+		/**
+		 * Sum of the whole source.
+		 */
+		[[nodiscard]] Acc total() const
+		{
+			return table(width, height);
+		}
+
+		/**
+		 * Dimensions of the source.
+		 */
+		[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const noexcept
+		{
+			return { width, height };
+		}
+
+		/**
+		 * The ( width + 1 ) x ( height + 1 ) entries, entry x, y summing the elements of [0, x) x [0, y).
+		 */
+		[[nodiscard]] const Vec2D<Acc>& entries() const noexcept
+		{
+			return table;
+		}
+
+	private:
+		std::size_t width = 0;	///< Width of the source.
+		std::size_t height = 0;	///< Height of the source.
+		Vec2D<Acc> table{ 1, 1, Acc{} };	///< A zero row and column, then the prefix sums.
+	};
+
+	template <typename Policy, typename S, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	SummedAreaTable(Policy&&, const Vec2DView<S>&) -> SummedAreaTable<SumType<std::remove_const_t<S>>>;
+
+	template <typename S>
+	SummedAreaTable(const Vec2DView<S>&) -> SummedAreaTable<SumType<std::remove_const_t<S>>>;
+}
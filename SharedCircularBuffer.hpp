@@ -0,0 +1,259 @@
+#pragma once
+
+#include "CircularBuffer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////
+/// SHARED CIRCULAR BUFFER
+////////////////////////
+
+/**
+ * A lock-free single-producer/single-consumer ring living in a named POSIX shared memory segment,
+ * so two processes can exchange elements without syscalls or copies through the kernel.
+ *
+ * One process create()s the buffer and another attach()es to it by name, either side may produce.
+ * Only indices are stored in the segment ( never pointers ), so each process can map it anywhere.
+ * The creator removes the name when it is destroyed, already attached processes keep working.
+ */
+template <typename T>
+class SharedCircularBuffer
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Elements are shared between processes, T must be trivially copyable");
+	static_assert(alignof(T) <= CacheLineSize, "Over aligned elements are not supported");
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Indices must be lock-free to be shared between processes");
+
+public:
+	/**
+	 * @brief Creates a new segment, fails if the name is already in use
+	 *
+	 * @param name The segment name, e.g. "/capture"
+	 * @param capacity Number of elements, a power of two so the free running indices wrap with a mask
+	 * @return SharedCircularBuffer The buffer, owning the name
+	 */
+	static SharedCircularBuffer create(const std::string& name, size_t capacity)
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("Size must be positive");
+		if ((capacity & (capacity - 1)) != 0)
+			throw std::invalid_argument("Size must be a power of two");
+
+		const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (fd == -1)
+			throw std::system_error(errno, std::generic_category(), "shm_open");
+
+		const size_t bytes = sizeof(Header) + capacity * sizeof(T);
+		if (ftruncate(fd, static_cast<off_t>(bytes)) == -1)
+		{
+			const int error = errno;
+			close(fd);
+			shm_unlink(name.c_str());
+			throw std::system_error(error, std::generic_category(), "ftruncate");
+		}
+
+		SharedCircularBuffer buffer(fd, bytes, name, true);
+		buffer.header->elementSize = sizeof(T);
+		buffer.header->capacity = capacity;
+
+		// Publishing the magic marks the segment as initialised for attach()
+		buffer.header->magic.store(Magic, std::memory_order_release);
+		return buffer;
+	}
+
+	/**
+	 * @brief Attaches to a segment made by create()
+	 *
+	 * @param name The segment name
+	 * @return SharedCircularBuffer The buffer
+	 */
+	static SharedCircularBuffer attach(const std::string& name)
+	{
+		const int fd = shm_open(name.c_str(), O_RDWR, 0);
+		if (fd == -1)
+			throw std::system_error(errno, std::generic_category(), "shm_open");
+
+		struct stat info {};
+		if (fstat(fd, &info) == -1)
+		{
+			const int error = errno;
+			close(fd);
+			throw std::system_error(error, std::generic_category(), "fstat");
+		}
+		if (static_cast<size_t>(info.st_size) < sizeof(Header))
+		{
+			close(fd);
+			throw std::runtime_error("Shared memory segment does not hold a matching buffer");
+		}
+
+		// The header is not trusted, another process may have written anything into it
+		SharedCircularBuffer buffer(fd, static_cast<size_t>(info.st_size), name, false);
+		if (buffer.header->magic.load(std::memory_order_acquire) != Magic || buffer.header->elementSize != sizeof(T))
+			throw std::runtime_error("Shared memory segment does not hold a matching buffer");
+
+		const std::uint64_t capacity = buffer.header->capacity;
+		if (capacity == 0 || (capacity & (capacity - 1)) != 0 || capacity > (buffer.bytes - sizeof(Header)) / sizeof(T))
+			throw std::runtime_error("Shared memory segment does not hold a matching buffer");
+
+		return buffer;
+	}
+
+	/**
+	 * @brief Removes a segment name, e.g. one left behind by a crashed creator
+	 */
+	static void remove(const std::string& name) noexcept
+	{
+		shm_unlink(name.c_str());
+	}
+
+	SharedCircularBuffer(const SharedCircularBuffer&) = delete;
+	SharedCircularBuffer& operator=(const SharedCircularBuffer&) = delete;
+
+	SharedCircularBuffer(SharedCircularBuffer&& other) noexcept
+		: header{ std::exchange(other.header, nullptr) }
+		, bytes{ std::exchange(other.bytes, 0) }
+		, name{ std::move(other.name) }
+		, owner{ std::exchange(other.owner, false) }
+		, cachedHead{ other.cachedHead }
+		, cachedTail{ other.cachedTail }
+	{
+	}
+
+	SharedCircularBuffer& operator=(SharedCircularBuffer&& other) noexcept
+	{
+		std::swap(header, other.header);
+		std::swap(bytes, other.bytes);
+		std::swap(name, other.name);
+		std::swap(owner, other.owner);
+		std::swap(cachedHead, other.cachedHead);
+		std::swap(cachedTail, other.cachedTail);
+		return *this;
+	}
+
+	~SharedCircularBuffer()
+	{
+		if (header != nullptr)
+			munmap(header, bytes);
+		if (owner)
+			shm_unlink(name.c_str());
+	}
+
+	/**
+	 * @brief Pushes an element if there is room ( producer only )
+	 *
+	 * @param elem The element being added
+	 * @return bool Whether the element was added
+	 */
+	bool try_push(const T& elem)
+	{
+		const std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+
+		if (tail - cachedHead == header->capacity)
+		{
+			cachedHead = header->head.load(std::memory_order_acquire);
+			if (tail - cachedHead == header->capacity)
+				return false;
+		}
+
+		slots()[tail & (header->capacity - 1)] = elem;
+		header->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Removes the oldest element if there is one ( consumer only )
+	 *
+	 * @return std::optional<T> The element, or empty if the buffer is empty
+	 */
+	std::optional<T> try_pop()
+	{
+		const std::uint64_t head = header->head.load(std::memory_order_relaxed);
+
+		if (head == cachedTail)
+		{
+			cachedTail = header->tail.load(std::memory_order_acquire);
+			if (head == cachedTail)
+				return std::nullopt;
+		}
+
+		std::optional<T> elem{ slots()[head & (header->capacity - 1)] };
+		header->head.store(head + 1, std::memory_order_release);
+		return elem;
+	}
+
+	/**
+	 * @brief Approximate number of elements, exact only when called by either end while the other is idle
+	 */
+	[[nodiscard]] size_t size() const noexcept
+	{
+		const std::uint64_t head = header->head.load(std::memory_order_acquire);
+		const std::uint64_t tail = header->tail.load(std::memory_order_acquire);
+		return static_cast<size_t>(tail - head);
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+	[[nodiscard]] size_t capacity() const noexcept { return static_cast<size_t>(header->capacity); }
+
+private:
+	static constexpr std::uint64_t Magic = 0x4255464645524344;	///< "BUFFERCD"
+
+	/**
+	 * The start of the segment. Fixed width fields only, the processes may differ in pointer size.
+	 */
+	struct Header
+	{
+		std::atomic<std::uint64_t> magic;
+		std::uint64_t elementSize;
+		std::uint64_t capacity;
+		alignas(CacheLineSize) std::atomic<std::uint64_t> tail;
+		alignas(CacheLineSize) std::atomic<std::uint64_t> head;
+		alignas(CacheLineSize) unsigned char elements[1];
+	};
+
+	SharedCircularBuffer(int fd, size_t bytes, std::string name, bool owner)
+		: bytes{ bytes }
+		, name{ std::move(name) }
+		, owner{ owner }
+	{
+		void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		const int error = errno;
+		close(fd);
+
+		if (mapped == MAP_FAILED)
+		{
+			if (owner)
+				shm_unlink(this->name.c_str());
+			throw std::system_error(error, std::generic_category(), "mmap");
+		}
+
+		// A fresh segment is zero filled, which is a valid empty state for the indices
+		header = static_cast<Header*>(mapped);
+	}
+
+	T* slots() noexcept
+	{
+		return reinterpret_cast<T*>(header->elements);
+	}
+
+	Header* header = nullptr;
+	size_t bytes = 0;
+	std::string name;
+	bool owner = false;
+
+	/**
+	 * Each process caches the other side's index, only touching the shared line when the cache looks full/empty.
+	 */
+	std::uint64_t cachedHead = 0;
+	std::uint64_t cachedTail = 0;
+};
+
+#endif
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define UTILS_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define UTILS_SIMD_X86 0
+#endif
+
+////////////////////////
+/// SIMD KERNELS
+////////////////////////
+
+/**
+ * Element-wise kernels over contiguous arrays, with explicit SSE / AVX2 / AVX-512 versions
+ * picked at runtime for the CPU at hand, and a scalar fallback everywhere else.
+ */
+namespace simd
+{
+	/**
+	 * The element-wise operations. dst, a and b are arrays, s0 and s1 are scalars.
+	 */
+	enum class Op
+	{
+		Add,			///< dst = a + b
+		Sub,			///< dst = a - b
+		Mul,			///< dst = a * b
+		Div,			///< dst = a / b
+		Min,			///< dst = min( a, b )
+		Max,			///< dst = max( a, b )
+		MulAdd,			///< dst = dst + a * b ( fused where the hardware allows )
+		AddScalar,		///< dst = a + s0
+		SubScalar,		///< dst = a - s0
+		MulScalar,		///< dst = a * s0
+		DivScalar,		///< dst = a / s0
+		MinScalar,		///< dst = min( a, s0 )
+		MaxScalar,		///< dst = max( a, s0 )
+		MulAddScalar,	///< dst = a * s0 + s1 ( fused where the hardware allows )
+		Clamp,			///< dst = min( max( a, s0 ), s1 )
+		AddScaled,		///< dst = dst + a * s0 ( fused where the hardware allows )
+	};
+
+	enum class Isa
+	{
+		Scalar,
+		Sse,	///< 128 bit ( SSE4.2 )
+		Avx2,	///< 256 bit ( AVX2 + FMA )
+		Avx512,	///< 512 bit ( AVX-512 F + BW )
+	};
+
+	/**
+	 * Whether T has explicit vector kernels.
+	 */
+	template <typename T>
+	inline constexpr bool IsVectorizable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double>;
+
+	/**
+	 * The widest instruction set the running CPU supports, detected once.
+	 */
+	inline Isa detectIsa() noexcept
+	{
+#if UTILS_SIMD_X86
+		static const Isa isa = []
+		{
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+				return Isa::Avx512;
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				return Isa::Avx2;
+			if (__builtin_cpu_supports("sse4.2"))
+				return Isa::Sse;
+			return Isa::Scalar;
+		}();
+		return isa;
+#else
+		return Isa::Scalar;
+#endif
+	}
+
+	/**
+	 * Applies op to element i, the reference for every vector kernel.
+	 */
+	template <Op op, typename T>
+	inline void applyScalar(T* dst, const T* a, const T* b, T s0, T s1, std::size_t i)
+	{
+		if constexpr (op == Op::Add) dst[i] = a[i] + b[i];
+		else if constexpr (op == Op::Sub) dst[i] = a[i] - b[i];
+		else if constexpr (op == Op::Mul) dst[i] = a[i] * b[i];
+		else if constexpr (op == Op::Div) dst[i] = a[i] / b[i];
+		else if constexpr (op == Op::Min) dst[i] = b[i] < a[i] ? b[i] : a[i];
+		else if constexpr (op == Op::Max) dst[i] = a[i] < b[i] ? b[i] : a[i];
+		else if constexpr (op == Op::MulAdd) dst[i] = dst[i] + a[i] * b[i];
+		else if constexpr (op == Op::AddScalar) dst[i] = a[i] + s0;
+		else if constexpr (op == Op::SubScalar) dst[i] = a[i] - s0;
+		else if constexpr (op == Op::MulScalar) dst[i] = a[i] * s0;
+		else if constexpr (op == Op::DivScalar) dst[i] = a[i] / s0;
+		else if constexpr (op == Op::MinScalar) dst[i] = s0 < a[i] ? s0 : a[i];
+		else if constexpr (op == Op::MaxScalar) dst[i] = a[i] < s0 ? s0 : a[i];
+		else if constexpr (op == Op::MulAddScalar) dst[i] = a[i] * s0 + s1;
+		else if constexpr (op == Op::Clamp) dst[i] = a[i] < s0 ? s0 : (s1 < a[i] ? s1 : a[i]);
+		else if constexpr (op == Op::AddScaled) dst[i] = dst[i] + a[i] * s0;
+	}
+
+	template <Op op, typename T>
+	void scalarKernel(T* dst, const T* a, const T* b, T s0, T s1, std::size_t n)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			applyScalar<op>(dst, a, b, s0, s1, i);
+	}
+
+#if UTILS_SIMD_X86
+	/**
+	 * The body shared by every vector width. Written with GCC/Clang vector extensions so that the
+	 * same code compiles to SSE, AVX2 or AVX-512 instructions depending on the enclosing target.
+	 */
+#define UTILS_SIMD_KERNEL_BODY(Bytes, FusedMulAdd)                                          \
+	typedef T V __attribute__((vector_size(Bytes), aligned(alignof(T)), may_alias));        \
+	constexpr std::size_t Lanes = (Bytes) / sizeof(T);                                      \
+	const V vs0 = V{} + s0;                                                                 \
+	const V vs1 = V{} + s1;                                                                 \
+	std::size_t i = 0;                                                                      \
+	for (; i + Lanes <= n; i += Lanes)                                                      \
+	{                                                                                       \
+		const V va = *reinterpret_cast<const V*>(a + i);                                    \
+		V vb{};                                                                             \
+		V vd{};                                                                             \
+		if constexpr (op <= Op::MulAdd)                                                     \
+			vb = *reinterpret_cast<const V*>(b + i);                                        \
+		if constexpr (op == Op::MulAdd || op == Op::AddScaled)                              \
+			vd = *reinterpret_cast<const V*>(dst + i);                                      \
+		V r;                                                                                \
+		if constexpr (op == Op::Add) r = va + vb;                                           \
+		else if constexpr (op == Op::Sub) r = va - vb;                                      \
+		else if constexpr (op == Op::Mul) r = va * vb;                                      \
+		else if constexpr (op == Op::Div) r = va / vb;                                      \
+		else if constexpr (op == Op::Min) r = vb < va ? vb : va;                            \
+		else if constexpr (op == Op::Max) r = va < vb ? vb : va;                            \
+		else if constexpr (op == Op::MulAdd) r = FusedMulAdd<T>(va, vb, vd);                \
+		else if constexpr (op == Op::AddScalar) r = va + vs0;                               \
+		else if constexpr (op == Op::SubScalar) r = va - vs0;                               \
+		else if constexpr (op == Op::MulScalar) r = va * vs0;                               \
+		else if constexpr (op == Op::DivScalar) r = va / vs0;                               \
+		else if constexpr (op == Op::MinScalar) r = vs0 < va ? vs0 : va;                    \
+		else if constexpr (op == Op::MaxScalar) r = va < vs0 ? vs0 : va;                    \
+		else if constexpr (op == Op::MulAddScalar) r = FusedMulAdd<T>(va, vs0, vs1);        \
+		else if constexpr (op == Op::Clamp) r = va < vs0 ? vs0 : (vs1 < va ? vs1 : va);     \
+		else if constexpr (op == Op::AddScaled) r = FusedMulAdd<T>(va, vs0, vd);            \
+		*reinterpret_cast<V*>(dst + i) = r;                                                 \
+	}                                                                                       \
+	for (; i < n; ++i)                                                                      \
+		applyScalar<op>(dst, a, b, s0, s1, i);
+
+	/**
+	 * a * b + c, with a single rounding for float/double where the instruction set has FMA.
+	 * ( Plain C++17 turns off floating point contraction, so this has to be spelled out. )
+	 */
+	template <typename T, typename V>
+	inline V mulAdd128(V a, V b, V c)
+	{
+		return a * b + c;
+	}
+
+	template <typename T, typename V>
+	__attribute__((target("avx2,fma"), always_inline)) inline V mulAdd256(V a, V b, V c)
+	{
+		if constexpr (std::is_same_v<T, float>)
+			return (V)_mm256_fmadd_ps((__m256)a, (__m256)b, (__m256)c);
+		else if constexpr (std::is_same_v<T, double>)
+			return (V)_mm256_fmadd_pd((__m256d)a, (__m256d)b, (__m256d)c);
+		else
+			return a * b + c;
+	}
+
+	template <typename T, typename V>
+	__attribute__((target("avx512f,avx512bw,fma"), always_inline)) inline V mulAdd512(V a, V b, V c)
+	{
+		if constexpr (std::is_same_v<T, float>)
+			return (V)_mm512_fmadd_ps((__m512)a, (__m512)b, (__m512)c);
+		else if constexpr (std::is_same_v<T, double>)
+			return (V)_mm512_fmadd_pd((__m512d)a, (__m512d)b, (__m512d)c);
+		else
+			return a * b + c;
+	}
+
+	template <Op op, typename T>
+	__attribute__((target("sse4.2"))) void sseKernel(T* dst, const T* a, const T* b, T s0, T s1, std::size_t n)
+	{
+		UTILS_SIMD_KERNEL_BODY(16, mulAdd128)
+	}
+
+	template <Op op, typename T>
+	__attribute__((target("avx2,fma"))) void avx2Kernel(T* dst, const T* a, const T* b, T s0, T s1, std::size_t n)
+	{
+		UTILS_SIMD_KERNEL_BODY(32, mulAdd256)
+	}
+
+	template <Op op, typename T>
+	__attribute__((target("avx512f,avx512bw,fma"))) void avx512Kernel(T* dst, const T* a, const T* b, T s0, T s1, std::size_t n)
+	{
+		UTILS_SIMD_KERNEL_BODY(64, mulAdd512)
+	}
+
+#undef UTILS_SIMD_KERNEL_BODY
+#endif
+
+	/**
+	 * Runs op over n elements using the given instruction set ( mostly useful for benchmarks and tests ).
+	 * dst may alias a or b. Unused arrays / scalars may be anything.
+	 */
+	template <Op op, typename T>
+	void run(Isa isa, T* dst, const T* a, const T* b, T s0, T s1, std::size_t n)
+	{
+#if UTILS_SIMD_X86
+		if constexpr (IsVectorizable<T>)
+		{
+			switch (isa)
+			{
+			case Isa::Avx512: return avx512Kernel<op>(dst, a, b, s0, s1, n);
+			case Isa::Avx2: return avx2Kernel<op>(dst, a, b, s0, s1, n);
+			case Isa::Sse: return sseKernel<op>(dst, a, b, s0, s1, n);
+			case Isa::Scalar: break;
+			}
+		}
+#else
+		(void)isa;
+#endif
+		scalarKernel<op>(dst, a, b, s0, s1, n);
+	}
+
+	/**
+	 * Runs op over n elements using the best instruction set available.
+	 */
+	template <Op op, typename T>
+	void run(T* dst, const T* a, const T* b, T s0, T s1, std::size_t n)
+	{
+		run<op>(detectIsa(), dst, a, b, s0, s1, n);
+	}
+
+	/**
+	 * Folds of n contiguous elements into a single value, dispatched like the element-wise kernels.
+	 */
+	enum class Reduction
+	{
+		Sum,	///< init + a[0] + ... + a[n - 1], accumulated in Acc
+		Min,	///< The smallest of init and the elements
+		Max,	///< The largest of init and the elements
+	};
+
+	template <Reduction r, typename T, typename Acc>
+	inline Acc combineScalar(Acc acc, const T& value)
+	{
+		if constexpr (r == Reduction::Sum) return acc + static_cast<Acc>(value);
+		else if constexpr (r == Reduction::Min) return static_cast<Acc>(value) < acc ? static_cast<Acc>(value) : acc;
+		else return acc < static_cast<Acc>(value) ? static_cast<Acc>(value) : acc;
+	}
+
+	template <Reduction r, typename T, typename Acc>
+	Acc scalarReduce(const T* a, std::size_t n, Acc init)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			init = combineScalar<r>(init, a[i]);
+		return init;
+	}
+
+#if UTILS_SIMD_X86
+	/**
+	 * One accumulator per lane, widened to Acc, folded across lanes at the end. Sums of floating
+	 * point elements are therefore added in a different order than the scalar loop, as any vector sum is.
+	 */
+#define UTILS_SIMD_REDUCE_BODY(Bytes)                                                        \
+	constexpr std::size_t Lanes = (Bytes) / sizeof(T);                                      \
+	typedef T V __attribute__((vector_size(Bytes), aligned(alignof(T)), may_alias));        \
+	typedef Acc VA __attribute__((vector_size(Lanes * sizeof(Acc))));                      \
+	std::size_t i = 0;                                                                      \
+	if (n >= Lanes)                                                                         \
+	{                                                                                       \
+		VA acc = VA{} + (r == Reduction::Sum ? Acc{} : init);                               \
+		for (; i + Lanes <= n; i += Lanes)                                                  \
+		{                                                                                   \
+			const VA va = __builtin_convertvector(*reinterpret_cast<const V*>(a + i), VA);  \
+			if constexpr (r == Reduction::Sum) acc += va;                                   \
+			else if constexpr (r == Reduction::Min) acc = va < acc ? va : acc;              \
+			else acc = acc < va ? va : acc;                                                 \
+		}                                                                                   \
+		for (std::size_t lane = 0; lane < Lanes; ++lane)                                    \
+			init = combineScalar<r>(init, acc[lane]);                                       \
+	}                                                                                       \
+	return scalarReduce<r>(a + i, n - i, init);
+
+	template <Reduction r, typename T, typename Acc>
+	__attribute__((target("sse4.2"))) Acc sseReduce(const T* a, std::size_t n, Acc init)
+	{
+		UTILS_SIMD_REDUCE_BODY(16)
+	}
+
+	template <Reduction r, typename T, typename Acc>
+	__attribute__((target("avx2,fma"))) Acc avx2Reduce(const T* a, std::size_t n, Acc init)
+	{
+		UTILS_SIMD_REDUCE_BODY(32)
+	}
+
+	template <Reduction r, typename T, typename Acc>
+	__attribute__((target("avx512f,avx512bw,fma"))) Acc avx512Reduce(const T* a, std::size_t n, Acc init)
+	{
+		UTILS_SIMD_REDUCE_BODY(64)
+	}
+
+#undef UTILS_SIMD_REDUCE_BODY
+#endif
+
+	/**
+	 * Folds n elements into init using the given instruction set. Min and Max need Acc to be T.
+	 */
+	template <Reduction r, typename T, typename Acc>
+	Acc reduce(Isa isa, const T* a, std::size_t n, Acc init)
+	{
+		static_assert(r == Reduction::Sum || std::is_same_v<T, Acc>, "Min and Max accumulate in the element type");
+
+#if UTILS_SIMD_X86
+		if constexpr (IsVectorizable<T> && IsVectorizable<Acc>)
+		{
+			switch (isa)
+			{
+			case Isa::Avx512: return avx512Reduce<r>(a, n, init);
+			case Isa::Avx2: return avx2Reduce<r>(a, n, init);
+			case Isa::Sse: return sseReduce<r>(a, n, init);
+			case Isa::Scalar: break;
+			}
+		}
+#else
+		(void)isa;
+#endif
+		return scalarReduce<r>(a, n, init);
+	}
+
+	/**
+	 * Folds n elements into init using the best instruction set available.
+	 */
+	template <Reduction r, typename T, typename Acc>
+	Acc reduce(const T* a, std::size_t n, Acc init)
+	{
+		return reduce<r>(detectIsa(), a, n, init);
+	}
+
+	/**
+	 * Transposes a rows x cols block: dst[c * dstStride + r] = src[r * srcStride + c].
+	 * Strides are in elements and may be negative ( to mirror while transposing ).
+	 * 4 and 8 byte elements move as 4x4 / 2x2 register tiles ( SSE2, always there on x86-64 ).
+	 * Meant for small, cache resident blocks, larger ones should be split first.
+	 */
+	template <typename T>
+	void transposeBlock(const T* src, std::ptrdiff_t srcStride, T* dst, std::ptrdiff_t dstStride, std::size_t rows, std::size_t cols)
+	{
+		const auto s = [&](std::size_t r, std::size_t c) { return src + static_cast<std::ptrdiff_t>(r) * srcStride + static_cast<std::ptrdiff_t>(c); };
+		const auto d = [&](std::size_t c, std::size_t r) { return dst + static_cast<std::ptrdiff_t>(c) * dstStride + static_cast<std::ptrdiff_t>(r); };
+
+		std::size_t tiledRows = 0;
+		std::size_t tiledCols = 0;
+
+#if UTILS_SIMD_X86 && defined(__SSE2__)
+		if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 4)
+		{
+			tiledRows = rows & ~std::size_t{ 3 };
+			tiledCols = cols & ~std::size_t{ 3 };
+			for (std::size_t r = 0; r < tiledRows; r += 4)
+			{
+				for (std::size_t c = 0; c < tiledCols; c += 4)
+				{
+					__m128 r0 = _mm_loadu_ps(reinterpret_cast<const float*>(s(r, c)));
+					__m128 r1 = _mm_loadu_ps(reinterpret_cast<const float*>(s(r + 1, c)));
+					__m128 r2 = _mm_loadu_ps(reinterpret_cast<const float*>(s(r + 2, c)));
+					__m128 r3 = _mm_loadu_ps(reinterpret_cast<const float*>(s(r + 3, c)));
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+					_mm_storeu_ps(reinterpret_cast<float*>(d(c, r)), r0);
+					_mm_storeu_ps(reinterpret_cast<float*>(d(c + 1, r)), r1);
+					_mm_storeu_ps(reinterpret_cast<float*>(d(c + 2, r)), r2);
+					_mm_storeu_ps(reinterpret_cast<float*>(d(c + 3, r)), r3);
+				}
+			}
+		}
+		else if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 8)
+		{
+			tiledRows = rows & ~std::size_t{ 1 };
+			tiledCols = cols & ~std::size_t{ 1 };
+			for (std::size_t r = 0; r < tiledRows; r += 2)
+			{
+				for (std::size_t c = 0; c < tiledCols; c += 2)
+				{
+					const __m128d r0 = _mm_loadu_pd(reinterpret_cast<const double*>(s(r, c)));
+					const __m128d r1 = _mm_loadu_pd(reinterpret_cast<const double*>(s(r + 1, c)));
+					_mm_storeu_pd(reinterpret_cast<double*>(d(c, r)), _mm_unpacklo_pd(r0, r1));
+					_mm_storeu_pd(reinterpret_cast<double*>(d(c + 1, r)), _mm_unpackhi_pd(r0, r1));
+				}
+			}
+		}
+#endif
+
+		// Whatever the register tiles did not cover: the right columns, then the bottom rows
+		for (std::size_t r = 0; r < tiledRows; ++r)
+			for (std::size_t c = tiledCols; c < cols; ++c)
+				*d(c, r) = *s(r, c);
+
+		for (std::size_t r = tiledRows; r < rows; ++r)
+			for (std::size_t c = 0; c < cols; ++c)
+				*d(c, r) = *s(r, c);
+	}
+}
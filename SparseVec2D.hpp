@@ -0,0 +1,397 @@
+#pragma once
+
+#include "Vec2DLayout.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+////////////////////////
+/// CHUNK POOL
+////////////////////////
+
+/**
+ * Hands out fixed-size arrays of ChunkSize elements, carved from slabs of SlabChunks chunks.
+ * Released chunks go on a free list and are reused before any new slab is allocated,
+ * memory only goes back to the system when the pool is destroyed.
+ */
+template <typename T, std::size_t ChunkSize, std::size_t SlabChunks = 64>
+class ChunkPool
+{
+public:
+	ChunkPool() = default;
+	ChunkPool(const ChunkPool&) = delete;
+	ChunkPool& operator=(const ChunkPool&) = delete;
+	ChunkPool(ChunkPool&&) noexcept = default;
+	ChunkPool& operator=(ChunkPool&&) noexcept = default;
+
+	[[nodiscard]] T* acquire()
+	{
+		if (freeChunks.empty())
+		{
+			// Default initialized, chunks are filled when handed out
+			slabs.emplace_back(new T[ChunkSize * SlabChunks]);
+			T* slab = slabs.back().get();
+			for (std::size_t i = SlabChunks; i-- > 0;)
+				freeChunks.push_back(slab + i * ChunkSize);
+		}
+
+		T* chunk = freeChunks.back();
+		freeChunks.pop_back();
+		return chunk;
+	}
+
+	void release(T* chunk)
+	{
+		freeChunks.push_back(chunk);
+	}
+
+	/**
+	 * Elements allocated, in use or not.
+	 */
+	[[nodiscard]] std::size_t capacity() const noexcept
+	{
+		return slabs.size() * SlabChunks * ChunkSize;
+	}
+
+private:
+	std::vector<std::unique_ptr<T[]>> slabs;
+	std::vector<T*> freeChunks;
+};
+
+////////////////////////
+/// SPARSE VECTOR2D
+////////////////////////
+
+/**
+ * A 2D grid for huge, mostly empty worlds: the grid is cut in ChunkWidth x ChunkHeight chunks,
+ * allocated from a pool on first write. Cells of chunks never written read as the default value.
+ *
+ * Chunks are found through a two-level table ( like page tables ): a dense top level of directory
+ * blocks, each covering 64 x 64 chunks and allocated with the first chunk in it. A lookup is
+ * two dependent loads, no hashing, and a 1M x 1M grid with 64 x 64 chunks costs 512 KiB up front.
+ *
+ * Non-const at() / operator() populate the chunk they touch, const access and set() of the
+ * default value never do. Writes are not thread safe.
+ */
+template <typename T, std::size_t ChunkWidth = 64, std::size_t ChunkHeight = 64>
+class SparseVec2D
+{
+	static_assert(ChunkWidth > 0 && (ChunkWidth & (ChunkWidth - 1)) == 0, "Chunk width must be a power of two");
+	static_assert(ChunkHeight > 0 && (ChunkHeight & (ChunkHeight - 1)) == 0, "Chunk height must be a power of two");
+
+	static constexpr std::size_t ChunkSize = ChunkWidth * ChunkHeight;
+	static constexpr std::size_t DirectorySide = 64;	///< Chunks per side of a directory block.
+
+	struct Chunk
+	{
+		std::size_t cx;		///< Column of the chunk.
+		std::size_t cy;		///< Row of the chunk.
+		T* data;
+	};
+
+public:
+	using value_type = T;
+
+	/**
+	 * Initializes a sparse 2D vector of given width and height, reading as the provided default value (if provided).
+	 * Nothing but the top level of the chunk table is allocated.
+	 */
+	SparseVec2D(const std::size_t width, const std::size_t height, std::optional<T> defaultValue = {})
+		: width(width)
+		, height(height)
+		, chunksAcross((width + ChunkWidth - 1) / ChunkWidth)
+		, chunksDown((height + ChunkHeight - 1) / ChunkHeight)
+		, blocksAcross((chunksAcross + DirectorySide - 1) / DirectorySide)
+		, fallback(defaultValue.value_or(T{}))
+		, directory(blocksAcross * ((chunksDown + DirectorySide - 1) / DirectorySide))
+	{
+	}
+
+	SparseVec2D(const SparseVec2D& other)
+		: SparseVec2D(other.width, other.height, other.fallback)
+	{
+		for (const auto& chunk : other.chunks)
+			std::copy_n(chunk.data, ChunkSize, this->populate(chunk.cx, chunk.cy));
+	}
+
+	SparseVec2D(SparseVec2D&&) noexcept = default;
+
+	SparseVec2D& operator=(SparseVec2D other) noexcept
+	{
+		this->swap(other);
+		return *this;
+	}
+
+	/**
+	 * Returns the element at row, column. Const qualified, unwritten cells are the default value.
+	 */
+	[[nodiscard]] const T& at(std::size_t row, std::size_t col) const
+	{
+		assert(row < this->height&& col < this->width); // In range check (Only for debug mode)
+		const T* chunk = this->lookup(col / ChunkWidth, row / ChunkHeight);
+		return chunk == nullptr ? fallback : chunk[offset(col, row)];
+	}
+
+	/**
+	 * Returns the element at row, column. Can be overwritten, populates its chunk.
+	 */
+	T& at(std::size_t row, std::size_t col)
+	{
+		assert(row < this->height&& col < this->width); // In range check (Only for debug mode)
+		T* chunk = this->lookup(col / ChunkWidth, row / ChunkHeight);
+		if (chunk == nullptr)
+			chunk = this->populate(col / ChunkWidth, row / ChunkHeight);
+		return chunk[offset(col, row)];
+	}
+
+	/**
+	 * Returns the element at x, y. Can be overwritten, populates its chunk.
+	 */
+	T& operator()(std::size_t x, std::size_t y)
+	{
+		return this->at(y, x);
+	}
+
+	/**
+	 * Returns the element at x, y. Const qualified.
+	 */
+	const T& operator()(std::size_t x, std::size_t y) const
+	{
+		return this->at(y, x);
+	}
+
+	/**
+	 * Writes value at x, y. Writing the default value to an unwritten cell allocates nothing.
+	 */
+	void set(std::size_t x, std::size_t y, const T& value)
+	{
+		assert(y < this->height&& x < this->width); // In range check (Only for debug mode)
+		T* chunk = this->lookup(x / ChunkWidth, y / ChunkHeight);
+		if (chunk == nullptr)
+		{
+			if (value == fallback)
+				return;
+			chunk = this->populate(x / ChunkWidth, y / ChunkHeight);
+		}
+		chunk[offset(x, y)] = value;
+	}
+
+	[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const
+	{
+		return { width, height };
+	}
+
+	/**
+	 * The value unwritten cells read as.
+	 */
+	[[nodiscard]] const T& defaultValue() const noexcept
+	{
+		return fallback;
+	}
+
+	/**
+	 * Number of populated chunks.
+	 */
+	[[nodiscard]] std::size_t chunkCount() const noexcept
+	{
+		return chunks.size();
+	}
+
+	/**
+	 * Returns whether no chunk is populated, i.e. every cell reads as the default value.
+	 */
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return chunks.empty();
+	}
+
+	/**
+	 * Returns every chunk to the pool, every cell reads as the default value again.
+	 */
+	void clear()
+	{
+		for (const auto& chunk : chunks)
+			pool.release(chunk.data);
+		chunks.clear();
+		std::fill(directory.begin(), directory.end(), nullptr);
+	}
+
+	/**
+	 * Calls f( tile ) for every populated chunk, a Vec2DTile<T> ( narrower / shorter at the grid edges ),
+	 * in the order the chunks were populated. Cells of unpopulated chunks are all the default value.
+	 */
+	template <typename F>
+	void forEachChunk(F&& f)
+	{
+		for (const auto& chunk : chunks)
+			f(this->tile(chunk.cx, chunk.cy, chunk.data));
+	}
+
+	/**
+	 * Calls f( tile ) for every populated chunk, a Vec2DTile<const T>. Const qualified.
+	 */
+	template <typename F>
+	void forEachChunk(F&& f) const
+	{
+		for (const auto& chunk : chunks)
+			f(this->tile(chunk.cx, chunk.cy, static_cast<const T*>(chunk.data)));
+	}
+
+	/**
+	 * Searches for a specific element, only through populated chunks unless it is the default value.
+	 * Returns the position ( x, y ) of the first match in row-major order, if any.
+	 */
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> find(const T& value) const
+	{
+		if (value == fallback)
+			return this->findDefault();
+
+		// Chunks by chunk row, the first match of a chunk row is the first match of the grid past the rows above
+		std::vector<const Chunk*> order;
+		order.reserve(chunks.size());
+		for (const auto& chunk : chunks)
+			order.push_back(&chunk);
+		std::sort(order.begin(), order.end(), [](const Chunk* a, const Chunk* b) { return std::tie(a->cy, a->cx) < std::tie(b->cy, b->cx); });
+
+		for (auto first = order.begin(); first != order.end();)
+		{
+			const auto last = std::find_if(first, order.end(), [&](const Chunk* c) { return c->cy != (*first)->cy; });
+
+			std::optional<std::pair<std::size_t, std::size_t>> best;
+			for (auto it = first; it != last; ++it)
+			{
+				const auto match = this->findInChunk((*it)->cx, (*it)->cy, (*it)->data, value);
+				if (match && (!best || std::tie(match->second, match->first) < std::tie(best->second, best->first)))
+					best = match;
+			}
+
+			if (best)
+				return best;
+			first = last;
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * Swaps the contents with another sparse 2D vector.
+	 */
+	void swap(SparseVec2D& other) noexcept
+	{
+		std::swap(width, other.width);
+		std::swap(height, other.height);
+		std::swap(chunksAcross, other.chunksAcross);
+		std::swap(chunksDown, other.chunksDown);
+		std::swap(blocksAcross, other.blocksAcross);
+		std::swap(fallback, other.fallback);
+		std::swap(directory, other.directory);
+		std::swap(chunks, other.chunks);
+		std::swap(pool, other.pool);
+	}
+
+private:
+	static std::size_t offset(std::size_t x, std::size_t y) noexcept
+	{
+		return (x % ChunkWidth) + (y % ChunkHeight) * ChunkWidth;
+	}
+
+	std::unique_ptr<T*[]>& block(std::size_t cx, std::size_t cy) noexcept
+	{
+		return directory[cx / DirectorySide + (cy / DirectorySide) * blocksAcross];
+	}
+
+	T* lookup(std::size_t cx, std::size_t cy) const noexcept
+	{
+		const auto& entries = directory[cx / DirectorySide + (cy / DirectorySide) * blocksAcross];
+		return entries ? entries[cx % DirectorySide + (cy % DirectorySide) * DirectorySide] : nullptr;
+	}
+
+	/**
+	 * Allocates chunk cx, cy filled with the default value.
+	 */
+	T* populate(std::size_t cx, std::size_t cy)
+	{
+		auto& entries = this->block(cx, cy);
+		if (!entries)
+			entries = std::make_unique<T*[]>(DirectorySide * DirectorySide);
+
+		T* data = pool.acquire();
+		std::fill_n(data, ChunkSize, fallback);
+		entries[cx % DirectorySide + (cy % DirectorySide) * DirectorySide] = data;
+		chunks.push_back({ cx, cy, data });
+		return data;
+	}
+
+	template <typename Element>
+	Vec2DTile<Element> tile(std::size_t cx, std::size_t cy, Element* data) const noexcept
+	{
+		const std::size_t x = cx * ChunkWidth;
+		const std::size_t y = cy * ChunkHeight;
+		return { x, y, std::min(ChunkWidth, width - x), std::min(ChunkHeight, height - y), ChunkWidth, data };
+	}
+
+	std::optional<std::pair<std::size_t, std::size_t>> findInChunk(std::size_t cx, std::size_t cy, const T* data, const T& value) const
+	{
+		const auto t = this->tile(cx, cy, data);
+		for (std::size_t row = 0; row < t.height; ++row)
+		{
+			for (std::size_t col = 0; col < t.width; ++col)
+			{
+				if (t.at(row, col) == value)
+					return std::make_pair(t.x + col, t.y + row);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * The first cell reading as the default value: in an unpopulated chunk, or a populated one holding it.
+	 */
+	std::optional<std::pair<std::size_t, std::size_t>> findDefault() const
+	{
+		for (std::size_t cy = 0; cy < chunksDown; ++cy)
+		{
+			// The first row of the chunk row holding the default, and the first column in it
+			std::optional<std::pair<std::size_t, std::size_t>> best;
+			for (std::size_t cx = 0; cx < chunksAcross; ++cx)
+			{
+				const T* data = this->lookup(cx, cy);
+				if (data == nullptr)
+				{
+					// Its top left cell, nothing further right in this chunk row can be higher up
+					const std::pair<std::size_t, std::size_t> cell{ cx * ChunkWidth, cy * ChunkHeight };
+					if (!best || best->second > cell.second)
+						best = cell;
+					break;
+				}
+
+				const auto match = this->findInChunk(cx, cy, data, fallback);
+				if (match && (!best || std::tie(match->second, match->first) < std::tie(best->second, best->first)))
+					best = match;
+			}
+
+			if (best)
+				return best;
+		}
+
+		return std::nullopt;
+	}
+
+	std::size_t width;			///< Width of the 2D vector.
+	std::size_t height;			///< Height of the 2D vector.
+	std::size_t chunksAcross;	///< Chunk columns.
+	std::size_t chunksDown;		///< Chunk rows.
+	std::size_t blocksAcross;	///< Directory block columns.
+	T fallback;					///< What unwritten cells read as.
+
+	std::vector<std::unique_ptr<T*[]>> directory;	///< Top level, DirectorySide x DirectorySide chunk pointers per block.
+	std::vector<Chunk> chunks;						///< Populated chunks, in population order.
+	ChunkPool<T, ChunkSize> pool;
+};
@@ -0,0 +1,488 @@
+#pragma once
+
+#include "Vec2DHash.hpp"
+#include "Vec2DView.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace vec2d
+{
+	/**
+	 * Alignment of a fixed grid of the given bytes: the next power of two up to a cache line, so small
+	 * grids never straddle two lines and packing millions of them wastes little, at least what T needs.
+	 */
+	constexpr std::size_t staticAlignment(std::size_t bytes, std::size_t natural) noexcept
+	{
+		std::size_t alignment = 1;
+		while (alignment < 64 && alignment < bytes)
+			alignment *= 2;
+		return alignment < natural ? natural : alignment;
+	}
+}
+
+////////////////////////
+/// STATIC VECTOR2D
+////////////////////////
+
+/**
+ * A W x H grid whose dimensions are part of its type, for small fixed grids such as 8x8 boards or 16x16 chunks.
+ * Elements live row-major in an aligned std::array inside the object: creating one allocates nothing, copies
+ * are plain copies of the array and every index is folded at compile time. Usable in constant expressions.
+ * Offers the access, iteration, arithmetic, transforms and find of Vec2D, and views for what is built on them.
+ */
+template <typename T, std::size_t W, std::size_t H>
+class StaticVec2D
+{
+public:
+	using value_type = T;
+	using container_type = std::array<T, W * H>;
+	using iterator = typename container_type::iterator;
+	using const_iterator = typename container_type::const_iterator;
+	using reverse_iterator = typename container_type::reverse_iterator;
+	using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+	static constexpr std::size_t Width = W;
+	static constexpr std::size_t Height = H;
+	static constexpr std::size_t Alignment = vec2d::staticAlignment(sizeof(T) * W * H, alignof(T));
+
+	constexpr iterator begin() noexcept { return data.begin(); }
+	[[nodiscard]] constexpr const_iterator begin() const noexcept { return data.begin(); }
+	constexpr iterator end() noexcept { return data.end(); }
+	[[nodiscard]] constexpr const_iterator end() const noexcept { return data.end(); }
+	constexpr reverse_iterator rbegin() noexcept { return data.rbegin(); }
+	[[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept { return data.rbegin(); }
+	constexpr reverse_iterator rend() noexcept { return data.rend(); }
+	[[nodiscard]] constexpr const_reverse_iterator rend() const noexcept { return data.rend(); }
+
+	/**
+	 * Every element value initialized.
+	 */
+	constexpr StaticVec2D() noexcept(std::is_nothrow_default_constructible_v<T>) = default;
+
+	/**
+	 * Every element set to value.
+	 */
+	explicit constexpr StaticVec2D(const T& value)
+	{
+		this->fill(value);
+	}
+
+	/**
+	 * Initializes from rows, e.g. { { 1, 2 }, { 3, 4 } }. Short or missing rows leave the rest value initialized.
+	 */
+	constexpr StaticVec2D(std::initializer_list<std::initializer_list<T>> rows)
+	{
+		if (rows.size() > H)
+			throw std::invalid_argument("More rows than the grid holds");
+
+		std::size_t row = 0;
+		for (const auto& values : rows)
+		{
+			if (values.size() > W)
+				throw std::invalid_argument("Row longer than the grid");
+
+			std::size_t col = 0;
+			for (const T& value : values)
+				data[row * W + col++] = value;
+			++row;
+		}
+	}
+
+	/**
+	 * Returns the element at row, column. Const qualified.
+	 */
+	[[nodiscard]] constexpr const T& at(std::size_t row, std::size_t col) const
+	{
+		assert(row < H && col < W); // In range check (Only for debug mode)
+		return data[col + row * W];
+	}
+
+	/**
+	 * Returns the element at row, column. Can be overwritten.
+	 */
+	constexpr T& at(std::size_t row, std::size_t col)
+	{
+		assert(row < H && col < W); // In range check (Only for debug mode)
+		return data[col + row * W];
+	}
+
+	/**
+	 * Returns the element at x, y. Can be overwritten.
+	 */
+	constexpr T& operator()(std::size_t x, std::size_t y)
+	{
+		return this->at(y, x);
+	}
+
+	/**
+	 * Returns the element at x, y. Const qualified.
+	 */
+	constexpr const T& operator()(std::size_t x, std::size_t y) const
+	{
+		return this->at(y, x);
+	}
+
+	/**
+	 * Returns a view of the whole grid, for reductions, stencils and searches written against views.
+	 */
+	[[nodiscard]] Vec2DView<T> view() noexcept
+	{
+		return { data.data(), W, H, W };
+	}
+
+	/**
+	 * Returns a view of the whole grid. Const qualified.
+	 */
+	[[nodiscard]] Vec2DView<const T> view() const noexcept
+	{
+		return { data.data(), W, H, W };
+	}
+
+	/**
+	 * Returns a view of the w x h sub-grid whose top left element is at x, y.
+	 */
+	[[nodiscard]] Vec2DView<T> subview(std::size_t x, std::size_t y, std::size_t w, std::size_t h)
+	{
+		return this->view().subview(x, y, w, h);
+	}
+
+	/**
+	 * Returns a view of the w x h sub-grid whose top left element is at x, y. Const qualified.
+	 */
+	[[nodiscard]] Vec2DView<const T> subview(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const
+	{
+		return this->view().subview(x, y, w, h);
+	}
+
+	/**
+	 * Retrieve the underlying array, row-major.
+	 */
+	constexpr container_type& getData() noexcept
+	{
+		return this->data;
+	}
+
+	/**
+	 * Retrieve the underlying array. Const qualified.
+	 */
+	[[nodiscard]] constexpr const container_type& getData() const noexcept
+	{
+		return this->data;
+	}
+
+	[[nodiscard]] static constexpr std::pair<std::size_t, std::size_t> dim() noexcept
+	{
+		return { W, H };
+	}
+
+	/**
+	 * Returns whether the grid has no elements, only when W or H is zero.
+	 */
+	[[nodiscard]] static constexpr bool empty() noexcept
+	{
+		return W * H == 0;
+	}
+
+	/**
+	 * Fill all elements with the given value.
+	 */
+	constexpr void fill(const T& value)
+	{
+		for (T& element : data)
+			element = value;
+	}
+
+	/**
+	 * Swaps the contents with another grid of the same dimensions.
+	 */
+	constexpr void swap(StaticVec2D& other) noexcept(std::is_nothrow_swappable_v<T>)
+	{
+		for (std::size_t i = 0; i < W * H; ++i)
+		{
+			T temp = std::move(data[i]);
+			data[i] = std::move(other.data[i]);
+			other.data[i] = std::move(temp);
+		}
+	}
+
+	/**
+	 * Searches the grid for a specific element.
+	 * Returns an std::optional containing the x, y position of the first match in row-major order, or an empty std::optional if not found.
+	 */
+	[[nodiscard]] constexpr std::optional<std::pair<std::size_t, std::size_t>> find(const T& value) const
+	{
+		for (std::size_t i = 0; i < W * H; ++i)
+		{
+			if (data[i] == value)
+				return std::make_pair(i % W, i / W);
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 *	Add another grid to current one.
+	 */
+	constexpr StaticVec2D& operator+=(const StaticVec2D& other)
+	{
+		return this->combine(other, std::plus<>());
+	}
+
+	/**
+	 *	Subtract another grid from current one.
+	 */
+	constexpr StaticVec2D& operator-=(const StaticVec2D& other)
+	{
+		return this->combine(other, std::minus<>());
+	}
+
+	/**
+	 *	Multiply current grid element-wise with another one.
+	 */
+	constexpr StaticVec2D& operator*=(const StaticVec2D& other)
+	{
+		return this->combine(other, std::multiplies<>());
+	}
+
+	/**
+	 *	Divide current grid element-wise by another one.
+	 */
+	constexpr StaticVec2D& operator/=(const StaticVec2D& other)
+	{
+		return this->combine(other, std::divides<>());
+	}
+
+	/**
+	 *	Add a value to every element.
+	 */
+	constexpr StaticVec2D& operator+=(const T& value)
+	{
+		return this->combine(value, std::plus<>());
+	}
+
+	/**
+	 *	Subtract a value from every element.
+	 */
+	constexpr StaticVec2D& operator-=(const T& value)
+	{
+		return this->combine(value, std::minus<>());
+	}
+
+	/**
+	 *	Multiply every element by a value.
+	 */
+	constexpr StaticVec2D& operator*=(const T& value)
+	{
+		return this->combine(value, std::multiplies<>());
+	}
+
+	/**
+	 *	Divide every element by a value.
+	 */
+	constexpr StaticVec2D& operator/=(const T& value)
+	{
+		return this->combine(value, std::divides<>());
+	}
+
+	/**
+	 * Keep the element-wise minimum of current grid and another one.
+	 */
+	constexpr StaticVec2D& minWith(const StaticVec2D& other)
+	{
+		return this->combine(other, [](const T& a, const T& b) { return b < a ? b : a; });
+	}
+
+	/**
+	 * Keep the element-wise maximum of current grid and another one.
+	 */
+	constexpr StaticVec2D& maxWith(const StaticVec2D& other)
+	{
+		return this->combine(other, [](const T& a, const T& b) { return a < b ? b : a; });
+	}
+
+	/**
+	 * Replace every element by its minimum with a value.
+	 */
+	constexpr StaticVec2D& minWith(const T& value)
+	{
+		return this->combine(value, [](const T& a, const T& b) { return b < a ? b : a; });
+	}
+
+	/**
+	 * Replace every element by its maximum with a value.
+	 */
+	constexpr StaticVec2D& maxWith(const T& value)
+	{
+		return this->combine(value, [](const T& a, const T& b) { return a < b ? b : a; });
+	}
+
+	/**
+	 * Clamp every element into [low, high].
+	 */
+	constexpr StaticVec2D& clamp(const T& low, const T& high)
+	{
+		for (T& element : data)
+			element = element < low ? low : (high < element ? high : element);
+		return *this;
+	}
+
+	friend constexpr StaticVec2D operator+(const StaticVec2D& lhs, const StaticVec2D& rhs) { return StaticVec2D(lhs) += rhs; }
+	friend constexpr StaticVec2D operator-(const StaticVec2D& lhs, const StaticVec2D& rhs) { return StaticVec2D(lhs) -= rhs; }
+	friend constexpr StaticVec2D operator*(const StaticVec2D& lhs, const StaticVec2D& rhs) { return StaticVec2D(lhs) *= rhs; }
+	friend constexpr StaticVec2D operator/(const StaticVec2D& lhs, const StaticVec2D& rhs) { return StaticVec2D(lhs) /= rhs; }
+	friend constexpr StaticVec2D operator+(const StaticVec2D& lhs, const T& rhs) { return StaticVec2D(lhs) += rhs; }
+	friend constexpr StaticVec2D operator-(const StaticVec2D& lhs, const T& rhs) { return StaticVec2D(lhs) -= rhs; }
+	friend constexpr StaticVec2D operator*(const StaticVec2D& lhs, const T& rhs) { return StaticVec2D(lhs) *= rhs; }
+	friend constexpr StaticVec2D operator/(const StaticVec2D& lhs, const T& rhs) { return StaticVec2D(lhs) /= rhs; }
+	friend constexpr StaticVec2D operator+(const T& lhs, const StaticVec2D& rhs) { return StaticVec2D(rhs) += lhs; }
+	friend constexpr StaticVec2D operator*(const T& lhs, const StaticVec2D& rhs) { return StaticVec2D(rhs) *= lhs; }
+
+	/**
+	 * Returns the transpose.
+	 */
+	[[nodiscard]] constexpr StaticVec2D<T, H, W> transposed() const
+	{
+		StaticVec2D<T, H, W> result;
+		for (std::size_t row = 0; row < H; ++row)
+			for (std::size_t col = 0; col < W; ++col)
+				result.at(col, row) = this->at(row, col);
+		return result;
+	}
+
+	/**
+	 * Returns the grid rotated a quarter turn clockwise.
+	 */
+	[[nodiscard]] constexpr StaticVec2D<T, H, W> rotated90() const
+	{
+		StaticVec2D<T, H, W> result;
+		for (std::size_t row = 0; row < H; ++row)
+			for (std::size_t col = 0; col < W; ++col)
+				result.at(col, H - 1 - row) = this->at(row, col);
+		return result;
+	}
+
+	/**
+	 * Returns the grid rotated a half turn.
+	 */
+	[[nodiscard]] constexpr StaticVec2D rotated180() const
+	{
+		StaticVec2D result;
+		for (std::size_t i = 0; i < W * H; ++i)
+			result.data[W * H - 1 - i] = data[i];
+		return result;
+	}
+
+	/**
+	 * Returns the grid rotated a quarter turn counterclockwise.
+	 */
+	[[nodiscard]] constexpr StaticVec2D<T, H, W> rotated270() const
+	{
+		StaticVec2D<T, H, W> result;
+		for (std::size_t row = 0; row < H; ++row)
+			for (std::size_t col = 0; col < W; ++col)
+				result.at(W - 1 - col, row) = this->at(row, col);
+		return result;
+	}
+
+	/**
+	 * Returns the grid mirrored left to right.
+	 */
+	[[nodiscard]] constexpr StaticVec2D flippedHorizontal() const
+	{
+		StaticVec2D result;
+		for (std::size_t row = 0; row < H; ++row)
+			for (std::size_t col = 0; col < W; ++col)
+				result.at(row, W - 1 - col) = this->at(row, col);
+		return result;
+	}
+
+	/**
+	 * Returns the grid mirrored top to bottom.
+	 */
+	[[nodiscard]] constexpr StaticVec2D flippedVertical() const
+	{
+		StaticVec2D result;
+		for (std::size_t row = 0; row < H; ++row)
+			for (std::size_t col = 0; col < W; ++col)
+				result.at(H - 1 - row, col) = this->at(row, col);
+		return result;
+	}
+
+	/**
+	 * Check to see if two grids are equivalent.
+	 */
+	friend constexpr bool operator==(const StaticVec2D& lhs, const StaticVec2D& rhs)
+	{
+		for (std::size_t i = 0; i < W * H; ++i)
+		{
+			if (!(lhs.data[i] == rhs.data[i]))
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Check to see if two grids are not equivalent.
+	 */
+	friend constexpr bool operator!=(const StaticVec2D& lhs, const StaticVec2D& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	/**
+	 * Hash of the dimensions and of every element at its position, the value a Vec2D of the same elements hashes to.
+	 */
+	[[nodiscard]] std::size_t hash() const noexcept
+	{
+		return static_cast<std::size_t>(vec2d::dimensionHash(W, H) + vec2d::hashCells(data.data(), 0, W * H));
+	}
+
+	/**
+	 * Given hash, the hash of this grid, returns its hash once the element at x, y changes from before to after.
+	 */
+	[[nodiscard]] std::size_t updateHash(std::size_t hash, std::size_t x, std::size_t y, const T& before, const T& after) const noexcept
+	{
+		const std::size_t position = x + y * W;
+		return static_cast<std::size_t>(hash - vec2d::cellHash(position, before) + vec2d::cellHash(position, after));
+	}
+
+private:
+	template <typename, std::size_t, std::size_t>
+	friend class StaticVec2D;
+
+	template <typename Op>
+	constexpr StaticVec2D& combine(const StaticVec2D& other, Op op)
+	{
+		for (std::size_t i = 0; i < W * H; ++i)
+			data[i] = static_cast<T>(op(data[i], other.data[i]));
+		return *this;
+	}
+
+	template <typename Op>
+	constexpr StaticVec2D& combine(const T& value, Op op)
+	{
+		for (T& element : data)
+			element = static_cast<T>(op(element, value));
+		return *this;
+	}
+
+	alignas(Alignment) container_type data{};	///< Underlying array, row-major.
+};
+
+template <typename T, std::size_t W, std::size_t H>
+struct std::hash<StaticVec2D<T, W, H>>
+{
+	std::size_t operator()(const StaticVec2D<T, W, H>& vec) const noexcept
+	{
+		return vec.hash();
+	}
+};
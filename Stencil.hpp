@@ -0,0 +1,492 @@
+#pragma once
+
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "Vec2D.hpp"
+#include "Vec2DView.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////
+/// STENCILS
+////////////////////////
+
+/**
+ * Neighbourhood operations over views of row-major grids: weighted kernels ( convolve ) and
+ * arbitrary per-element rules ( stencil, e.g. cellular automata ).
+ *
+ * Rows are processed in bands, each band on its own thread for parallel policies.
+ * A band slides a window of 2r+1 rows down the grid, each source row padded once with its
+ * boundary columns, so the inner loops read plain arrays with no bounds checks or index maths.
+ * Kernels are applied a whole row at a time with the SIMD kernels, separable ones as two 1D passes.
+ */
+namespace vec2d
+{
+	/**
+	 * What neighbours outside the grid read as.
+	 */
+	enum class Boundary
+	{
+		Clamp,	///< The nearest edge element.
+		Wrap,	///< The element on the opposite side ( a torus ).
+		Zero,	///< T{}.
+	};
+
+	/**
+	 * A weights grid of odd width and height, centred on the element it computes.
+	 * dst( x, y ) = sum of weight( i, j ) * src( x + i - radiusX, y + j - radiusY ), the kernel is not flipped.
+	 * Whether the weights are an outer product ( separable ) is found once, on construction.
+	 */
+	template <typename T>
+	class Kernel
+	{
+	public:
+		Kernel(std::size_t width, std::size_t height, std::vector<T> weights)
+			: width(width)
+			, height(height)
+			, weights(std::move(weights))
+		{
+			if (width % 2 == 0 || height % 2 == 0)
+				throw std::invalid_argument("Kernel sides must be odd");
+			if (this->weights.size() != width * height)
+				throw std::invalid_argument("Kernel needs width * height weights");
+
+			factors = this->separate();
+		}
+
+		/**
+		 * The outer product of a row of horizontal weights and a column of vertical weights.
+		 */
+		static Kernel separable(const std::vector<T>& horizontal, const std::vector<T>& vertical)
+		{
+			std::vector<T> weights(horizontal.size() * vertical.size());
+			for (std::size_t y = 0; y < vertical.size(); ++y)
+				for (std::size_t x = 0; x < horizontal.size(); ++x)
+					weights[x + y * horizontal.size()] = horizontal[x] * vertical[y];
+
+			Kernel kernel(horizontal.size(), vertical.size(), std::move(weights));
+			kernel.factors = std::make_pair(horizontal, vertical);
+			return kernel;
+		}
+
+		/**
+		 * A normalized ( 2 radius + 1 ) square Gaussian.
+		 */
+		static Kernel gaussian(std::size_t radius, double sigma)
+		{
+			static_assert(std::is_floating_point_v<T>, "Gaussian weights need a floating point type");
+			if (sigma <= 0)
+				throw std::invalid_argument("Sigma must be positive");
+
+			std::vector<T> weights(2 * radius + 1);
+			double total = 0;
+			for (std::size_t i = 0; i < weights.size(); ++i)
+			{
+				const double d = static_cast<double>(i) - static_cast<double>(radius);
+				total += std::exp(-d * d / (2 * sigma * sigma));
+			}
+			for (std::size_t i = 0; i < weights.size(); ++i)
+			{
+				const double d = static_cast<double>(i) - static_cast<double>(radius);
+				weights[i] = static_cast<T>(std::exp(-d * d / (2 * sigma * sigma)) / total);
+			}
+
+			return separable(weights, weights);
+		}
+
+		[[nodiscard]] std::size_t radiusX() const noexcept { return width / 2; }
+		[[nodiscard]] std::size_t radiusY() const noexcept { return height / 2; }
+		[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const noexcept { return { width, height }; }
+
+		/**
+		 * The weight at x, y of the kernel.
+		 */
+		[[nodiscard]] const T& operator()(std::size_t x, std::size_t y) const
+		{
+			return weights[x + y * width];
+		}
+
+		/**
+		 * The horizontal and vertical weights whose outer product this kernel is, if it is one.
+		 */
+		[[nodiscard]] const std::optional<std::pair<std::vector<T>, std::vector<T>>>& separableFactors() const noexcept
+		{
+			return factors;
+		}
+
+	private:
+		/**
+		 * Rank one test around the largest weight: k( x, y ) * k( px, py ) == k( x, py ) * k( px, y ) everywhere.
+		 */
+		[[nodiscard]] std::optional<std::pair<std::vector<T>, std::vector<T>>> separate() const
+		{
+			const auto magnitude = [](const T& value) { return value < T{} ? T{} - value : value; };
+
+			const auto largest = std::max_element(weights.begin(), weights.end(), [&](const T& a, const T& b)
+			{
+				return magnitude(a) < magnitude(b);
+			});
+			if (largest == weights.end() || *largest == T{})
+				return std::nullopt;
+
+			const auto at = static_cast<std::size_t>(largest - weights.begin());
+			const std::size_t px = at % width;
+			const std::size_t py = at / width;
+			const T pivot = *largest;
+
+			// Relative to the largest product, floating point weights rarely factor exactly
+			const T tolerance = std::is_floating_point_v<T> ? magnitude(pivot * pivot) * static_cast<T>(1e-5) : T{};
+			for (std::size_t y = 0; y < height; ++y)
+			{
+				for (std::size_t x = 0; x < width; ++x)
+				{
+					if (magnitude((*this)(x, y) * pivot - (*this)(x, py) * (*this)(px, y)) > tolerance)
+						return std::nullopt;
+				}
+			}
+
+			std::vector<T> horizontal(width);
+			std::vector<T> vertical(height);
+			for (std::size_t x = 0; x < width; ++x)
+				horizontal[x] = (*this)(x, py);
+			for (std::size_t y = 0; y < height; ++y)
+				vertical[y] = (*this)(px, y);
+
+			// The pivot is counted twice, divide it out of whichever side it divides exactly ( always the row for floating point )
+			const auto divides = [&](const std::vector<T>& side)
+			{
+				if constexpr (std::is_floating_point_v<T>)
+					return true;
+				else
+					return std::all_of(side.begin(), side.end(), [&](const T& w) { return w % pivot == T{}; });
+			};
+
+			auto& divided = divides(horizontal) ? horizontal : vertical;
+			if (!divides(divided))
+				return std::nullopt;
+			for (auto& w : divided)
+				w /= pivot;
+
+			return std::make_pair(std::move(horizontal), std::move(vertical));
+		}
+
+		std::size_t width;
+		std::size_t height;
+		std::vector<T> weights;	///< Row-major.
+		std::optional<std::pair<std::vector<T>, std::vector<T>>> factors;
+	};
+
+	/**
+	 * The neighbourhood of one element, as handed to stencil rules.
+	 * window( dx, dy ) reads the element dx columns right and dy rows down, |dx|, |dy| <= radius,
+	 * boundaries already applied.
+	 */
+	template <typename T>
+	class Window
+	{
+	public:
+		Window(const T* const* rows, std::size_t radius, std::size_t x) noexcept
+			: rows(rows)
+			, radius(radius)
+			, x(x)
+		{
+		}
+
+		[[nodiscard]] const T& operator()(std::ptrdiff_t dx, std::ptrdiff_t dy) const noexcept
+		{
+			return rows[static_cast<std::ptrdiff_t>(radius) + dy][static_cast<std::ptrdiff_t>(x + radius) + dx];
+		}
+
+		/**
+		 * The element itself.
+		 */
+		[[nodiscard]] const T& centre() const noexcept
+		{
+			return (*this)(0, 0);
+		}
+
+	private:
+		const T* const* rows;	///< The 2 radius + 1 padded rows around the element, top first.
+		std::size_t radius;
+		std::size_t x;
+	};
+
+	/**
+	 * Maps a row or column index possibly outside [0, size) to the one it reads, or size for Zero
+	 * ( and for an empty range, which has nothing to read whatever the boundary ).
+	 */
+	inline std::size_t resolve(std::ptrdiff_t i, std::size_t size, Boundary boundary) noexcept
+	{
+		const auto n = static_cast<std::ptrdiff_t>(size);
+		if (i >= 0 && i < n)
+			return static_cast<std::size_t>(i);
+		if (size == 0)
+			return size;
+
+		switch (boundary)
+		{
+		case Boundary::Clamp: return i < 0 ? 0 : size - 1;
+		case Boundary::Wrap: return static_cast<std::size_t>((i % n + n) % n);
+		case Boundary::Zero: break;
+		}
+		return size;
+	}
+
+	/**
+	 * Copies row y of src ( resolved against the boundary ) with radius extra columns on both sides.
+	 */
+	template <typename S, typename T>
+	void padRow(const Vec2DView<S>& src, std::ptrdiff_t y, std::size_t radius, Boundary boundary, T* out)
+	{
+		const auto [width, height] = src.dim();
+		const std::size_t row = resolve(y, height, boundary);
+		const std::size_t padded = width + 2 * radius;
+
+		if (row == height)
+		{
+			std::fill_n(out, padded, T{});
+			return;
+		}
+
+		if (src.step() == 1)
+		{
+			std::copy_n(src.data() + row * src.stride(), width, out + radius);
+		}
+		else
+		{
+			for (std::size_t x = 0; x < width; ++x)
+				out[x + radius] = src(x, row);
+		}
+
+		for (std::size_t i = 0; i < radius; ++i)
+		{
+			const std::size_t left = resolve(static_cast<std::ptrdiff_t>(i) - static_cast<std::ptrdiff_t>(radius), width, boundary);
+			const std::size_t right = resolve(static_cast<std::ptrdiff_t>(width + i), width, boundary);
+			out[i] = left == width ? T{} : src(left, row);
+			out[width + radius + i] = right == width ? T{} : src(right, row);
+		}
+	}
+
+	/**
+	 * A band's sliding window: the padded rows y - radius .. y + radius in a ring of 2 radius + 1 lines.
+	 * Moving down one row replaces only the line that left the window.
+	 */
+	template <typename T>
+	class RowRing
+	{
+	public:
+		RowRing(std::size_t lines, std::size_t length)
+			: lines(lines)
+			, length(length)
+			, storage(lines * length)
+			, ordered(lines)
+		{
+		}
+
+		/**
+		 * The line holding virtual row y.
+		 */
+		T* line(std::ptrdiff_t y) noexcept
+		{
+			const auto n = static_cast<std::ptrdiff_t>(lines);
+			return storage.data() + static_cast<std::size_t>((y % n + n) % n) * length;
+		}
+
+		/**
+		 * The lines of rows first .. first + lines - 1, top first.
+		 */
+		const T* const* window(std::ptrdiff_t first) noexcept
+		{
+			for (std::size_t i = 0; i < lines; ++i)
+				ordered[i] = line(first + static_cast<std::ptrdiff_t>(i));
+			return ordered.data();
+		}
+
+	private:
+		std::size_t lines;
+		std::size_t length;
+		std::vector<T> storage;
+		std::vector<const T*> ordered;
+	};
+
+	/**
+	 * Writes a computed row to row y of dst.
+	 */
+	template <typename T>
+	void storeRow(const Vec2DView<T>& dst, std::size_t y, const T* row)
+	{
+		const std::size_t width = dst.dim().first;
+		if (dst.step() == 1)
+		{
+			std::copy_n(row, width, dst.data() + y * dst.stride());
+			return;
+		}
+
+		for (std::size_t x = 0; x < width; ++x)
+			dst(x, y) = row[x];
+	}
+
+	template <typename S, typename T>
+	void checkStencil(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		static_assert(std::is_same_v<std::remove_const_t<S>, T>, "Source and destination must hold the same type");
+		if (src.dim() != dst.dim())
+			throw std::invalid_argument("Source and destination dimensions differ");
+	}
+
+	/**
+	 * dst( x, y ) = rule( window ) for every element, window being the radius neighbourhood of src( x, y ).
+	 * src and dst must not overlap ( see PingPong ).
+	 */
+	template <typename Policy, typename S, typename T, typename Rule, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	void stencil(Policy&&, const Vec2DView<S>& src, const Vec2DView<T>& dst, std::size_t radius, Boundary boundary, Rule rule)
+	{
+		checkStencil(src, dst);
+		const auto [width, height] = src.dim();
+		if (width == 0 || height == 0)
+			return;	// No row to pad, nor column to resolve boundaries against
+
+		const std::size_t lines = 2 * radius + 1;
+
+		parallel::forBlocks(parallel::IsParallelPolicy<Policy>, height, parallel::rowGrain(width), [&](std::size_t first, std::size_t last)
+		{
+			RowRing<T> ring(lines, width + 2 * radius);
+			std::vector<T> out(width);
+
+			const auto top = static_cast<std::ptrdiff_t>(first) - static_cast<std::ptrdiff_t>(radius);
+			for (std::ptrdiff_t y = top; y < top + static_cast<std::ptrdiff_t>(lines) - 1; ++y)
+				padRow(src, y, radius, boundary, ring.line(y));
+
+			for (std::size_t y = first; y < last; ++y)
+			{
+				const auto bottom = static_cast<std::ptrdiff_t>(y + radius);
+				padRow(src, bottom, radius, boundary, ring.line(bottom));
+
+				const T* const* rows = ring.window(static_cast<std::ptrdiff_t>(y) - static_cast<std::ptrdiff_t>(radius));
+				for (std::size_t x = 0; x < width; ++x)
+					out[x] = static_cast<T>(rule(Window<T>(rows, radius, x)));
+
+				storeRow(dst, y, out.data());
+			}
+		});
+	}
+
+	template <typename S, typename T, typename Rule>
+	void stencil(const Vec2DView<S>& src, const Vec2DView<T>& dst, std::size_t radius, Boundary boundary, Rule rule)
+	{
+		stencil(std::execution::seq, src, dst, radius, boundary, std::move(rule));
+	}
+
+	/**
+	 * Applies a weights kernel to src into dst. src and dst must not overlap.
+	 * Separable kernels run as a horizontal then a vertical 1D pass ( w + h instead of w * h taps per element ).
+	 */
+	template <typename Policy, typename S, typename T, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	void convolve(Policy&&, const Vec2DView<S>& src, const Vec2DView<T>& dst, const Kernel<T>& kernel, Boundary boundary)
+	{
+		checkStencil(src, dst);
+		const auto [width, height] = src.dim();
+		if (width == 0 || height == 0)
+			return;
+
+		const std::size_t rx = kernel.radiusX();
+		const std::size_t ry = kernel.radiusY();
+		const std::size_t lines = 2 * ry + 1;
+		const auto& factors = kernel.separableFactors();
+
+		parallel::forBlocks(parallel::IsParallelPolicy<Policy>, height, parallel::rowGrain(width), [&](std::size_t first, std::size_t last)
+		{
+			// Separable kernels keep horizontally filtered rows in the ring, the others padded source rows
+			RowRing<T> ring(lines, factors ? width : width + 2 * rx);
+			std::vector<T> padded(factors ? width + 2 * rx : 0);
+			std::vector<T> out(width);
+
+			const auto load = [&](std::ptrdiff_t y)
+			{
+				if (!factors)
+				{
+					padRow(src, y, rx, boundary, ring.line(y));
+					return;
+				}
+
+				T* filtered = ring.line(y);
+				padRow(src, y, rx, boundary, padded.data());
+				std::fill_n(filtered, width, T{});
+				for (std::size_t i = 0; i < 2 * rx + 1; ++i)
+					simd::run<simd::Op::AddScaled>(filtered, padded.data() + i, static_cast<const T*>(nullptr), factors->first[i], T{}, width);
+			};
+
+			const auto top = static_cast<std::ptrdiff_t>(first) - static_cast<std::ptrdiff_t>(ry);
+			for (std::ptrdiff_t y = top; y < top + static_cast<std::ptrdiff_t>(lines) - 1; ++y)
+				load(y);
+
+			for (std::size_t y = first; y < last; ++y)
+			{
+				load(static_cast<std::ptrdiff_t>(y + ry));
+				const T* const* rows = ring.window(static_cast<std::ptrdiff_t>(y) - static_cast<std::ptrdiff_t>(ry));
+
+				std::fill(out.begin(), out.end(), T{});
+				for (std::size_t j = 0; j < lines; ++j)
+				{
+					if (factors)
+					{
+						simd::run<simd::Op::AddScaled>(out.data(), rows[j], static_cast<const T*>(nullptr), factors->second[j], T{}, width);
+						continue;
+					}
+
+					// One whole-row multiply-add per tap, the row shifted by the tap's column
+					for (std::size_t i = 0; i < 2 * rx + 1; ++i)
+						simd::run<simd::Op::AddScaled>(out.data(), rows[j] + i, static_cast<const T*>(nullptr), kernel(i, j), T{}, width);
+				}
+
+				storeRow(dst, y, out.data());
+			}
+		});
+	}
+
+	template <typename S, typename T>
+	void convolve(const Vec2DView<S>& src, const Vec2DView<T>& dst, const Kernel<T>& kernel, Boundary boundary)
+	{
+		convolve(std::execution::seq, src, dst, kernel, boundary);
+	}
+
+	/**
+	 * Two grids of the same dimensions for iterated stencils: each step reads the current one and
+	 * writes the other, which then becomes current. No allocation or copy per step.
+	 */
+	template <typename T>
+	class PingPong
+	{
+	public:
+		explicit PingPong(Vec2D<T> initial)
+			: front(std::move(initial))
+			, back(front.dim().first, front.dim().second)
+		{
+		}
+
+		/**
+		 * Calls f( current, next ) with the current grid ( read only ) and the one to write, then swaps them.
+		 */
+		template <typename F>
+		void step(F&& f)
+		{
+			f(static_cast<const Vec2D<T>&>(front), back);
+			front.swap(back);
+		}
+
+		[[nodiscard]] Vec2D<T>& current() noexcept { return front; }
+		[[nodiscard]] const Vec2D<T>& current() const noexcept { return front; }
+
+	private:
+		Vec2D<T> front;
+		Vec2D<T> back;
+	};
+}
@@ -2,9 +2,27 @@
 
 // Bundled headers
 #include "Overloaded.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "AlignedAllocator.hpp"
+#include "BlockCompression.hpp"
 #include "CircularBuffer.hpp"
+#include "MirroredCircularBuffer.hpp"
+#include "SharedCircularBuffer.hpp"
+#include "WindowedStatistics.hpp"
 #include "Matrix3D.hpp"
+#include "Vec2DHash.hpp"
+#include "Vec2DLayout.hpp"
+#include "Vec2DView.hpp"
+#include "Vec2DTransform.hpp"
+#include "Vec2DFile.hpp"
 #include "Vec2D.hpp"
+#include "MappedVec2D.hpp"
+#include "SparseVec2D.hpp"
+#include "StaticVec2D.hpp"
+#include "Stencil.hpp"
+#include "Reduce.hpp"
+#include "GridSearch.hpp"
 #include "Vec3D.hpp"
 #include "Matrix3D.hpp"
 
@@ -1,11 +1,64 @@
 #pragma once
 
+#include "AlignedAllocator.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include "Vec2DExpression.hpp"
+#include "Vec2DHash.hpp"
+#include "Vec2DLayout.hpp"
+#include "Vec2DTransform.hpp"
+#include "Vec2DView.hpp"
+
 #include <vector>
 #include <optional>
 #include <functional>
 #include <cassert>
 #include <algorithm>
+#include <atomic>
 #include <execution>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace vec2d
+{
+	/**
+	 * Tag for the Vec2D constructor which does not write the elements, Vec2D( vec2d::uninitialized, width, height ).
+	 */
+	struct Uninitialized
+	{
+		explicit Uninitialized() = default;
+	};
+
+	inline constexpr Uninitialized uninitialized{};
+
+	/**
+	 * Tag for the Vec2D constructor which takes over filled storage, Vec2D( vec2d::adopt, width, height, storage ).
+	 */
+	struct Adopt
+	{
+		explicit Adopt() = default;
+	};
+
+	inline constexpr Adopt adopt{};
+
+	/**
+	 * Whether Storage can grow in place like a std::vector, i.e. has capacity() and resize( n ).
+	 */
+	template <typename Storage, typename = void>
+	struct IsResizableStorage : std::false_type
+	{
+	};
+
+	template <typename Storage>
+	struct IsResizableStorage<Storage, std::void_t<
+		decltype(std::declval<const Storage&>().capacity()),
+		decltype(std::declval<Storage&>().resize(std::size_t{}))>> : std::true_type
+	{
+	};
+}
 
 ////////////////////////
 /// VECTOR2D
@@ -13,58 +66,88 @@
 
 /**
  * A collection which mirrors a 2D array.
+ * Layout decides how elements are arranged in memory ( see Vec2DLayout.hpp ), row-major by default.
+ * Storage is the container holding them, anything vector-like with contiguous elements.
  */
-template <typename T>
+template <typename T, typename Layout, typename Storage>
 class Vec2D
 {
+
+	template <bool IsConst>
+	class LayoutIterator;
+
+	/**
+	 * Row-major grids iterate their storage directly, other layouts walk the elements in row-major order.
+	 */
+	template <bool IsConst>
+	using Iterator = std::conditional_t<Layout::IsRowMajor,
+		std::conditional_t<IsConst, typename Storage::const_iterator, typename Storage::iterator>,
+		LayoutIterator<IsConst>>;
+
 public:
 	/**
-	 * STL compatible. (Thankfully nothing really needs to be done thanks to the underlying vector)
+	 * STL compatible. Iteration is in row-major order: row-major grids hand out the iterators of their
+	 * Storage, other layouts a random access iterator mapping each position through the layout.
+	 * container_type is the Storage itself, in storage order.
 	 */
 	using value_type = T;
-	using iterator = typename std::vector<T>::iterator;
-	using const_iterator = typename std::vector<T>::const_iterator;
-	using reverse_iterator = typename std::vector<T>::reverse_iterator;
-	using const_reverse_iterator = typename std::vector<T>::const_reverse_iterator;
+	using layout_type = Layout;
+	using container_type = Storage;
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 	iterator begin() noexcept
 	{
-		return data.begin();
+		if constexpr (Layout::IsRowMajor)
+			return data.begin();
+		else
+			return { this, 0 };
 	}
 
 	[[nodiscard]] const_iterator begin() const noexcept
 	{
-		return data.begin();
+		if constexpr (Layout::IsRowMajor)
+			return data.begin();
+		else
+			return { this, 0 };
 	}
 
 	iterator end() noexcept
 	{
-		return data.end();
+		if constexpr (Layout::IsRowMajor)
+			return data.end();
+		else
+			return { this, width * height };
 	}
 
 	[[nodiscard]] const_iterator end() const noexcept
 	{
-		return data.end();
+		if constexpr (Layout::IsRowMajor)
+			return data.end();
+		else
+			return { this, width * height };
 	}
 
 	reverse_iterator rbegin() noexcept
 	{
-		return data.rbegin();
+		return reverse_iterator(end());
 	}
 
 	[[nodiscard]] const_reverse_iterator rbegin() const noexcept
 	{
-		return data.rbegin();
+		return const_reverse_iterator(end());
 	}
 
 	reverse_iterator rend() noexcept
 	{
-		return data.rend();
+		return reverse_iterator(begin());
 	}
 
 	[[nodiscard]] const_reverse_iterator rend() const noexcept
 	{
-		return data.rend();
+		return const_reverse_iterator(begin());
 	}
 
 	/**
@@ -73,25 +156,134 @@ public:
 	Vec2D(const std::size_t width, const std::size_t height, std::optional<T> defaultValue = {})
 		: width(width)
 		, height(height)
-		, data(width* height, defaultValue.value_or(T{}))
+		, data(Layout::size(width, height), defaultValue.value_or(T{}))
 	{
 	}
 
 	/**
-	 * Initializes a Vec2D object from a raw 2D vector.
+	 * Initializes a 2D vector of given width and height without writing its elements, for grids about to be
+	 * overwritten whole. Storage with a DefaultInitAllocator ( DefaultInitVec2D ) leaves trivially copyable
+	 * elements uninitialized, skipping the fill a grid of width x height would otherwise pay.
+	 */
+	Vec2D(vec2d::Uninitialized, const std::size_t width, const std::size_t height)
+		: width(width)
+		, height(height)
+		, data(Layout::size(width, height))
+	{
+	}
+
+	/**
+	 * Initializes a 2D vector of given width and height, filled with the provided default value (if provided),
+	 * with rows written by the threads of the policy. With DefaultInitVec2D, pages are first touched by the thread
+	 * that fills them, so on NUMA machines each row block lands on the node which later parallel passes run it on.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	Vec2D(Policy&&, const std::size_t width, const std::size_t height, std::optional<T> defaultValue = {})
+		: width(width)
+		, height(height)
+		, data(Layout::size(width, height))
+	{
+		const T value = defaultValue.value_or(T{});
+		this->forRowBlocks<Policy>([&](std::size_t begin, std::size_t end)
+		{
+			std::fill(data.begin() + begin, data.begin() + end, value);
+		});
+	}
+
+	/**
+	 * Adopts storage already holding the elements of a width x height grid, in Layout order. Nothing is copied,
+	 * the grid takes over the buffer ( e.g. a std::vector<T> filled by a decoder ).
+	 */
+	Vec2D(vec2d::Adopt, const std::size_t width, const std::size_t height, Storage&& storage)
+		: width(width)
+		, height(height)
+		, data(std::move(storage))
+	{
+		if (data.size() != Layout::size(width, height))
+			throw std::invalid_argument("Storage does not match the dimensions");
+	}
+
+	/**
+	 * Initializes a Vec2D object from a raw 2D vector. Rows shorter than the longest are padded with T{}.
 	 */
 	explicit Vec2D(const std::vector<std::vector<T>>& other)
-		: width(std::reduce(other.begin(), other.end(), std::size_t{ 0 }, [](const auto& a, const auto& b) { return std::max(a, b.size()); }))
+		: width(widest(other))
 		, height(other.size())
-		, data(width* height)
+		, data(Layout::size(width, height))
+	{
+		this->takeRows(other);
+	}
+
+	/**
+	 * Initializes a Vec2D object from a raw 2D vector, moving the elements out of it. Each row is released
+	 * once moved, so the peak memory stays near one copy of the grid.
+	 */
+	explicit Vec2D(std::vector<std::vector<T>>&& other)
+		: width(widest(other))
+		, height(other.size())
+		, data(Layout::size(width, height))
+	{
+		this->takeRows(other);
+		other.clear();
+	}
+
+	Vec2D(const Vec2D&) = default;
+	Vec2D& operator=(const Vec2D&) = default;
+
+	/**
+	 * Takes the elements of other, which is left an empty 0 x 0 grid.
+	 */
+	Vec2D(Vec2D&& other) noexcept(std::is_nothrow_move_constructible_v<Storage>)
+		: width(std::exchange(other.width, 0))
+		, height(std::exchange(other.height, 0))
+		, data(std::move(other.data))
+	{
+	}
+
+	/**
+	 * Takes the elements of other, which is left an empty 0 x 0 grid.
+	 */
+	Vec2D& operator=(Vec2D&& other) noexcept(std::is_nothrow_move_assignable_v<Storage>)
 	{
-		for (std::size_t y = 0; y < other.size(); ++y)
+		if (this != &other)
 		{
-			for (std::size_t x = 0; x < other[y].size(); ++x)
-			{
-				this->at(y, x) = other[y][x];
-			}
+			width = std::exchange(other.width, 0);
+			height = std::exchange(other.height, 0);
+			data = std::move(other.data);
+		}
+		return *this;
+	}
+
+	/**
+	 * Evaluates an arithmetic expression of 2D vectors in a single pass.
+	 */
+	template <typename E>
+	Vec2D(const Vec2DExpression<E>& expr)
+		: width(expr.derived().dim().first)
+		, height(expr.derived().dim().second)
+		, data(Layout::size(width, height))
+	{
+		this->assign(expr.derived());
+	}
+
+	/**
+	 * Evaluates an arithmetic expression of 2D vectors in a single pass, adopting its dimensions.
+	 * The expression may refer to this 2D vector.
+	 */
+	template <typename E>
+	Vec2D& operator=(const Vec2DExpression<E>& expr)
+	{
+		const auto [newWidth, newHeight] = expr.derived().dim();
+		if (newWidth != width || newHeight != height)
+		{
+			// Resizing would invalidate the expression if it refers to this 2D vector
+			Vec2D result(expr);
+			this->swap(result);
+			return *this;
 		}
+
+		this->assign(expr.derived());
+		return *this;
 	}
 
 	/**
@@ -100,7 +292,7 @@ public:
 	[[nodiscard]] const T& at(std::size_t row, std::size_t col) const
 	{
 		assert(row < this->height&& col < this->width); // In range check (Only for debug mode)
-		return this->data[col + row * this->width];
+		return this->data[Layout::index(col, row, this->width, this->height)];
 	}
 
 	/**
@@ -109,7 +301,7 @@ public:
 	T& at(std::size_t row, std::size_t col)
 	{
 		assert(row < this->height&& col < this->width); // In range check (Only for debug mode)
-		return this->data[col + row * this->width];
+		return this->data[Layout::index(col, row, this->width, this->height)];
 	}
 
 	/**
@@ -129,9 +321,188 @@ public:
 	}
 
 	/**
-	 * Retrieve the underlying vector.
+	 * Returns a view of the whole grid, to slice into sub-grids without copies.
+	 */
+	[[nodiscard]] Vec2DView<T> view() noexcept
+	{
+		static_assert(Layout::IsRowMajor, "Views need row-major storage");
+		return { data.data(), width, height, width };
+	}
+
+	/**
+	 * Returns a view of the whole grid. Const qualified.
+	 */
+	[[nodiscard]] Vec2DView<const T> view() const noexcept
+	{
+		static_assert(Layout::IsRowMajor, "Views need row-major storage");
+		return { data.data(), width, height, width };
+	}
+
+	/**
+	 * Returns a view of the w x h sub-grid whose top left element is at x, y.
+	 */
+	[[nodiscard]] Vec2DView<T> subview(std::size_t x, std::size_t y, std::size_t w, std::size_t h)
+	{
+		return this->view().subview(x, y, w, h);
+	}
+
+	/**
+	 * Returns a view of the w x h sub-grid whose top left element is at x, y. Const qualified.
+	 */
+	[[nodiscard]] Vec2DView<const T> subview(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const
+	{
+		return this->view().subview(x, y, w, h);
+	}
+
+	/**
+	 * Transposes in place, width and height swap. Square grids need no extra memory.
+	 */
+	Vec2D& transpose()
+	{
+		if (width != height)
+			return *this = this->transposed();
+
+		vec2d::transposeInPlace(this->view());
+		return *this;
+	}
+
+	/**
+	 * Returns the transpose.
+	 */
+	[[nodiscard]] Vec2D transposed() const
+	{
+		Vec2D result(vec2d::uninitialized, height, width);
+		vec2d::transpose(this->view(), result.view());
+		return result;
+	}
+
+	/**
+	 * Rotates a quarter turn clockwise in place, width and height swap. Square grids need no extra memory.
+	 */
+	Vec2D& rotate90()
+	{
+		if (width != height)
+			return *this = this->rotated90();
+
+		vec2d::transposeInPlace(this->view());
+		return this->flipHorizontal();
+	}
+
+	/**
+	 * Returns the grid rotated a quarter turn clockwise.
+	 */
+	[[nodiscard]] Vec2D rotated90() const
+	{
+		Vec2D result(vec2d::uninitialized, height, width);
+		vec2d::rotate90(this->view(), result.view());
+		return result;
+	}
+
+	/**
+	 * Rotates a half turn in place.
+	 */
+	Vec2D& rotate180()
+	{
+		static_assert(Layout::IsRowMajor, "Rotations need row-major storage");
+
+		// Row-major, so that is the whole storage backwards
+		std::reverse(data.begin(), data.end());
+		return *this;
+	}
+
+	/**
+	 * Returns the grid rotated a half turn.
+	 */
+	[[nodiscard]] Vec2D rotated180() const
+	{
+		Vec2D result(vec2d::uninitialized, width, height);
+		vec2d::rotate180(this->view(), result.view());
+		return result;
+	}
+
+	/**
+	 * Rotates a quarter turn counterclockwise in place, width and height swap. Square grids need no extra memory.
+	 */
+	Vec2D& rotate270()
+	{
+		if (width != height)
+			return *this = this->rotated270();
+
+		vec2d::transposeInPlace(this->view());
+		return this->flipVertical();
+	}
+
+	/**
+	 * Returns the grid rotated a quarter turn counterclockwise.
+	 */
+	[[nodiscard]] Vec2D rotated270() const
+	{
+		Vec2D result(vec2d::uninitialized, height, width);
+		vec2d::rotate270(this->view(), result.view());
+		return result;
+	}
+
+	/**
+	 * Mirrors left to right in place.
+	 */
+	Vec2D& flipHorizontal()
+	{
+		vec2d::flipHorizontalInPlace(this->view());
+		return *this;
+	}
+
+	/**
+	 * Returns the grid mirrored left to right.
+	 */
+	[[nodiscard]] Vec2D flippedHorizontal() const
+	{
+		Vec2D result(vec2d::uninitialized, width, height);
+		vec2d::flipHorizontal(this->view(), result.view());
+		return result;
+	}
+
+	/**
+	 * Mirrors top to bottom in place.
+	 */
+	Vec2D& flipVertical()
+	{
+		vec2d::flipVerticalInPlace(this->view());
+		return *this;
+	}
+
+	/**
+	 * Returns the grid mirrored top to bottom.
+	 */
+	[[nodiscard]] Vec2D flippedVertical() const
+	{
+		Vec2D result(vec2d::uninitialized, width, height);
+		vec2d::flipVertical(this->view(), result.view());
+		return result;
+	}
+
+	/**
+	 * Calls f( tile ) for every tile of the grid, a Vec2DTile<T> window of up to TileWidth x TileHeight elements,
+	 * in storage order. Kernels working tile by tile keep their working set in cache whatever the grid width.
+	 */
+	template <typename F>
+	void forEachTile(F&& f)
+	{
+		this->visitTiles<T>(*this, f);
+	}
+
+	/**
+	 * Calls f( tile ) for every tile of the grid, a Vec2DTile<const T>. Const qualified.
 	 */
-	std::vector<T>& getData()
+	template <typename F>
+	void forEachTile(F&& f) const
+	{
+		this->visitTiles<const T>(*this, f);
+	}
+
+	/**
+	 * Retrieve the underlying vector. Elements are in storage order, which may include padding for tiled layouts.
+	 */
+	container_type& getData()
 	{
 		return this->data;
 	}
@@ -139,7 +510,7 @@ public:
 	/**
 	 * Retrieve the underlying vector. Const qualified.
 	 */
-	[[nodiscard]] const std::vector<T>& getData() const
+	[[nodiscard]] const container_type& getData() const
 	{
 		return this->data;
 	}
@@ -160,6 +531,18 @@ public:
 		std::fill(data.begin(), data.end(), value);
 	}
 
+	/**
+	 * Fill all elements with the given value, split by row blocks over the threads of the policy.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	void fill(Policy&&, const T& value)
+	{
+		this->forRowBlocks<Policy>([&](std::size_t begin, std::size_t end)
+		{
+			std::fill(data.begin() + begin, data.begin() + end, value);
+		});
+	}
+
 	/**
 	 * Swaps the contents of the Vec2D object with another Vec2D object.
 	 */
@@ -178,39 +561,147 @@ public:
 	}
 
 	/**
-	* Removes all elements from the Vec2D object.
+	* Removes all elements from the Vec2D object, leaving an empty 0 x 0 grid.
 	*/
 	void clear()
 	{
 		data.clear();
+		width = 0;
+		height = 0;
 	}
 
 	/**
-	 * Reserves a specific amount of memory for the Vec2D object.
+	 * Reserves memory for n elements, the dimensions are unchanged. A later resize() to at most n elements
+	 * then moves rows within the buffer instead of reallocating.
 	 */
 	void reserve(std::size_t n)
 	{
 		data.reserve(n);
 	}
 
+	/**
+	 * Changes the dimensions to newWidth x newHeight, keeping the elements of the overlapping top left region
+	 * at their x, y. New cells get value ( T{} if not provided ).
+	 * Row-major grids move their rows within the buffer when it is large enough ( see reserve() ), rows
+	 * moving towards the front first when rows shrink and from the back when they grow, so nothing is
+	 * copied twice. Otherwise, and always for storage which cannot grow in place ( e.g. MappedStorage ),
+	 * the kept elements are moved once into a new buffer.
+	 */
+	void resize(std::size_t newWidth, std::size_t newHeight, std::optional<T> value = {})
+	{
+		if (newWidth == width && newHeight == height)
+			return;
+
+		const T fillValue = value.value_or(T{});
+		const std::size_t keepRows = std::min(height, newHeight);
+		const std::size_t keepCols = std::min(width, newWidth);
+
+		if constexpr (Layout::IsRowMajor && vec2d::IsResizableStorage<Storage>::value)
+		{
+			const std::size_t newSize = newWidth * newHeight;
+			if (newSize <= data.capacity() || newWidth == width)
+			{
+				// Rows shrink: move towards the front, first row first
+				if (newWidth < width)
+				{
+					for (std::size_t y = 1; y < keepRows; ++y)
+						std::move(data.begin() + y * width, data.begin() + y * width + newWidth, data.begin() + y * newWidth);
+				}
+
+				if (newSize > data.size())
+					data.resize(newSize);
+
+				// Rows grow: move towards the back, last row first, then fill the new columns
+				if (newWidth > width)
+				{
+					for (std::size_t y = keepRows; y-- > 0;)
+					{
+						if (y > 0)
+							std::move_backward(data.begin() + y * width, data.begin() + (y + 1) * width, data.begin() + y * newWidth + width);
+						std::fill(data.begin() + y * newWidth + width, data.begin() + (y + 1) * newWidth, fillValue);
+					}
+				}
+
+				data.resize(newSize);
+				std::fill(data.begin() + keepRows * newWidth, data.end(), fillValue);
+				width = newWidth;
+				height = newHeight;
+				return;
+			}
+		}
+
+		Vec2D result(vec2d::uninitialized, newWidth, newHeight);
+		for (std::size_t y = 0; y < newHeight; ++y)
+		{
+			for (std::size_t x = 0; x < newWidth; ++x)
+			{
+				if (y < keepRows && x < keepCols)
+					result.at(y, x) = std::move(this->at(y, x));
+				else
+					result.at(y, x) = fillValue;
+			}
+		}
+		this->swap(result);
+	}
+
+	/**
+	 * Reinterprets the elements as a newWidth x newHeight grid, in O(1): the row-major sequence is unchanged,
+	 * so a 6 x 2 grid becomes 3 x 4 by cutting the same elements into shorter rows.
+	 * Throws std::invalid_argument if the element count differs.
+	 */
+	Vec2D& reshape(std::size_t newWidth, std::size_t newHeight)
+	{
+		static_assert(Layout::IsRowMajor, "Reshaping needs row-major storage");
+
+		if (newWidth * newHeight != width * height)
+			throw std::invalid_argument("Reshaping must keep the number of elements");
+
+		width = newWidth;
+		height = newHeight;
+		return *this;
+	}
+
 	/**
 	 * Searches the Vec2D object for a specific element.
 	 * Returns an std::optional containing the position of the element if found, or an empty std::optional if not found.
 	 */
 	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> find(const T& value) const
 	{
-		// Use std::find to search for the specified value in the data member
-		auto it = std::find(data.begin(), data.end(), value);
+		return this->find(std::execution::seq, value);
+	}
+
+	/**
+	 * Searches the Vec2D object for a specific element, split by row blocks over the threads of the policy.
+	 * Still returns the first match in row-major order, blocks past an already found match are skipped.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> find(Policy&&, const T& value) const
+	{
+		// Row-major index of the first match so far
+		const std::size_t count = width * height;
+		std::atomic<std::size_t> first{ count };
+
+		this->forRows<Policy>([&](std::size_t rowBegin, std::size_t rowEnd)
+		{
+			if (rowBegin * width >= first.load(std::memory_order_relaxed))
+				return;
+
+			std::size_t index = this->findInRows(value, rowBegin, rowEnd);
+			if (index == count)
+				return;
+
+			std::size_t current = first.load(std::memory_order_relaxed);
+			while (index < current && !first.compare_exchange_weak(current, index, std::memory_order_relaxed))
+			{
+			}
+		});
 
-		// If the value was not found, return an empty std::optional
-		if (it == data.end())
+		const std::size_t index = first.load(std::memory_order_relaxed);
+		if (index == count)
 		{
 			return std::nullopt;
 		}
 
-		// Calculate the index of the element in the data member
-		const std::size_t index = std::distance(data.begin(), it);
-
 		// Calculate the position of the element using the index and the width of the Vec2D object
 		return std::make_pair(index % width, index / width);
 	}
@@ -220,9 +711,7 @@ public:
 	 */
 	Vec2D& operator+=(const Vec2D& other)
 	{
-		assert(this->width == other.width && this->height == other.height);
-		std::transform(data.begin(), data.end(), other.data.begin(), data.begin(), std::plus<T>());
-		return *this;
+		return this->apply<simd::Op::Add>(other);
 	}
 
 	/**
@@ -230,27 +719,171 @@ public:
 	 */
 	Vec2D& operator-=(const Vec2D& other)
 	{
-		assert(this->width == other.width && this->height == other.height);
-		std::transform(data.begin(), data.end(), other.data.begin(), data.begin(), std::minus<T>());
-		return *this;
+		return this->apply<simd::Op::Sub>(other);
+	}
+
+	/**
+	 *	Multiply current 2D Vector element-wise with another one and return the result.
+	 */
+	Vec2D& operator*=(const Vec2D& other)
+	{
+		return this->apply<simd::Op::Mul>(other);
+	}
+
+	/**
+	 *	Divide current 2D Vector element-wise by another one and return the result.
+	 */
+	Vec2D& operator/=(const Vec2D& other)
+	{
+		return this->apply<simd::Op::Div>(other);
+	}
+
+	/**
+	 *	Add another 2D Vector to current one, split by row blocks over the threads of the policy.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	Vec2D& add(Policy&&, const Vec2D& other)
+	{
+		return this->apply<simd::Op::Add, Policy>(other);
+	}
+
+	/**
+	 *	Subtract another 2D Vector from current one, split by row blocks over the threads of the policy.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	Vec2D& subtract(Policy&&, const Vec2D& other)
+	{
+		return this->apply<simd::Op::Sub, Policy>(other);
+	}
+
+	/**
+	 *	Add an expression to current 2D Vector, evaluated in a single pass.
+	 */
+	template <typename E>
+	Vec2D& operator+=(const Vec2DExpression<E>& expr)
+	{
+		return this->update(expr.derived(), std::plus<>());
+	}
+
+	/**
+	 *	Subtract an expression from current 2D Vector, evaluated in a single pass.
+	 */
+	template <typename E>
+	Vec2D& operator-=(const Vec2DExpression<E>& expr)
+	{
+		return this->update(expr.derived(), std::minus<>());
+	}
+
+	/**
+	 *	Multiply current 2D Vector element-wise with an expression, evaluated in a single pass.
+	 */
+	template <typename E>
+	Vec2D& operator*=(const Vec2DExpression<E>& expr)
+	{
+		return this->update(expr.derived(), std::multiplies<>());
+	}
+
+	/**
+	 *	Divide current 2D Vector element-wise by an expression, evaluated in a single pass.
+	 */
+	template <typename E>
+	Vec2D& operator/=(const Vec2DExpression<E>& expr)
+	{
+		return this->update(expr.derived(), std::divides<>());
+	}
+
+	/**
+	 *	Add a value to every element and return the result.
+	 */
+	Vec2D& operator+=(const T& value)
+	{
+		return this->apply<simd::Op::AddScalar>(value);
+	}
+
+	/**
+	 *	Subtract a value from every element and return the result.
+	 */
+	Vec2D& operator-=(const T& value)
+	{
+		return this->apply<simd::Op::SubScalar>(value);
+	}
+
+	/**
+	 *	Multiply every element by a value and return the result.
+	 */
+	Vec2D& operator*=(const T& value)
+	{
+		return this->apply<simd::Op::MulScalar>(value);
+	}
+
+	/**
+	 *	Divide every element by a value and return the result.
+	 */
+	Vec2D& operator/=(const T& value)
+	{
+		return this->apply<simd::Op::DivScalar>(value);
+	}
+
+	/**
+	 * Keep the element-wise minimum of current 2D Vector and another one.
+	 */
+	Vec2D& minWith(const Vec2D& other)
+	{
+		return this->apply<simd::Op::Min>(other);
+	}
+
+	/**
+	 * Keep the element-wise maximum of current 2D Vector and another one.
+	 */
+	Vec2D& maxWith(const Vec2D& other)
+	{
+		return this->apply<simd::Op::Max>(other);
 	}
 
 	/**
-	 * Return the summation of two 2D vectors.
+	 * Replace every element by its minimum with a value.
 	 */
-	friend Vec2D operator+(Vec2D lhs, const Vec2D& rhs)
+	Vec2D& minWith(const T& value)
 	{
-		lhs += rhs;
-		return lhs;
+		return this->apply<simd::Op::MinScalar>(value);
 	}
 
 	/**
-	 * Return the subtraction result of two 2D vectors.
+	 * Replace every element by its maximum with a value.
 	 */
-	friend Vec2D operator-(Vec2D lhs, const Vec2D& rhs)
+	Vec2D& maxWith(const T& value)
 	{
-		lhs -= rhs;
-		return lhs;
+		return this->apply<simd::Op::MaxScalar>(value);
+	}
+
+	/**
+	 * Clamp every element into [low, high].
+	 */
+	Vec2D& clamp(const T& low, const T& high)
+	{
+		return this->apply<simd::Op::Clamp>(low, high);
+	}
+
+	/**
+	 * Fused multiply-add, adds the element-wise product of two 2D vectors to current one.
+	 */
+	Vec2D& multiplyAdd(const Vec2D& a, const Vec2D& b)
+	{
+		assert(this->width == a.width && this->height == a.height);
+		assert(this->width == b.width && this->height == b.height);
+		this->forRowBlocks<std::execution::sequenced_policy>([&](std::size_t begin, std::size_t end)
+		{
+			simd::run<simd::Op::MulAdd>(data.data() + begin, a.data.data() + begin, b.data.data() + begin, T{}, T{}, end - begin);
+		});
+		return *this;
+	}
+
+	/**
+	 * Fused multiply-add, replaces every element x by x * scale + offset.
+	 */
+	Vec2D& multiplyAdd(const T& scale, const T& offset)
+	{
+		return this->apply<simd::Op::MulAddScalar>(scale, offset);
 	}
 
 	/**
@@ -258,14 +891,31 @@ public:
 	 */
 	friend bool operator==(const Vec2D& lhs, const Vec2D& rhs)
 	{
-		// Check that the dimensions of the two Vec2D objects are equal
-		if (lhs.width != rhs.width || lhs.height != rhs.height)
+		return lhs.equals(std::execution::seq, rhs);
+	}
+
+	/**
+	 * Check to see if two vectors are equivalent, comparing row blocks over the threads of the policy.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] bool equals(Policy&&, const Vec2D& other) const
+	{
+		if (this->width != other.width || this->height != other.height)
 		{
 			return false;
 		}
 
-		// Check that the elements of the two Vec2D objects are equal
-		return lhs.data == rhs.data;
+		std::atomic<bool> different{ false };
+		this->forRowBlocks<Policy>([&](std::size_t begin, std::size_t end)
+		{
+			if (different.load(std::memory_order_relaxed))
+				return;
+
+			if (!std::equal(data.begin() + begin, data.begin() + end, other.data.begin() + begin))
+				different.store(true, std::memory_order_relaxed);
+		});
+
+		return !different.load(std::memory_order_relaxed);
 	}
 
 	/**
@@ -284,27 +934,315 @@ public:
 
 
 	/**
-	 * Hash function.
+	 * Hash of the dimensions and of every element at its position ( see Vec2DHash.hpp ), the same value
+	 * std::hash gives, with row blocks hashed over the threads of the policy. Independent of the layout.
+	 */
+	template <typename Policy, parallel::EnableIfExecutionPolicy<Policy> = 0>
+	[[nodiscard]] std::size_t hash(Policy&&) const
+	{
+		std::atomic<std::uint64_t> h{ vec2d::dimensionHash(width, height) };
+		this->forRows<Policy>([&](std::size_t rowBegin, std::size_t rowEnd)
+		{
+			std::uint64_t partial = 0;
+			if constexpr (Layout::IsRowMajor)
+			{
+				partial = vec2d::hashCells(data.data() + rowBegin * width, rowBegin * width, (rowEnd - rowBegin) * width);
+			}
+			else
+			{
+				for (std::size_t row = rowBegin; row < rowEnd; ++row)
+				{
+					for (std::size_t col = 0; col < width; ++col)
+					{
+						partial += vec2d::cellHash(col + row * width, this->at(row, col));
+					}
+				}
+			}
+			h.fetch_add(partial, std::memory_order_relaxed);
+		});
+		return static_cast<std::size_t>(h.load(std::memory_order_relaxed));
+	}
+
+	/**
+	 * Given hash, the hash of this grid, returns its hash once the element at x, y changes from before to after.
+	 * O(1), so a search editing a grid in place can keep the hash of every state without rehashing it.
 	 */
-	friend struct std::hash<Vec2D<T>>;
+	[[nodiscard]] std::size_t updateHash(std::size_t hash, std::size_t x, std::size_t y, const T& before, const T& after) const noexcept
+	{
+		const std::size_t position = x + y * width;
+		return static_cast<std::size_t>(hash - vec2d::cellHash(position, before) + vec2d::cellHash(position, after));
+	}
 
 private:
+	template <bool IsConst>
+	class LayoutIterator
+	{
+		using Grid = std::conditional_t<IsConst, const Vec2D, Vec2D>;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<IsConst, const T*, T*>;
+		using reference = std::conditional_t<IsConst, const T&, T&>;
+
+		LayoutIterator() noexcept = default;
+
+		LayoutIterator(Grid* grid, std::size_t index) noexcept
+			: grid{ grid }
+			, index{ index }
+		{
+		}
+
+		/**
+		 * Allow iterator -> const_iterator.
+		 */
+		template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+		LayoutIterator(const LayoutIterator<OtherConst>& other) noexcept
+			: grid{ other.grid }
+			, index{ other.index }
+		{
+		}
+
+		reference operator*() const { return grid->at(index / grid->width, index % grid->width); }
+		pointer operator->() const { return &**this; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		LayoutIterator& operator++() noexcept { ++index; return *this; }
+		LayoutIterator& operator--() noexcept { --index; return *this; }
+		LayoutIterator operator++(int) noexcept { auto old = *this; ++index; return old; }
+		LayoutIterator operator--(int) noexcept { auto old = *this; --index; return old; }
+
+		LayoutIterator& operator+=(difference_type n) noexcept { index += n; return *this; }
+		LayoutIterator& operator-=(difference_type n) noexcept { index -= n; return *this; }
+
+		friend LayoutIterator operator+(LayoutIterator it, difference_type n) noexcept { return it += n; }
+		friend LayoutIterator operator+(difference_type n, LayoutIterator it) noexcept { return it += n; }
+		friend LayoutIterator operator-(LayoutIterator it, difference_type n) noexcept { return it -= n; }
+
+		friend difference_type operator-(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept
+		{
+			return static_cast<difference_type>(lhs.index) - static_cast<difference_type>(rhs.index);
+		}
+
+		friend bool operator==(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept { return lhs.index == rhs.index; }
+		friend bool operator!=(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept { return lhs.index != rhs.index; }
+		friend bool operator<(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept { return lhs.index < rhs.index; }
+		friend bool operator>(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept { return lhs.index > rhs.index; }
+		friend bool operator<=(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept { return lhs.index <= rhs.index; }
+		friend bool operator>=(const LayoutIterator& lhs, const LayoutIterator& rhs) noexcept { return lhs.index >= rhs.index; }
+
+	private:
+		friend class LayoutIterator<!IsConst>;
+
+		Grid* grid = nullptr;
+		std::size_t index = 0;	///< Row-major position.
+	};
+
+	static std::size_t widest(const std::vector<std::vector<T>>& rows)
+	{
+		return std::accumulate(rows.begin(), rows.end(), std::size_t{ 0 }, [](std::size_t a, const auto& b) { return std::max(a, b.size()); });
+	}
+
+	/**
+	 * Copies rows into the ( unwritten ) elements, or moves them out when given an rvalue, padding short rows with T{}.
+	 */
+	template <typename Rows>
+	void takeRows(Rows&& rows)
+	{
+		constexpr bool consume = !std::is_const_v<std::remove_reference_t<Rows>>;
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			auto& row = rows[y];
+			if constexpr (Layout::IsRowMajor)
+			{
+				T* out = data.data() + y * width;
+				if constexpr (consume)
+					std::move(row.begin(), row.end(), out);
+				else
+					std::copy(row.begin(), row.end(), out);
+				std::fill(out + row.size(), out + width, T{});
+			}
+			else
+			{
+				for (std::size_t x = 0; x < width; ++x)
+				{
+					if (x >= row.size())
+						this->at(y, x) = T{};
+					else if constexpr (consume)
+						this->at(y, x) = std::move(row[x]);
+					else
+						this->at(y, x) = row[x];
+				}
+			}
+
+			if constexpr (consume)
+				std::vector<T>().swap(row);
+		}
+	}
+
+	/**
+	 * Calls f( rowBegin, rowEnd ) on blocks of rows, in parallel unless Policy is sequenced.
+	 */
+	template <typename Policy, typename F>
+	void forRows(F&& f) const
+	{
+		if constexpr (!parallel::IsParallelPolicy<Policy>)
+		{
+			f(std::size_t{ 0 }, height);
+		}
+		else
+		{
+			// Blocks start on a multiple of the layout's row alignment, so they never share a run
+			const std::size_t grain = (parallel::rowGrain(width) + Layout::RowAlignment - 1) / Layout::RowAlignment * Layout::RowAlignment;
+			parallel::forBlocks(true, height, grain, f);
+		}
+	}
+
+	/**
+	 * Calls f( begin, end ) on contiguous storage ranges covering every element ( never padding ),
+	 * in parallel unless Policy is sequenced. Grids of equal dimensions and layout get the same ranges.
+	 */
+	template <typename Policy, typename F>
+	void forRowBlocks(F&& f) const
+	{
+		this->forRows<Policy>([&](std::size_t rowBegin, std::size_t rowEnd)
+		{
+			Layout::forEachRun(width, height, rowBegin, rowEnd, [&](std::size_t offset, std::size_t length)
+			{
+				f(offset, offset + length);
+			});
+		});
+	}
+
+	/**
+	 * Row-major index of the first element equal to value in rows [rowBegin, rowEnd), or width * height.
+	 */
+	std::size_t findInRows(const T& value, std::size_t rowBegin, std::size_t rowEnd) const
+	{
+		if constexpr (Layout::IsRowMajor)
+		{
+			const auto begin = data.begin() + rowBegin * width;
+			const auto it = std::find(begin, data.begin() + rowEnd * width, value);
+			return it == data.begin() + rowEnd * width ? width * height : static_cast<std::size_t>(std::distance(data.begin(), it));
+		}
+		else
+		{
+			for (std::size_t row = rowBegin; row < rowEnd; ++row)
+			{
+				for (std::size_t col = 0; col < width; ++col)
+				{
+					if (this->at(row, col) == value)
+						return col + row * width;
+				}
+			}
+			return width * height;
+		}
+	}
+
+	template <typename Element, typename Grid, typename F>
+	static void visitTiles(Grid& grid, F& f)
+	{
+		static_assert(Layout::StridedTiles, "This layout has no strided tiles");
+
+		for (std::size_t y = 0; y < grid.height; y += Layout::TileHeight)
+		{
+			for (std::size_t x = 0; x < grid.width; x += Layout::TileWidth)
+			{
+				f(Vec2DTile<Element>{ x, y,
+					std::min(Layout::TileWidth, grid.width - x),
+					std::min(Layout::TileHeight, grid.height - y),
+					Layout::tileStride(grid.width),
+					grid.data.data() + Layout::tileOffset(x, y, grid.width, grid.height) });
+			}
+		}
+	}
+
+	/**
+	 * Whether expression E addresses its elements by the storage index of this grid, i.e. shares its layout.
+	 */
+	template <typename E>
+	static constexpr bool SharesLayout = std::is_same_v<typename E::layout_type, Layout>;
+
+	/**
+	 * The fused loop every expression is evaluated in.
+	 * Expressions of another layout ( e.g. views, always row-major ) are evaluated by position instead.
+	 */
+	template <typename E>
+	void assign(const E& expr)
+	{
+		this->update(expr, [](const T&, const auto& b) { return b; });
+	}
+
+	template <typename E, typename Op>
+	Vec2D& update(const E& expr, Op op)
+	{
+		assert(expr.dim() == this->dim());
+
+		if constexpr (SharesLayout<E>)
+		{
+			T* out = data.data();
+			this->forRowBlocks<std::execution::sequenced_policy>([&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+					out[i] = static_cast<T>(op(out[i], expr.element(i)));
+			});
+		}
+		else
+		{
+			for (std::size_t row = 0; row < height; ++row)
+			{
+				for (std::size_t col = 0; col < width; ++col)
+				{
+					T& out = this->at(row, col);
+					out = static_cast<T>(op(out, expr.at(row, col)));
+				}
+			}
+		}
+		return *this;
+	}
+
+	/**
+	 * Run an element-wise kernel with another 2D vector as second operand, one row block at a time.
+	 */
+	template <simd::Op op, typename Policy = std::execution::sequenced_policy>
+	Vec2D& apply(const Vec2D& other)
+	{
+		assert(this->width == other.width && this->height == other.height);
+		T* out = data.data();
+		const T* in = other.data.data();
+		this->forRowBlocks<Policy>([&](std::size_t begin, std::size_t end)
+		{
+			simd::run<op>(out + begin, out + begin, in + begin, T{}, T{}, end - begin);
+		});
+		return *this;
+	}
+
+	/**
+	 * Run an element-wise kernel with scalar operands.
+	 */
+	template <simd::Op op>
+	Vec2D& apply(const T& s0, const T& s1 = T{})
+	{
+		T* out = data.data();
+		this->forRowBlocks<std::execution::sequenced_policy>([&](std::size_t begin, std::size_t end)
+		{
+			simd::run<op>(out + begin, out + begin, static_cast<const T*>(nullptr), s0, s1, end - begin);
+		});
+		return *this;
+	}
+
 	std::size_t width;  	///< Width of the 2D vector.
 	std::size_t height; 	///< Height of the 2D vector.
-	std::vector<T> data;	///< Underlying collection.
+	container_type data;	///< Underlying collection.
 
 };
 
-template <typename T>
-struct std::hash<Vec2D<T>>
+template <typename T, typename Layout, typename Storage>
+struct std::hash<Vec2D<T, Layout, Storage>>
 {
-	std::size_t operator()(const Vec2D<T>& vec) const
+	std::size_t operator()(const Vec2D<T, Layout, Storage>& vec) const
 	{
-		std::size_t h = 0;
-		for (const auto& element : vec.data)
-		{
-			h ^= std::hash<T>()(element);
-		}
-		return h;
+		return vec.hash(std::execution::seq);
 	}
 };
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "Vec2DLayout.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+////////////////////////
+/// VECTOR2D EXPRESSIONS
+////////////////////////
+
+/**
+ * Arithmetic on Vec2D builds lightweight expression nodes instead of temporary grids.
+ * Nothing is computed until the expression is assigned to a Vec2D, which then evaluates
+ * the whole expression element by element in a single loop, with no intermediate allocations.
+ *
+ * Grids used as lvalues are referenced, so they must outlive the expression.
+ * Temporaries are moved into the expression and live as long as it does.
+ * Every grid in an expression shares one layout, elements are addressed by their storage index.
+ * Assigning to a grid or view of another layout evaluates the expression by position instead.
+ */
+template <typename E>
+class Vec2DExpression
+{
+public:
+	[[nodiscard]] const E& derived() const noexcept
+	{
+		return static_cast<const E&>(*this);
+	}
+
+	/**
+	 * Evaluates the element at row, column.
+	 */
+	[[nodiscard]] auto at(std::size_t row, std::size_t col) const
+	{
+		const auto [width, height] = derived().dim();
+		assert(row < height && col < width); // In range check (Only for debug mode)
+		return derived().element(E::layout_type::index(col, row, width, height));
+	}
+
+	/**
+	 * Evaluates the element at x, y.
+	 */
+	[[nodiscard]] auto operator()(std::size_t x, std::size_t y) const
+	{
+		return this->at(y, x);
+	}
+};
+
+/**
+ * Whether X ( after decay ) is a Vec2D or an expression, i.e. something arithmetic builds nodes from.
+ */
+template <typename X>
+struct IsVec2DOperand : std::is_base_of<Vec2DExpression<X>, X>
+{
+};
+
+template <typename T, typename Layout, typename Storage>
+struct IsVec2DOperand<Vec2D<T, Layout, Storage>> : std::true_type
+{
+};
+
+template <typename X>
+inline constexpr bool IsVec2DOperandV = IsVec2DOperand<std::decay_t<X>>::value;
+
+/**
+ * A grid at the leaves of an expression, either referenced ( lvalues ) or owned ( temporaries ).
+ */
+template <typename T, typename Layout, typename Storage, bool Owning>
+class Vec2DLeaf : public Vec2DExpression<Vec2DLeaf<T, Layout, Storage, Owning>>
+{
+public:
+	using value_type = T;
+	using layout_type = Layout;
+
+	explicit Vec2DLeaf(const Vec2D<T, Layout, Storage>& grid) noexcept
+		: grid{ &grid }
+	{
+	}
+
+	explicit Vec2DLeaf(Vec2D<T, Layout, Storage>&& grid) noexcept
+		: grid{ std::move(grid) }
+	{
+	}
+
+	[[nodiscard]] const T& element(std::size_t i) const noexcept
+	{
+		if constexpr (Owning)
+			return grid.getData()[i];
+		else
+			return grid->getData()[i];
+	}
+
+	[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const
+	{
+		if constexpr (Owning)
+			return grid.dim();
+		else
+			return grid->dim();
+	}
+
+private:
+	std::conditional_t<Owning, Vec2D<T, Layout, Storage>, const Vec2D<T, Layout, Storage>*> grid;
+};
+
+/**
+ * A scalar broadcast to every element.
+ */
+template <typename T>
+class Vec2DScalar : public Vec2DExpression<Vec2DScalar<T>>
+{
+public:
+	using value_type = T;
+	using layout_type = void;	///< Takes the layout of the other operand.
+
+	explicit Vec2DScalar(T value) noexcept(std::is_nothrow_move_constructible_v<T>)
+		: value{ std::move(value) }
+	{
+	}
+
+	[[nodiscard]] const T& element(std::size_t) const noexcept
+	{
+		return value;
+	}
+
+private:
+	T value;
+};
+
+/**
+ * An element-wise operation on two nodes ( at most one of which is a scalar ).
+ */
+template <typename Op, typename L, typename R>
+class Vec2DBinary : public Vec2DExpression<Vec2DBinary<Op, L, R>>
+{
+	template <typename X>
+	static constexpr bool IsScalar = std::is_same_v<X, Vec2DScalar<typename X::value_type>>;
+
+public:
+	using value_type = typename std::conditional_t<IsScalar<L>, R, L>::value_type;
+	using layout_type = typename std::conditional_t<IsScalar<L>, R, L>::layout_type;
+
+	static_assert(IsScalar<L> || IsScalar<R> || std::is_same_v<typename L::layout_type, typename R::layout_type>,
+		"Grids in an expression must share a layout");
+
+	Vec2DBinary(L lhs, R rhs)
+		: lhs{ std::move(lhs) }
+		, rhs{ std::move(rhs) }
+	{
+		if constexpr (!IsScalar<L> && !IsScalar<R>)
+			assert(this->lhs.dim() == this->rhs.dim());
+	}
+
+	[[nodiscard]] value_type element(std::size_t i) const
+	{
+		return static_cast<value_type>(Op{}(lhs.element(i), rhs.element(i)));
+	}
+
+	[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const
+	{
+		if constexpr (IsScalar<L>)
+			return rhs.dim();
+		else
+			return lhs.dim();
+	}
+
+private:
+	L lhs;
+	R rhs;
+};
+
+/**
+ * Turns an operand into an expression node. Scalars take the element type of the other operand.
+ */
+template <typename Value, typename X>
+auto makeVec2DNode(X&& operand)
+{
+	using D = std::decay_t<X>;
+
+	if constexpr (!IsVec2DOperandV<X>)
+		return Vec2DScalar<Value>(static_cast<Value>(std::forward<X>(operand)));
+	else if constexpr (std::is_base_of_v<Vec2DExpression<D>, D>)
+		return D(std::forward<X>(operand));
+	else if constexpr (std::is_lvalue_reference_v<X>)
+		return Vec2DLeaf<typename D::value_type, typename D::layout_type, typename D::container_type, false>(operand);
+	else
+		return Vec2DLeaf<typename D::value_type, typename D::layout_type, typename D::container_type, true>(std::move(operand));
+}
+
+/**
+ * The element type of whichever operand is a grid or expression.
+ */
+template <typename L, typename R>
+using Vec2DValueType = typename std::decay_t<std::conditional_t<IsVec2DOperandV<L>, L, R>>::value_type;
+
+/**
+ * Arithmetic is only built from a grid / expression and either another one or a scalar of a convertible type.
+ */
+template <typename L, typename R>
+using EnableVec2DArithmetic = std::enable_if_t<
+	(IsVec2DOperandV<L> && IsVec2DOperandV<R>)
+	|| (IsVec2DOperandV<L> && std::is_convertible_v<R, Vec2DValueType<L, R>>)
+	|| (IsVec2DOperandV<R> && std::is_convertible_v<L, Vec2DValueType<L, R>>)>;
+
+template <typename Op, typename L, typename R>
+auto makeVec2DBinary(L&& lhs, R&& rhs)
+{
+	using Value = Vec2DValueType<L, R>;
+	auto left = makeVec2DNode<Value>(std::forward<L>(lhs));
+	auto right = makeVec2DNode<Value>(std::forward<R>(rhs));
+	return Vec2DBinary<Op, decltype(left), decltype(right)>(std::move(left), std::move(right));
+}
+
+/**
+ * Return the ( lazy ) summation of two 2D vectors, or of a 2D vector and a value.
+ */
+template <typename L, typename R, typename = EnableVec2DArithmetic<L, R>>
+auto operator+(L&& lhs, R&& rhs)
+{
+	return makeVec2DBinary<std::plus<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * Return the ( lazy ) subtraction result of two 2D vectors, or of a 2D vector and a value.
+ */
+template <typename L, typename R, typename = EnableVec2DArithmetic<L, R>>
+auto operator-(L&& lhs, R&& rhs)
+{
+	return makeVec2DBinary<std::minus<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * Return the ( lazy ) element-wise product of two 2D vectors, or of a 2D vector and a value.
+ */
+template <typename L, typename R, typename = EnableVec2DArithmetic<L, R>>
+auto operator*(L&& lhs, R&& rhs)
+{
+	return makeVec2DBinary<std::multiplies<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * Return the ( lazy ) element-wise quotient of two 2D vectors, or of a 2D vector and a value.
+ */
+template <typename L, typename R, typename = EnableVec2DArithmetic<L, R>>
+auto operator/(L&& lhs, R&& rhs)
+{
+	return makeVec2DBinary<std::divides<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
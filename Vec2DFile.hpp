@@ -0,0 +1,527 @@
+#pragma once
+
+#include "BlockCompression.hpp"
+#include "Parallel.hpp"
+#include "Vec2D.hpp"
+#include "Vec2DLayout.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+////////////////////////
+/// VECTOR2D FILES
+////////////////////////
+
+/**
+ * The on-disk format of a grid: a fixed 64 byte header followed, at dataOffset, by the elements
+ * in storage order ( layout padding included ). Fields and elements are in the byte order of the
+ * writer, which byteOrder records so readers can tell.
+ *
+ * The payload is either the raw elements, which can be mapped ( see MappedVec2D.hpp ) or sent
+ * with sendfile as they are, or ( Compressed ) a sequence of independently compressed blocks.
+ * save() and load() move the payload in bulk, never element by element.
+ */
+namespace vec2d
+{
+	struct FileHeader
+	{
+		static constexpr char Magic[4] = { 'V', '2', 'D', 'G' };
+		static constexpr std::uint16_t NativeOrder = 0x0102;
+		static constexpr std::uint16_t CurrentVersion = 1;
+
+		static constexpr std::uint32_t Checksummed = 1;	///< checksum holds the Checksum of the raw elements.
+		static constexpr std::uint32_t Compressed = 2;	///< The payload is compressed blocks.
+
+		char magic[4];					///< Always Magic.
+		std::uint16_t byteOrder;		///< NativeOrder as the writer stored it.
+		std::uint16_t version;			///< Format version.
+		std::uint32_t elementType;		///< See elementTypeTag().
+		std::uint32_t elementSize;		///< sizeof( T ).
+		std::uint32_t layout;			///< See LayoutTag.
+		std::uint32_t tileWidth;		///< Tile width of Tiled layouts, 0 otherwise.
+		std::uint32_t tileHeight;		///< Tile height of Tiled layouts, 0 otherwise.
+		std::uint32_t flags;			///< Checksummed, Compressed.
+		std::uint64_t width;			///< Width of the grid.
+		std::uint64_t height;			///< Height of the grid.
+		std::uint64_t dataOffset;		///< Bytes from the start of the file to the first element.
+		std::uint64_t checksum;			///< See Checksummed.
+	};
+
+	static_assert(sizeof(FileHeader) == 64 && std::is_trivially_copyable_v<FileHeader>, "The header is a fixed 64 byte block");
+
+	/**
+	 * Identifies arithmetic element types by kind and size, other trivially copyable types are 0 ( only their size is checked ).
+	 */
+	template <typename T>
+	constexpr std::uint32_t elementTypeTag() noexcept
+	{
+		if constexpr (std::is_floating_point_v<T>)
+			return 0x300 | sizeof(T);
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+			return 0x100 | sizeof(T);
+		else if constexpr (std::is_integral_v<T>)
+			return 0x200 | sizeof(T);
+		else
+			return 0;
+	}
+
+	template <typename Layout>
+	struct LayoutTag;
+
+	template <>
+	struct LayoutTag<RowMajor>
+	{
+		static constexpr std::uint32_t Value = 1;
+		static constexpr std::uint32_t TileWidth = 0;
+		static constexpr std::uint32_t TileHeight = 0;
+	};
+
+	template <std::size_t Width, std::size_t Height>
+	struct LayoutTag<Tiled<Width, Height>>
+	{
+		static constexpr std::uint32_t Value = 2;
+		static constexpr std::uint32_t TileWidth = Width;
+		static constexpr std::uint32_t TileHeight = Height;
+	};
+
+	template <>
+	struct LayoutTag<Morton>
+	{
+		static constexpr std::uint32_t Value = 3;
+		static constexpr std::uint32_t TileWidth = 0;
+		static constexpr std::uint32_t TileHeight = 0;
+	};
+
+	/**
+	 * The header of a width x height grid of T in Layout, elements right after it.
+	 */
+	template <typename T, typename Layout>
+	FileHeader makeHeader(std::size_t width, std::size_t height) noexcept
+	{
+		FileHeader header{};
+		std::memcpy(header.magic, FileHeader::Magic, sizeof(header.magic));
+		header.byteOrder = FileHeader::NativeOrder;
+		header.version = FileHeader::CurrentVersion;
+		header.elementType = elementTypeTag<T>();
+		header.elementSize = sizeof(T);
+		header.layout = LayoutTag<Layout>::Value;
+		header.tileWidth = LayoutTag<Layout>::TileWidth;
+		header.tileHeight = LayoutTag<Layout>::TileHeight;
+		header.width = width;
+		header.height = height;
+		header.dataOffset = sizeof(FileHeader);
+		return header;
+	}
+
+
+	/**
+	 * Throws std::runtime_error unless header describes a grid of T in Layout, written on a machine of the same byte order.
+	 */
+	template <typename T, typename Layout>
+	void checkHeader(const FileHeader& header)
+	{
+		if (std::memcmp(header.magic, FileHeader::Magic, sizeof(header.magic)) != 0)
+			throw std::runtime_error("Not a grid file");
+		if (header.byteOrder != FileHeader::NativeOrder)
+			throw std::runtime_error("Grid file has a different byte order");
+		if (header.version > FileHeader::CurrentVersion)
+			throw std::runtime_error("Grid file version is not supported");
+		if (header.elementType != elementTypeTag<T>() || header.elementSize != sizeof(T))
+			throw std::runtime_error("Grid file holds another element type");
+		if (header.layout != LayoutTag<Layout>::Value || header.tileWidth != LayoutTag<Layout>::TileWidth || header.tileHeight != LayoutTag<Layout>::TileHeight)
+			throw std::runtime_error("Grid file has another layout");
+		if (header.dataOffset < sizeof(FileHeader) || header.dataOffset % alignof(T) != 0)
+			throw std::runtime_error("Grid file has an invalid data offset");
+
+		// Far enough from overflowing once padded and counted in bytes
+		constexpr std::uint64_t MaxElements = std::uint64_t{ 1 } << 48;
+		if (header.width > MaxElements || header.height > MaxElements / std::max<std::uint64_t>(header.width, 1))
+			throw std::runtime_error("Grid file dimensions are invalid");
+	}
+
+	/**
+	 * Size of the raw elements of the grid header describes, in bytes.
+	 */
+	template <typename T, typename Layout>
+	std::size_t payloadBytes(const FileHeader& header) noexcept
+	{
+		return Layout::size(static_cast<std::size_t>(header.width), static_cast<std::size_t>(header.height)) * sizeof(T);
+	}
+
+	template <typename U>
+	U byteSwap(U value) noexcept
+	{
+		static_assert(std::is_trivially_copyable_v<U>);
+
+		auto* bytes = reinterpret_cast<std::byte*>(&value);
+		std::reverse(bytes, bytes + sizeof(U));
+		return value;
+	}
+
+	/**
+	 * Converts a header written on a machine of the other byte order.
+	 */
+	inline void byteSwap(FileHeader& header) noexcept
+	{
+		header.byteOrder = byteSwap(header.byteOrder);
+		header.version = byteSwap(header.version);
+		header.elementType = byteSwap(header.elementType);
+		header.elementSize = byteSwap(header.elementSize);
+		header.layout = byteSwap(header.layout);
+		header.tileWidth = byteSwap(header.tileWidth);
+		header.tileHeight = byteSwap(header.tileHeight);
+		header.flags = byteSwap(header.flags);
+		header.width = byteSwap(header.width);
+		header.height = byteSwap(header.height);
+		header.dataOffset = byteSwap(header.dataOffset);
+		header.checksum = byteSwap(header.checksum);
+	}
+
+	/**
+	 * The 64-bit XXH64 hash ( seed 0 ) of n bytes, a checksum running at several bytes per cycle.
+	 */
+	inline std::uint64_t checksum(const std::byte* data, std::size_t n) noexcept
+	{
+		constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+		constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ull;
+		constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+		const auto rotl = [](std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+		const auto mix = [&](std::uint64_t acc, std::uint64_t input) { return rotl(acc + input * Prime2, 31) * Prime1; };
+		const auto merge = [&](std::uint64_t acc, std::uint64_t lane) { return (acc ^ mix(0, lane)) * Prime1 + Prime4; };
+
+		// Lanes are read little-endian whatever the machine, so the sum does not depend on it
+		const auto read = [](const std::byte* p, auto lane)
+		{
+			std::memcpy(&lane, p, sizeof(lane));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			lane = byteSwap(lane);
+#endif
+			return static_cast<std::uint64_t>(lane);
+		};
+		const auto read64 = [&](const std::byte* p) { return read(p, std::uint64_t{}); };
+		const auto read32 = [&](const std::byte* p) { return read(p, std::uint32_t{}); };
+
+		const std::byte* p = data;
+		const std::byte* const end = data + n;
+		std::uint64_t h;
+
+		if (n >= 32)
+		{
+			std::uint64_t v1 = Prime1 + Prime2;
+			std::uint64_t v2 = Prime2;
+			std::uint64_t v3 = 0;
+			std::uint64_t v4 = 0 - Prime1;
+			for (; end - p >= 32; p += 32)
+			{
+				v1 = mix(v1, read64(p));
+				v2 = mix(v2, read64(p + 8));
+				v3 = mix(v3, read64(p + 16));
+				v4 = mix(v4, read64(p + 24));
+			}
+
+			h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+			h = merge(h, v1);
+			h = merge(h, v2);
+			h = merge(h, v3);
+			h = merge(h, v4);
+		}
+		else
+		{
+			h = Prime5;
+		}
+
+		h += n;
+		for (; end - p >= 8; p += 8)
+			h = rotl(h ^ mix(0, read64(p)), 27) * Prime1 + Prime4;
+		if (end - p >= 4)
+		{
+			h = rotl(h ^ (read32(p) * Prime1), 23) * Prime2 + Prime3;
+			p += 4;
+		}
+		for (; p != end; ++p)
+			h = rotl(h ^ (static_cast<std::uint64_t>(*p) * Prime5), 11) * Prime1;
+
+		h ^= h >> 33;
+		h *= Prime2;
+		h ^= h >> 29;
+		h *= Prime3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	/**
+	 * How save() stores the payload.
+	 */
+	enum class Compression
+	{
+		None,		///< The raw elements, as fast as the disk and mappable.
+		Lz			///< Blocks of the LZ codec ( see BlockCompression.hpp ), for grids with runs and repeats.
+	};
+
+	/**
+	 * Compressed payloads are cut in blocks of this many raw bytes, compressed independently ( and in parallel ).
+	 */
+	inline constexpr std::size_t CompressionBlockSize = std::size_t{ 1 } << 20;
+
+	/**
+	 * Set in a block's size word when the block did not compress and is stored raw.
+	 */
+	inline constexpr std::uint32_t RawBlock = 0x80000000u;
+
+	using ByteBuffer = std::vector<std::byte, DefaultInitAllocator<std::byte>>;
+
+	/**
+	 * Writes n bytes as compressed blocks, each a 32-bit size word followed by the block.
+	 */
+	inline void writeCompressed(std::ostream& out, const std::byte* payload, std::size_t n)
+	{
+		const std::size_t blocks = (n + CompressionBlockSize - 1) / CompressionBlockSize;
+		const std::size_t batch = parallel::ThreadPool::instance().size() * 2;
+		std::vector<ByteBuffer> buffers(std::min(batch, blocks));
+
+		for (std::size_t first = 0; first < blocks; first += batch)
+		{
+			const std::size_t count = std::min(batch, blocks - first);
+			parallel::forBlocks(true, count, 1, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					const std::size_t offset = (first + i) * CompressionBlockSize;
+					const std::size_t size = std::min(CompressionBlockSize, n - offset);
+
+					auto& buffer = buffers[i];
+					buffer.resize(sizeof(std::uint32_t) + lz::compressBound(size));
+					std::size_t stored = lz::compress(payload + offset, size, buffer.data() + sizeof(std::uint32_t));
+					std::uint32_t word = static_cast<std::uint32_t>(stored);
+					if (stored >= size)
+					{
+						std::memcpy(buffer.data() + sizeof(std::uint32_t), payload + offset, size);
+						stored = size;
+						word = static_cast<std::uint32_t>(size) | RawBlock;
+					}
+
+					std::memcpy(buffer.data(), &word, sizeof(word));
+					buffer.resize(sizeof(word) + stored);
+				}
+			});
+
+			for (std::size_t i = 0; i < count; ++i)
+				out.write(reinterpret_cast<const char*>(buffers[i].data()), static_cast<std::streamsize>(buffers[i].size()));
+		}
+	}
+
+	/**
+	 * Reads the compressed blocks of n raw bytes into payload.
+	 */
+	inline void readCompressed(std::istream& in, std::byte* payload, std::size_t n, bool swapped)
+	{
+		const std::size_t blocks = (n + CompressionBlockSize - 1) / CompressionBlockSize;
+		const std::size_t batch = parallel::ThreadPool::instance().size() * 2;
+		std::vector<ByteBuffer> buffers(std::min(batch, blocks));
+
+		for (std::size_t first = 0; first < blocks; first += batch)
+		{
+			// Reading is sequential, decompressing the batch is not
+			const std::size_t count = std::min(batch, blocks - first);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const std::size_t offset = (first + i) * CompressionBlockSize;
+				const std::size_t size = std::min(CompressionBlockSize, n - offset);
+
+				std::uint32_t word = 0;
+				if (!in.read(reinterpret_cast<char*>(&word), sizeof(word)))
+					throw std::runtime_error("Grid file is truncated");
+				if (swapped)
+					word = byteSwap(word);
+
+				const std::size_t stored = word & ~RawBlock;
+				auto& buffer = buffers[i];
+				if ((word & RawBlock) != 0)
+				{
+					if (stored != size)
+						throw std::runtime_error("Corrupt compressed block");
+					in.read(reinterpret_cast<char*>(payload + offset), static_cast<std::streamsize>(size));
+					buffer.clear();
+				}
+				else
+				{
+					if (stored == 0 || stored > lz::compressBound(size))
+						throw std::runtime_error("Corrupt compressed block");
+					buffer.resize(stored);
+					in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(stored));
+				}
+
+				if (!in)
+					throw std::runtime_error("Grid file is truncated");
+			}
+
+			parallel::forBlocks(true, count, 1, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					const std::size_t offset = (first + i) * CompressionBlockSize;
+					if (!buffers[i].empty())
+						lz::decompress(buffers[i].data(), buffers[i].size(), payload + offset, std::min(CompressionBlockSize, n - offset));
+				}
+			});
+		}
+	}
+
+	/**
+	 * Fewest bytes a payload of n raw bytes can be stored in. A compressed block holds its size word, and
+	 * LZ sequences expand at most 255 fold ( a length byte of 255 ).
+	 */
+	inline std::uint64_t minimumStoredBytes(std::size_t n, bool compressed) noexcept
+	{
+		if (!compressed)
+			return n;
+
+		const std::size_t blocks = (n + CompressionBlockSize - 1) / CompressionBlockSize;
+		return blocks * sizeof(std::uint32_t) + n / 255;
+	}
+
+	/**
+	 * Bytes left to read in a seekable stream, or nothing for streams which cannot tell ( pipes, sockets ).
+	 */
+	inline std::optional<std::uint64_t> remainingBytes(std::istream& in)
+	{
+		const auto here = in.tellg();
+		if (here == std::istream::pos_type(-1))
+			return std::nullopt;
+
+		in.seekg(0, std::ios::end);
+		const auto end = in.tellg();
+		in.seekg(here);
+		if (end == std::istream::pos_type(-1) || !in)
+		{
+			in.clear();
+			in.seekg(here);
+			return std::nullopt;
+		}
+		return static_cast<std::uint64_t>(end - here);
+	}
+
+	/**
+	 * Writes a grid, checksummed, to a binary stream. Throws std::runtime_error if the stream fails.
+	 */
+	template <typename T, typename Layout, typename Storage>
+	void save(std::ostream& out, const Vec2D<T, Layout, Storage>& grid, Compression compression = Compression::None)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Grids are saved as raw bytes, T must be trivially copyable");
+
+		const auto [width, height] = grid.dim();
+		const auto* payload = reinterpret_cast<const std::byte*>(grid.getData().data());
+		const std::size_t n = grid.getData().size() * sizeof(T);
+
+		FileHeader header = makeHeader<T, Layout>(width, height);
+		header.flags = FileHeader::Checksummed | (compression == Compression::Lz ? FileHeader::Compressed : 0);
+		header.checksum = checksum(payload, n);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		if (compression == Compression::Lz)
+			writeCompressed(out, payload, n);
+		else
+			out.write(reinterpret_cast<const char*>(payload), static_cast<std::streamsize>(n));
+
+		if (!out)
+			throw std::runtime_error("Writing the grid failed");
+	}
+
+	/**
+	 * Writes a grid, checksummed, to a file ( created or truncated ).
+	 */
+	template <typename T, typename Layout, typename Storage>
+	void save(const std::string& path, const Vec2D<T, Layout, Storage>& grid, Compression compression = Compression::None)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("Cannot create " + path);
+
+		save(out, grid, compression);
+		out.close();
+		if (!out)
+			throw std::runtime_error("Writing the grid failed");
+	}
+
+	/**
+	 * Reads a grid of T in Layout from a binary stream, converting it if it was written with the other byte order.
+	 * Throws std::runtime_error if the stream holds another type or layout, is truncated, or fails its checksum.
+	 * Seekable streams are checked to hold the payload before the grid is allocated.
+	 * The elements are read into Storage( count ), which a std::vector<T> zero-fills first; loading into
+	 * the storage of a DefaultInitVec2D skips that pass, e.g. load<float, RowMajor, DefaultInitStorage<float>>( in ).
+	 */
+	template <typename T, typename Layout = RowMajor, typename Storage = std::vector<T>>
+	Vec2D<T, Layout, Storage> load(std::istream& in)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Grids are loaded as raw bytes, T must be trivially copyable");
+
+		FileHeader header;
+		if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			throw std::runtime_error("Not a grid file");
+
+		const bool swapped = header.byteOrder == byteSwap(FileHeader::NativeOrder);
+		if (swapped)
+		{
+			// Arithmetic elements convert by reversing their bytes, other types have no known layout
+			if (elementTypeTag<T>() == 0 && sizeof(T) > 1)
+				throw std::runtime_error("Grid file has a different byte order");
+			byteSwap(header);
+		}
+		checkHeader<T, Layout>(header);
+		if (!in.ignore(static_cast<std::streamsize>(header.dataOffset - sizeof(header))) || in.eof())
+			throw std::runtime_error("Grid file is truncated");
+
+		// A header is not trusted with an allocation the stream cannot fill
+		const std::size_t n = payloadBytes<T, Layout>(header);
+		const bool compressed = (header.flags & FileHeader::Compressed) != 0;
+		if (const auto remaining = remainingBytes(in); remaining && *remaining < minimumStoredBytes(n, compressed))
+			throw std::runtime_error("Grid file is truncated");
+
+		const auto width = static_cast<std::size_t>(header.width);
+		const auto height = static_cast<std::size_t>(header.height);
+		Storage data(Layout::size(width, height));
+		auto* payload = reinterpret_cast<std::byte*>(data.data());
+
+		if (compressed)
+			readCompressed(in, payload, n, swapped);
+		else if (!in.read(reinterpret_cast<char*>(payload), static_cast<std::streamsize>(n)))
+			throw std::runtime_error("Grid file is truncated");
+
+		if ((header.flags & FileHeader::Checksummed) != 0 && checksum(payload, n) != header.checksum)
+			throw std::runtime_error("Grid file checksum mismatch");
+
+		if (swapped)
+		{
+			for (auto& element : data)
+				element = byteSwap(element);
+		}
+
+		return Vec2D<T, Layout, Storage>(adopt, width, height, std::move(data));
+	}
+
+	/**
+	 * Reads a grid of T in Layout from a file.
+	 */
+	template <typename T, typename Layout = RowMajor, typename Storage = std::vector<T>>
+	Vec2D<T, Layout, Storage> load(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			throw std::runtime_error("Cannot open " + path);
+
+		return load<T, Layout, Storage>(in);
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+////////////////////////
+/// VECTOR2D HASHING
+////////////////////////
+
+/**
+ * The hash of a grid is the sum ( mod 2^64 ) of a hash of its dimensions and of one well mixed
+ * hash per cell, keyed by the cell's row-major position. Keying by position means permuted or
+ * transposed grids hash apart, the sum means row blocks can be hashed in any order, on any thread,
+ * and a single cell change updates the hash in O(1): subtract the old cell, add the new one.
+ * Positions are logical, so equal grids hash equally whatever their layout.
+ */
+namespace vec2d
+{
+	inline constexpr std::uint64_t PositionKey = 0x9E3779B97F4A7C15ull;
+
+	/**
+	 * The murmur3 64-bit finalizer, a bijection where every input bit flips about half the output bits.
+	 */
+	constexpr std::uint64_t mix(std::uint64_t x) noexcept
+	{
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDull;
+		x ^= x >> 33;
+		x *= 0xC4CEB9FE1A85EC53ull;
+		x ^= x >> 33;
+		return x;
+	}
+
+	/**
+	 * Hash of an element before mixing. Arithmetic types use their value bits directly ( no call
+	 * to std::hash, so loops over them vectorize ), anything else goes through std::hash.
+	 */
+	template <typename T>
+	std::uint64_t elementHash(const T& value) noexcept
+	{
+		if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+		{
+			return static_cast<std::uint64_t>(value);
+		}
+		else if constexpr (std::is_floating_point_v<T> && sizeof(T) <= sizeof(std::uint64_t))
+		{
+			// + 0 turns -0 into 0, they compare equal so must hash equally
+			const T normalized = value + T{ 0 };
+			std::uint64_t bits = 0;
+			std::memcpy(&bits, &normalized, sizeof(T));
+			return bits;
+		}
+		else
+		{
+			return static_cast<std::uint64_t>(std::hash<T>()(value));
+		}
+	}
+
+	/**
+	 * Contribution of an element to the hash of its grid, at row-major position.
+	 */
+	template <typename T>
+	std::uint64_t cellHash(std::size_t position, const T& value) noexcept
+	{
+		return mix(elementHash(value) ^ (static_cast<std::uint64_t>(position) * PositionKey));
+	}
+
+	/**
+	 * Contribution of the dimensions, a 4x1 grid does not hash as its 1x4 transpose or a 2x2 one.
+	 */
+	constexpr std::uint64_t dimensionHash(std::size_t width, std::size_t height) noexcept
+	{
+		return mix(mix(static_cast<std::uint64_t>(width) + PositionKey) ^ static_cast<std::uint64_t>(height));
+	}
+
+	/**
+	 * Sum of the cell hashes of count contiguous elements, the first at row-major position first.
+	 */
+	template <typename T>
+	std::uint64_t hashCells(const T* elements, std::size_t first, std::size_t count) noexcept
+	{
+		std::uint64_t sum = 0;
+		for (std::size_t i = 0; i < count; ++i)
+			sum += cellHash(first + i, elements[i]);
+		return sum;
+	}
+}
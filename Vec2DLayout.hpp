@@ -0,0 +1,304 @@
+#pragma once
+
+#include "AlignedAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+////////////////////////
+/// VECTOR2D LAYOUTS
+////////////////////////
+
+/**
+ * Storage layouts for Vec2D, deciding where element x, y lives in the underlying collection.
+ *
+ * A layout is a stateless policy with:
+ *	- size( width, height ), the number of elements to store ( may include padding )
+ *	- index( x, y, width, height ), where element x, y is stored
+ *	- forEachRun( width, height, rowBegin, rowEnd, f ), calling f( offset, length ) for contiguous
+ *	  storage runs which together hold exactly the elements of rows [rowBegin, rowEnd), never padding
+ *	- RowAlignment, a row count parallel row blocks are rounded to so they do not split runs
+ *	- TileWidth / TileHeight / tileStride( width ) when tiles are strided 2D arrays ( StridedTiles )
+ */
+struct RowMajor;
+
+/**
+ * Storage is the contiguous container holding the elements, a std::vector by default
+ * ( see DefaultInitVec2D for storage leaving trivial elements uninitialized, MappedVec2D.hpp for file-backed storage ).
+ */
+template <typename T, typename Layout = RowMajor, typename Storage = std::vector<T>>
+class Vec2D;
+
+/**
+ * Storage which leaves trivial elements uninitialized until written.
+ */
+template <typename T>
+using DefaultInitStorage = std::vector<T, DefaultInitAllocator<T>>;
+
+/**
+ * A Vec2D over DefaultInitStorage, so vec2d::uninitialized grids skip the fill and policy-constructed
+ * grids are first touched by the threads which fill them.
+ */
+template <typename T, typename Layout = RowMajor>
+using DefaultInitVec2D = Vec2D<T, Layout, DefaultInitStorage<T>>;
+
+/**
+ * Rows one after another, data[x + y * width]. The default.
+ */
+struct RowMajor
+{
+	static constexpr bool IsRowMajor = true;
+	static constexpr bool StridedTiles = true;
+	static constexpr std::size_t RowAlignment = 1;
+
+	/**
+	 * Tiles are only a traversal order here, handed out as 64x64 windows on the rows.
+	 */
+	static constexpr std::size_t TileWidth = 64;
+	static constexpr std::size_t TileHeight = 64;
+
+	static constexpr std::size_t size(std::size_t width, std::size_t height) noexcept
+	{
+		return width * height;
+	}
+
+	static constexpr std::size_t index(std::size_t x, std::size_t y, std::size_t width, std::size_t) noexcept
+	{
+		return x + y * width;
+	}
+
+	static constexpr std::size_t tileOffset(std::size_t x, std::size_t y, std::size_t width, std::size_t height) noexcept
+	{
+		return index(x, y, width, height);
+	}
+
+	static constexpr std::size_t tileStride(std::size_t width) noexcept
+	{
+		return width;
+	}
+
+	template <typename F>
+	static void forEachRun(std::size_t width, std::size_t, std::size_t rowBegin, std::size_t rowEnd, F&& f)
+	{
+		if (rowBegin < rowEnd && width != 0)
+			f(rowBegin * width, (rowEnd - rowBegin) * width);
+	}
+};
+
+/**
+ * Square-ish tiles stored one after another ( row-major over tiles ), each tile row-major inside.
+ * A tile of 64x64 floats is 16 KiB, so a tile and its neighbour fit in L1 and column walks
+ * or 2D neighbourhoods stay within a handful of pages. Edge tiles are padded to the full size.
+ */
+template <std::size_t Width = 64, std::size_t Height = 64>
+struct Tiled
+{
+	static_assert(Width > 0 && (Width & (Width - 1)) == 0, "Tile width must be a power of two");
+	static_assert(Height > 0 && (Height & (Height - 1)) == 0, "Tile height must be a power of two");
+
+	static constexpr bool IsRowMajor = false;
+	static constexpr bool StridedTiles = true;
+	static constexpr std::size_t RowAlignment = Height;
+	static constexpr std::size_t TileWidth = Width;
+	static constexpr std::size_t TileHeight = Height;
+	static constexpr std::size_t TileSize = Width * Height;
+
+	static constexpr std::size_t tilesAcross(std::size_t width) noexcept
+	{
+		return (width + Width - 1) / Width;
+	}
+
+	static constexpr std::size_t size(std::size_t width, std::size_t height) noexcept
+	{
+		return tilesAcross(width) * ((height + Height - 1) / Height) * TileSize;
+	}
+
+	static constexpr std::size_t index(std::size_t x, std::size_t y, std::size_t width, std::size_t) noexcept
+	{
+		const std::size_t tile = (y / Height) * tilesAcross(width) + x / Width;
+		return tile * TileSize + (y % Height) * Width + x % Width;
+	}
+
+	static constexpr std::size_t tileOffset(std::size_t x, std::size_t y, std::size_t width, std::size_t height) noexcept
+	{
+		return index(x, y, width, height);
+	}
+
+	static constexpr std::size_t tileStride(std::size_t) noexcept
+	{
+		return Width;
+	}
+
+	template <typename F>
+	static void forEachRun(std::size_t width, std::size_t height, std::size_t rowBegin, std::size_t rowEnd, F&& f)
+	{
+		rowEnd = std::min(rowEnd, height);
+		for (std::size_t band = rowBegin / Height * Height; band < rowEnd; band += Height)
+		{
+			const std::size_t first = std::max(band, rowBegin);
+			const std::size_t last = std::min(band + Height, rowEnd);
+
+			for (std::size_t x = 0; x < width; x += Width)
+			{
+				const std::size_t columns = std::min(Width, width - x);
+
+				// Full width tiles hold their rows back to back
+				if (columns == Width)
+				{
+					f(index(x, first, width, height), (last - first) * Width);
+					continue;
+				}
+
+				for (std::size_t y = first; y < last; ++y)
+					f(index(x, y, width, height), columns);
+			}
+		}
+	}
+};
+
+/**
+ * Z-order: the bits of x and y interleaved, so every aligned power of two square is contiguous
+ * and nearby elements are nearby in memory in both directions, at every scale.
+ * Each dimension is padded to a power of two. Tiles are not strided, so no tile iteration.
+ */
+struct Morton
+{
+	static constexpr bool IsRowMajor = false;
+	static constexpr bool StridedTiles = false;
+	static constexpr std::size_t RowAlignment = 1;
+
+	static constexpr std::size_t size(std::size_t width, std::size_t height) noexcept
+	{
+		return width == 0 || height == 0 ? 0 : ceilPow2(width) * ceilPow2(height);
+	}
+
+	static constexpr std::size_t index(std::size_t x, std::size_t y, std::size_t width, std::size_t height) noexcept
+	{
+		// Interleave the low bits of both, the extra high bits of the longer side select a square block
+		const std::size_t side = std::min(ceilPow2(width), ceilPow2(height));
+		const std::size_t block = width > height ? x / side : y / side;
+		return block * side * side + interleave(x & (side - 1), y & (side - 1));
+	}
+
+	template <typename F>
+	static void forEachRun(std::size_t width, std::size_t height, std::size_t rowBegin, std::size_t rowEnd, F&& f)
+	{
+		rowEnd = std::min(rowEnd, height);
+		if (width == 0 || rowBegin >= rowEnd)
+			return;
+
+		const std::size_t side = std::min(ceilPow2(width), ceilPow2(height));
+		const std::size_t blocks = size(width, height) / (side * side);
+
+		for (std::size_t block = 0; block < blocks; ++block)
+		{
+			const std::size_t x = width > height ? block * side : 0;
+			const std::size_t y = width > height ? 0 : block * side;
+			quadRuns(x, y, side, block * side * side, width, rowBegin, rowEnd, f);
+		}
+	}
+
+private:
+	static constexpr std::size_t ceilPow2(std::size_t n) noexcept
+	{
+		std::size_t p = 1;
+		while (p < n)
+			p <<= 1;
+		return p;
+	}
+
+	/**
+	 * Spreads the bits of v apart ( bit i moves to bit 2i ).
+	 */
+	static constexpr std::uint64_t spread(std::uint64_t v) noexcept
+	{
+		v &= 0xFFFFFFFF;
+		v = (v | (v << 16)) & 0x0000FFFF0000FFFF;
+		v = (v | (v << 8)) & 0x00FF00FF00FF00FF;
+		v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0F;
+		v = (v | (v << 2)) & 0x3333333333333333;
+		v = (v | (v << 1)) & 0x5555555555555555;
+		return v;
+	}
+
+	static constexpr std::size_t interleave(std::size_t x, std::size_t y) noexcept
+	{
+		return static_cast<std::size_t>(spread(x) | (spread(y) << 1));
+	}
+
+	/**
+	 * Emits the runs of the side x side square at x, y ( stored from offset ) clipped to the wanted rows.
+	 * Squares entirely inside are a single run, so only the edges of the region are split further.
+	 */
+	template <typename F>
+	static void quadRuns(std::size_t x, std::size_t y, std::size_t side, std::size_t offset,
+		std::size_t width, std::size_t rowBegin, std::size_t rowEnd, F& f)
+	{
+		if (x >= width || y >= rowEnd || y + side <= rowBegin)
+			return;
+
+		if (x + side <= width && y >= rowBegin && y + side <= rowEnd)
+		{
+			f(offset, side * side);
+			return;
+		}
+
+		const std::size_t half = side / 2;
+		const std::size_t quarter = half * half;
+		quadRuns(x, y, half, offset, width, rowBegin, rowEnd, f);
+		quadRuns(x + half, y, half, offset + quarter, width, rowBegin, rowEnd, f);
+		quadRuns(x, y + half, half, offset + 2 * quarter, width, rowBegin, rowEnd, f);
+		quadRuns(x + half, y + half, half, offset + 3 * quarter, width, rowBegin, rowEnd, f);
+	}
+};
+
+/**
+ * One tile of a grid: a strided window of up to TileWidth x TileHeight elements at x, y.
+ * Handed out by Vec2D::forEachTile so kernels can work on one cache resident block at a time.
+ */
+template <typename T>
+struct Vec2DTile
+{
+	std::size_t x;		///< Column of the top left element in the grid.
+	std::size_t y;		///< Row of the top left element in the grid.
+	std::size_t width;	///< Columns in this tile ( edge tiles are narrower ).
+	std::size_t height;	///< Rows in this tile ( edge tiles are shorter ).
+	std::size_t stride;	///< Elements between the starts of two rows.
+	T* data;			///< The top left element.
+
+	/**
+	 * Allow tile -> const tile.
+	 */
+	template <typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+	operator Vec2DTile<const U>() const noexcept
+	{
+		return { x, y, width, height, stride, data };
+	}
+
+	/**
+	 * Returns the element at row, column of the tile.
+	 */
+	[[nodiscard]] T& at(std::size_t row, std::size_t col) const noexcept
+	{
+		return data[col + row * stride];
+	}
+
+	/**
+	 * Returns the element at x, y of the tile.
+	 */
+	[[nodiscard]] T& operator()(std::size_t col, std::size_t row) const noexcept
+	{
+		return data[col + row * stride];
+	}
+
+	/**
+	 * Returns the first element of a row of the tile, width elements follow contiguously.
+	 */
+	[[nodiscard]] T* row(std::size_t r) const noexcept
+	{
+		return data + r * stride;
+	}
+};
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "Simd.hpp"
+#include "Vec2DView.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+////////////////////////
+/// VECTOR2D TRANSFORMS
+////////////////////////
+
+/**
+ * Transposes, rotations and flips between views of row-major grids.
+ *
+ * Transposes ( and the rotations built on them ) recurse cache-obliviously, halving the longer
+ * side until a block fits in L1, where simd::transposeBlock moves it in register tiles.
+ * Rotations by 90 degrees are transposes with one side walked backwards, flips copy whole rows.
+ * Source and destination must not overlap, Vec2D has the in place versions.
+ */
+namespace vec2d
+{
+	/**
+	 * Side under which a block is transposed directly ( 32x32 floats are 4 KiB a side ).
+	 */
+	inline constexpr std::size_t TransposeBlockSide = 32;
+
+	template <typename T>
+	void transposeRecursive(const T* src, std::ptrdiff_t srcStride, T* dst, std::ptrdiff_t dstStride, std::size_t rows, std::size_t cols)
+	{
+		if (rows <= TransposeBlockSide && cols <= TransposeBlockSide)
+		{
+			simd::transposeBlock(src, srcStride, dst, dstStride, rows, cols);
+			return;
+		}
+
+		// Split the longer side, on a multiple of 16 so blocks stay made of whole register tiles
+		if (rows >= cols)
+		{
+			const std::size_t half = (rows / 2 + 15) / 16 * 16;
+			transposeRecursive(src, srcStride, dst, dstStride, half, cols);
+			transposeRecursive(src + static_cast<std::ptrdiff_t>(half) * srcStride, srcStride, dst + half, dstStride, rows - half, cols);
+		}
+		else
+		{
+			const std::size_t half = (cols / 2 + 15) / 16 * 16;
+			transposeRecursive(src, srcStride, dst, dstStride, rows, half);
+			transposeRecursive(src + half, srcStride, dst + static_cast<std::ptrdiff_t>(half) * dstStride, dstStride, rows, cols - half);
+		}
+	}
+
+	/**
+	 * Swaps the rows x cols block a with the transpose of the cols x rows block b.
+	 */
+	template <typename T>
+	void swapTransposed(T* a, T* b, std::size_t stride, std::size_t rows, std::size_t cols)
+	{
+		if (rows <= TransposeBlockSide && cols <= TransposeBlockSide)
+		{
+			// The copy lives on the stack, so larger elements are swapped directly
+			if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= 16)
+			{
+				// Through a cache resident copy, so both directions use the register tiles
+				T copy[TransposeBlockSide * TransposeBlockSide];
+				const auto s = static_cast<std::ptrdiff_t>(stride);
+				simd::transposeBlock(b, s, copy, static_cast<std::ptrdiff_t>(TransposeBlockSide), cols, rows);
+				simd::transposeBlock(static_cast<const T*>(a), s, b, s, rows, cols);
+				for (std::size_t r = 0; r < rows; ++r)
+					std::copy_n(copy + r * TransposeBlockSide, cols, a + r * stride);
+			}
+			else
+			{
+				for (std::size_t r = 0; r < rows; ++r)
+					for (std::size_t c = 0; c < cols; ++c)
+						std::swap(a[r * stride + c], b[c * stride + r]);
+			}
+			return;
+		}
+
+		if (rows >= cols)
+		{
+			const std::size_t half = rows / 2;
+			swapTransposed(a, b, stride, half, cols);
+			swapTransposed(a + half * stride, b + half, stride, rows - half, cols);
+		}
+		else
+		{
+			const std::size_t half = cols / 2;
+			swapTransposed(a, b, stride, rows, half);
+			swapTransposed(a + half, b + half * stride, stride, rows, cols - half);
+		}
+	}
+
+	/**
+	 * Transposes the n x n block at a in place.
+	 */
+	template <typename T>
+	void transposeSquare(T* a, std::size_t stride, std::size_t n)
+	{
+		if (n <= TransposeBlockSide)
+		{
+			for (std::size_t r = 0; r < n; ++r)
+				for (std::size_t c = r + 1; c < n; ++c)
+					std::swap(a[r * stride + c], a[c * stride + r]);
+			return;
+		}
+
+		// Transpose both diagonal blocks, swap the two others across the diagonal
+		const std::size_t half = n / 2;
+		transposeSquare(a, stride, half);
+		transposeSquare(a + half * stride + half, stride, n - half);
+		swapTransposed(a + half, a + half * stride, stride, half, n - half);
+	}
+
+	/**
+	 * Copies src into dst moving element x, y to where( x, y ), for views whose columns are not contiguous.
+	 */
+	template <typename S, typename T, typename Where>
+	void remap(const Vec2DView<S>& src, const Vec2DView<T>& dst, Where where)
+	{
+		const auto [width, height] = src.dim();
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			for (std::size_t x = 0; x < width; ++x)
+			{
+				const auto [toX, toY] = where(x, y);
+				dst(toX, toY) = src(x, y);
+			}
+		}
+	}
+
+	template <typename S, typename T>
+	void checkTransform(const Vec2DView<S>& src, const Vec2DView<T>& dst, bool swapsSides)
+	{
+		static_assert(std::is_same_v<std::remove_const_t<S>, T>, "Source and destination must hold the same type");
+
+		const auto [width, height] = src.dim();
+		const auto expected = swapsSides ? std::make_pair(height, width) : std::make_pair(width, height);
+		if (dst.dim() != expected)
+			throw std::invalid_argument("Destination has the wrong dimensions");
+	}
+
+	/**
+	 * dst( y, x ) = src( x, y ), dst must be height x width.
+	 */
+	template <typename S, typename T>
+	void transpose(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		checkTransform(src, dst, true);
+		const auto [width, height] = src.dim();
+
+		if (src.step() != 1 || dst.step() != 1)
+			return remap(src, dst, [](std::size_t x, std::size_t y) { return std::make_pair(y, x); });
+
+		transposeRecursive<T>(src.data(), static_cast<std::ptrdiff_t>(src.stride()), dst.data(), static_cast<std::ptrdiff_t>(dst.stride()), height, width);
+	}
+
+	/**
+	 * Rotates a quarter turn clockwise into dst, which must be height x width.
+	 */
+	template <typename S, typename T>
+	void rotate90(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		checkTransform(src, dst, true);
+		const auto [width, height] = src.dim();
+		if (src.empty())
+			return;
+
+		if (src.step() != 1 || dst.step() != 1)
+			return remap(src, dst, [h = height](std::size_t x, std::size_t y) { return std::make_pair(h - 1 - y, x); });
+
+		// A transpose reading the source rows bottom up
+		const auto stride = static_cast<std::ptrdiff_t>(src.stride());
+		transposeRecursive<T>(src.data() + static_cast<std::ptrdiff_t>(height - 1) * stride, -stride, dst.data(), static_cast<std::ptrdiff_t>(dst.stride()), height, width);
+	}
+
+	/**
+	 * Rotates a half turn into dst, which must be width x height.
+	 */
+	template <typename S, typename T>
+	void rotate180(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		checkTransform(src, dst, false);
+		const auto [width, height] = src.dim();
+
+		if (src.step() != 1 || dst.step() != 1)
+			return remap(src, dst, [w = width, h = height](std::size_t x, std::size_t y) { return std::make_pair(w - 1 - x, h - 1 - y); });
+
+		for (std::size_t y = 0; y < height; ++y)
+			std::reverse_copy(src.data() + y * src.stride(), src.data() + y * src.stride() + width, dst.data() + (height - 1 - y) * dst.stride());
+	}
+
+	/**
+	 * Rotates a quarter turn counterclockwise into dst, which must be height x width.
+	 */
+	template <typename S, typename T>
+	void rotate270(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		checkTransform(src, dst, true);
+		const auto [width, height] = src.dim();
+		if (src.empty())
+			return;
+
+		if (src.step() != 1 || dst.step() != 1)
+			return remap(src, dst, [w = width](std::size_t x, std::size_t y) { return std::make_pair(y, w - 1 - x); });
+
+		// A transpose writing the destination rows bottom up
+		const auto stride = static_cast<std::ptrdiff_t>(dst.stride());
+		transposeRecursive<T>(src.data(), static_cast<std::ptrdiff_t>(src.stride()), dst.data() + static_cast<std::ptrdiff_t>(width - 1) * stride, -stride, height, width);
+	}
+
+	/**
+	 * Mirrors left to right into dst, which must be width x height.
+	 */
+	template <typename S, typename T>
+	void flipHorizontal(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		checkTransform(src, dst, false);
+		const auto [width, height] = src.dim();
+
+		if (src.step() != 1 || dst.step() != 1)
+			return remap(src, dst, [w = width](std::size_t x, std::size_t y) { return std::make_pair(w - 1 - x, y); });
+
+		for (std::size_t y = 0; y < height; ++y)
+			std::reverse_copy(src.data() + y * src.stride(), src.data() + y * src.stride() + width, dst.data() + y * dst.stride());
+	}
+
+	/**
+	 * Mirrors top to bottom into dst, which must be width x height.
+	 */
+	template <typename S, typename T>
+	void flipVertical(const Vec2DView<S>& src, const Vec2DView<T>& dst)
+	{
+		checkTransform(src, dst, false);
+		const auto [width, height] = src.dim();
+
+		if (src.step() != 1 || dst.step() != 1)
+			return remap(src, dst, [h = height](std::size_t x, std::size_t y) { return std::make_pair(x, h - 1 - y); });
+
+		for (std::size_t y = 0; y < height; ++y)
+			std::copy_n(src.data() + y * src.stride(), width, dst.data() + (height - 1 - y) * dst.stride());
+	}
+
+	/**
+	 * Transposes a square view in place.
+	 */
+	template <typename T>
+	void transposeInPlace(const Vec2DView<T>& grid)
+	{
+		static_assert(!std::is_const_v<T>, "Cannot write through a const view");
+
+		const auto [width, height] = grid.dim();
+		if (width != height)
+			throw std::invalid_argument("Only square views transpose in place");
+
+		if (grid.step() != 1)
+		{
+			for (std::size_t y = 0; y < height; ++y)
+				for (std::size_t x = y + 1; x < width; ++x)
+					std::swap(grid(x, y), grid(y, x));
+			return;
+		}
+
+		transposeSquare(grid.data(), grid.stride(), width);
+	}
+
+	/**
+	 * Mirrors a view left to right in place.
+	 */
+	template <typename T>
+	void flipHorizontalInPlace(const Vec2DView<T>& grid)
+	{
+		const auto [width, height] = grid.dim();
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			if (grid.step() == 1)
+			{
+				std::reverse(grid.data() + y * grid.stride(), grid.data() + y * grid.stride() + width);
+				continue;
+			}
+
+			for (std::size_t x = 0; x < width / 2; ++x)
+				std::swap(grid(x, y), grid(width - 1 - x, y));
+		}
+	}
+
+	/**
+	 * Mirrors a view top to bottom in place.
+	 */
+	template <typename T>
+	void flipVerticalInPlace(const Vec2DView<T>& grid)
+	{
+		const auto [width, height] = grid.dim();
+		for (std::size_t y = 0; y < height / 2; ++y)
+		{
+			if (grid.step() == 1)
+			{
+				T* top = grid.data() + y * grid.stride();
+				std::swap_ranges(top, top + width, grid.data() + (height - 1 - y) * grid.stride());
+				continue;
+			}
+
+			for (std::size_t x = 0; x < width; ++x)
+				std::swap(grid(x, y), grid(x, height - 1 - y));
+		}
+	}
+}
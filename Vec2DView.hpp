@@ -0,0 +1,326 @@
+#pragma once
+
+#include "Simd.hpp"
+#include "Vec2DExpression.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+////////////////////////
+/// VECTOR2D VIEW
+////////////////////////
+
+/**
+ * A non-owning window on a row-major grid: a pointer, a width and height, and the strides
+ * between rows and between columns. Slicing, striding and row / column views only make new views,
+ * never copies. Vec2DView<const T> is the read-only variant.
+ *
+ * Views are expressions too, so they mix with grids and scalars in the lazy arithmetic, and
+ * Vec2D<T>( view ) materializes one. Copying a view rebinds it ( like std::span ), writing
+ * the elements goes through assign() and the compound operators.
+ */
+template <typename T>
+class Vec2DView : public Vec2DExpression<Vec2DView<T>>
+{
+public:
+	using value_type = std::remove_const_t<T>;
+	using element_type = T;
+	using layout_type = RowMajor;
+
+	Vec2DView() noexcept = default;
+
+	/**
+	 * Initializes a view of width x height elements, rows stride elements apart and columns step elements apart.
+	 */
+	Vec2DView(T* data, std::size_t width, std::size_t height, std::size_t stride, std::size_t step = 1) noexcept
+		: first(data)
+		, width(width)
+		, height(height)
+		, rowStride(stride)
+		, columnStep(step)
+	{
+	}
+
+	/**
+	 * Allow view -> const view.
+	 */
+	template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+	Vec2DView(const Vec2DView<U>& other) noexcept
+		: Vec2DView(other.data(), other.dim().first, other.dim().second, other.stride(), other.step())
+	{
+	}
+
+	/**
+	 * Returns the element at row, column.
+	 */
+	[[nodiscard]] T& at(std::size_t row, std::size_t col) const
+	{
+		assert(row < this->height&& col < this->width); // In range check (Only for debug mode)
+		return first[col * columnStep + row * rowStride];
+	}
+
+	/**
+	 * Returns the element at x, y.
+	 */
+	[[nodiscard]] T& operator()(std::size_t x, std::size_t y) const
+	{
+		return this->at(y, x);
+	}
+
+	/**
+	 * The top left element.
+	 */
+	[[nodiscard]] T* data() const noexcept { return first; }
+
+	[[nodiscard]] std::pair<std::size_t, std::size_t> dim() const noexcept { return { width, height }; }
+	[[nodiscard]] std::size_t stride() const noexcept { return rowStride; }
+	[[nodiscard]] std::size_t step() const noexcept { return columnStep; }
+	[[nodiscard]] bool empty() const noexcept { return width == 0 || height == 0; }
+
+	/**
+	 * Returns the sub-rectangle of w x h elements whose top left element is at x, y.
+	 */
+	[[nodiscard]] Vec2DView subview(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const
+	{
+		if (x > width || w > width - x || y > height || h > height - y)
+			throw std::out_of_range("Sub-view out of range");
+
+		return { first + x * columnStep + y * rowStride, w, h, rowStride, columnStep };
+	}
+
+	/**
+	 * Returns every xStep-th column of every yStep-th row, starting with the top left element.
+	 */
+	[[nodiscard]] Vec2DView strided(std::size_t xStep, std::size_t yStep) const
+	{
+		if (xStep == 0 || yStep == 0)
+			throw std::invalid_argument("Steps must be positive");
+
+		return { first, (width + xStep - 1) / xStep, (height + yStep - 1) / yStep, rowStride * yStep, columnStep * xStep };
+	}
+
+	/**
+	 * Returns row y as a width x 1 view.
+	 */
+	[[nodiscard]] Vec2DView row(std::size_t y) const
+	{
+		return this->subview(0, y, width, 1);
+	}
+
+	/**
+	 * Returns column x as a 1 x height view.
+	 */
+	[[nodiscard]] Vec2DView column(std::size_t x) const
+	{
+		return this->subview(x, 0, 1, height);
+	}
+
+	/**
+	 * Fill all elements with the given value.
+	 */
+	void fill(const value_type& value) const
+	{
+		static_assert(!std::is_const_v<T>, "Cannot write through a const view");
+
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			T* out = first + y * rowStride;
+			if (columnStep == 1)
+			{
+				std::fill_n(out, width, value);
+				continue;
+			}
+
+			for (std::size_t x = 0; x < width; ++x)
+				out[x * columnStep] = value;
+		}
+	}
+
+	/**
+	 * Searches the view for a specific element.
+	 * Returns the position ( x, y ) of the first match in row-major order within the view, if any.
+	 */
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>> find(const value_type& value) const
+	{
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			for (std::size_t x = 0; x < width; ++x)
+			{
+				if (this->at(y, x) == value)
+					return std::make_pair(x, y);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * Writes an expression ( or another view / grid ) of the same dimensions into the viewed elements.
+	 * The expression may read the elements it writes, but not other elements of this view.
+	 */
+	template <typename E>
+	const Vec2DView& assign(const Vec2DExpression<E>& expr) const
+	{
+		return this->update(expr.derived(), [](const value_type&, const auto& b) { return b; });
+	}
+
+	template <typename E>
+	const Vec2DView& operator+=(const Vec2DExpression<E>& expr) const
+	{
+		return this->update(expr.derived(), std::plus<>());
+	}
+
+	template <typename E>
+	const Vec2DView& operator-=(const Vec2DExpression<E>& expr) const
+	{
+		return this->update(expr.derived(), std::minus<>());
+	}
+
+	template <typename E>
+	const Vec2DView& operator*=(const Vec2DExpression<E>& expr) const
+	{
+		return this->update(expr.derived(), std::multiplies<>());
+	}
+
+	template <typename E>
+	const Vec2DView& operator/=(const Vec2DExpression<E>& expr) const
+	{
+		return this->update(expr.derived(), std::divides<>());
+	}
+
+	/**
+	 * Writes a row-major grid of the same dimensions into the viewed elements.
+	 */
+	const Vec2DView& assign(const Vec2D<value_type>& grid) const
+	{
+		return this->assign(grid.view());
+	}
+
+	const Vec2DView& operator+=(const Vec2D<value_type>& grid) const
+	{
+		return *this += grid.view();
+	}
+
+	const Vec2DView& operator-=(const Vec2D<value_type>& grid) const
+	{
+		return *this -= grid.view();
+	}
+
+	const Vec2DView& operator*=(const Vec2D<value_type>& grid) const
+	{
+		return *this *= grid.view();
+	}
+
+	const Vec2DView& operator/=(const Vec2D<value_type>& grid) const
+	{
+		return *this /= grid.view();
+	}
+
+	const Vec2DView& operator+=(const value_type& value) const
+	{
+		return this->apply<simd::Op::AddScalar>(value);
+	}
+
+	const Vec2DView& operator-=(const value_type& value) const
+	{
+		return this->apply<simd::Op::SubScalar>(value);
+	}
+
+	const Vec2DView& operator*=(const value_type& value) const
+	{
+		return this->apply<simd::Op::MulScalar>(value);
+	}
+
+	const Vec2DView& operator/=(const value_type& value) const
+	{
+		return this->apply<simd::Op::DivScalar>(value);
+	}
+
+	/**
+	 * The element at row-major position i, so views can sit at the leaves of expressions.
+	 */
+	[[nodiscard]] const value_type& element(std::size_t i) const
+	{
+		return this->at(i / width, i % width);
+	}
+
+private:
+	template <typename U>
+	friend class Vec2DView;
+
+	template <typename E>
+	static constexpr bool IsView = std::is_same_v<E, Vec2DView<value_type>> || std::is_same_v<E, Vec2DView<const value_type>>;
+
+	/**
+	 * The loop every expression is evaluated in, row by row. Views are read directly, skipping the row-major index division.
+	 */
+	template <typename E, typename Op>
+	const Vec2DView& update(const E& expr, Op op) const
+	{
+		static_assert(!std::is_const_v<T>, "Cannot write through a const view");
+		assert(expr.dim() == this->dim());
+
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			T* out = first + y * rowStride;
+
+			if constexpr (IsView<E>)
+			{
+				const value_type* in = expr.data() + y * expr.stride();
+				for (std::size_t x = 0; x < width; ++x)
+					out[x * columnStep] = static_cast<value_type>(op(out[x * columnStep], in[x * expr.step()]));
+			}
+			else if constexpr (std::is_same_v<typename E::layout_type, RowMajor>)
+			{
+				for (std::size_t x = 0; x < width; ++x)
+					out[x * columnStep] = static_cast<value_type>(op(out[x * columnStep], expr.element(x + y * width)));
+			}
+			else
+			{
+				// Stored in another layout, evaluate by position
+				for (std::size_t x = 0; x < width; ++x)
+					out[x * columnStep] = static_cast<value_type>(op(out[x * columnStep], expr.at(y, x)));
+			}
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Run an element-wise kernel with scalar operands, vectorized on rows when columns are contiguous.
+	 */
+	template <simd::Op op>
+	const Vec2DView& apply(const value_type& s0) const
+	{
+		static_assert(!std::is_const_v<T>, "Cannot write through a const view");
+
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			T* out = first + y * rowStride;
+			if (columnStep == 1)
+			{
+				simd::run<op>(out, out, static_cast<const value_type*>(nullptr), s0, value_type{}, width);
+				continue;
+			}
+
+			for (std::size_t x = 0; x < width; ++x)
+				simd::applyScalar<op>(out, out, static_cast<const value_type*>(nullptr), s0, value_type{}, x * columnStep);
+		}
+
+		return *this;
+	}
+
+	T* first = nullptr;				///< The top left element.
+	std::size_t width = 0;			///< Width of the view.
+	std::size_t height = 0;			///< Height of the view.
+	std::size_t rowStride = 0;		///< Elements between the starts of two rows.
+	std::size_t columnStep = 1;		///< Elements between two columns.
+};
+
+template <typename T>
+using ConstVec2DView = Vec2DView<const T>;
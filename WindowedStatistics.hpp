@@ -0,0 +1,207 @@
+#pragma once
+
+#include "CircularBuffer.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+////////////////////////
+/// WINDOWED STATISTICS
+////////////////////////
+
+/**
+ * A sliding window over the last ( up to ) N samples with O(1) statistics.
+ *
+ * Every add() folds the new sample in and the sample ejected by the window out:
+ * running sum, Welford mean/variance, and monotonic queues for min/max.
+ * Real is the type the sum, mean and variance are accumulated in.
+ */
+template <typename T, size_t N, typename Real = double>
+class WindowedStatistics
+{
+public:
+	/**
+	 * @brief Adds a sample and returns the one that left the window ( if any )
+	 *
+	 * @param elem The sample being added
+	 * @return std::optional<T> The ejected sample
+	 */
+	std::optional<T> add(T elem)
+	{
+		const std::uint64_t sequence = window.realSize();
+		std::optional<T> old_elem = window.add(elem);
+
+		if (old_elem)
+			remove(*old_elem, window.size());
+		insert(elem);
+
+		expire(lows);
+		expire(highs);
+		pushMonotonic(lows, sequence, elem, [](const T& kept, const T& added) { return kept < added; });
+		pushMonotonic(highs, sequence, elem, [](const T& kept, const T& added) { return added < kept; });
+
+		return old_elem;
+	}
+
+	/**
+	 * @brief Changes the size of the window, the oldest samples leave it if it shrinks
+	 *
+	 * @param new_size The new size of the window
+	 */
+	void resize(size_t new_size)
+	{
+		if (new_size > 0 && new_size < window.size())
+		{
+			const size_t dropped = window.size() - new_size;
+			for (size_t i = 0; i < dropped; ++i)
+				remove(window[static_cast<int>(i)], window.size() - i);
+		}
+
+		window.resize(new_size);
+		expire(lows);
+		expire(highs);
+	}
+
+	/**
+	 * @brief Removes every sample
+	 */
+	void clear()
+	{
+		window.clear();
+		lows.clear();
+		highs.clear();
+		total = Real{};
+		average = Real{};
+		squares = Real{};
+	}
+
+	/**
+	 * @brief The smallest sample in the window
+	 */
+	[[nodiscard]] const T& min() const
+	{
+		if (window.empty())
+			throw std::underflow_error("Window is empty");
+
+		return lows[0].second;
+	}
+
+	/**
+	 * @brief The largest sample in the window
+	 */
+	[[nodiscard]] const T& max() const
+	{
+		if (window.empty())
+			throw std::underflow_error("Window is empty");
+
+		return highs[0].second;
+	}
+
+	/**
+	 * @brief Sum of the samples in the window
+	 */
+	[[nodiscard]] Real sum() const noexcept { return total; }
+
+	/**
+	 * @brief Mean of the samples in the window, 0 when empty
+	 */
+	[[nodiscard]] Real mean() const noexcept { return average; }
+
+	/**
+	 * @brief Population variance of the samples in the window, 0 when empty
+	 */
+	[[nodiscard]] Real variance() const noexcept
+	{
+		return window.empty() ? Real{} : squares / static_cast<Real>(window.size());
+	}
+
+	/**
+	 * @brief Sample ( Bessel corrected ) variance of the samples in the window, 0 with fewer than two samples
+	 */
+	[[nodiscard]] Real sampleVariance() const noexcept
+	{
+		return window.size() < 2 ? Real{} : squares / static_cast<Real>(window.size() - 1);
+	}
+
+	[[nodiscard]] Real stddev() const noexcept { return std::sqrt(variance()); }
+
+	/**
+	 * @brief The samples themselves, oldest first
+	 */
+	[[nodiscard]] const CircularBuffer<T, N>& samples() const noexcept { return window; }
+
+	[[nodiscard]] size_t size() const noexcept { return window.size(); }
+	[[nodiscard]] bool empty() const noexcept { return window.empty(); }
+
+private:
+	using Entry = std::pair<std::uint64_t, T>;	///< Sequence number of a sample, and the sample.
+	using MonotonicQueue = CircularBuffer<Entry, N>;
+
+	void insert(const T& elem)
+	{
+		const auto x = static_cast<Real>(elem);
+		const auto count = static_cast<Real>(window.size());
+
+		total += x;
+		const Real delta = x - average;
+		average += delta / count;
+		squares += delta * (x - average);
+	}
+
+	/**
+	 * Folds a sample out, count is the number of samples including it.
+	 */
+	void remove(const T& elem, size_t count)
+	{
+		const auto x = static_cast<Real>(elem);
+		const size_t remaining = count - 1;
+
+		total -= x;
+		if (remaining == 0)
+		{
+			total = Real{};
+			average = Real{};
+			squares = Real{};
+			return;
+		}
+
+		const Real delta = x - average;
+		average -= delta / static_cast<Real>(remaining);
+		squares -= delta * (x - average);
+
+		// Cancellation can leave a tiny negative remainder
+		if (squares < Real{})
+			squares = Real{};
+	}
+
+	/**
+	 * Drops entries that already left the window from the front of a queue.
+	 */
+	void expire(MonotonicQueue& queue)
+	{
+		const std::uint64_t oldest = window.realSize() - window.size();
+		while (!queue.empty() && queue.top().first < oldest)
+			queue.consume(1);
+	}
+
+	/**
+	 * Pushes a sample, first dropping every entry it makes irrelevant.
+	 * keep( kept, added ) says whether an older entry still matters next to the new sample.
+	 */
+	template <typename Keep>
+	static void pushMonotonic(MonotonicQueue& queue, std::uint64_t sequence, const T& elem, Keep keep)
+	{
+		while (!queue.empty() && !keep(queue[static_cast<int>(queue.size() - 1)].second, elem))
+			queue.pop();
+
+		queue.add({ sequence, elem });
+	}
+
+	CircularBuffer<T, N> window;
+	MonotonicQueue lows;	///< Increasing samples, the front is the minimum.
+	MonotonicQueue highs;	///< Decreasing samples, the front is the maximum.
+	Real total{};
+	Real average{};
+	Real squares{};	///< Welford's running sum of squared deviations.
+};
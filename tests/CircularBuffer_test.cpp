@@ -1,6 +1,24 @@
 #include "CircularBuffer.hpp"
+#include "MirroredCircularBuffer.hpp"
+#include "SharedCircularBuffer.hpp"
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/catch_session.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST_CASE("CircularBuffer add function")
 {
@@ -76,3 +94,642 @@ TEST_CASE("CircularBuffer top and pop functions")
     REQUIRE_THROWS_AS(buffer.pop(), std::underflow_error);
 }
 
+TEST_CASE("CircularBuffer wraps repeatedly")
+{
+    CircularBuffer<int, 4> buffer;
+
+    for (int i = 0; i < 4; ++i)
+        buffer.add(i);
+
+    // Every further add evicts the oldest element, not just the first one
+    for (int i = 4; i < 11; ++i)
+        REQUIRE(buffer.add(i) == i - 4);
+
+    REQUIRE(buffer.size() == 4);
+    REQUIRE(buffer.realSize() == 11);
+    REQUIRE(buffer.top() == 7);
+    REQUIRE(buffer[3] == 10);
+}
+
+TEST_CASE("CircularBuffer resize function")
+{
+    CircularBuffer<int, 8> buffer;
+
+    for (int i = 0; i < 10; ++i)
+        buffer.add(i);
+
+    SECTION("Shrinking keeps the newest elements")
+    {
+        buffer.resize(3);
+        REQUIRE(buffer.size() == 3);
+        REQUIRE(buffer[0] == 7);
+        REQUIRE(buffer[1] == 8);
+        REQUIRE(buffer[2] == 9);
+
+        REQUIRE(buffer.add(10) == 7);
+        REQUIRE(buffer[2] == 10);
+    }
+
+    SECTION("Growing keeps every element")
+    {
+        buffer.resize(4);
+        buffer.resize(6);
+        REQUIRE(buffer.size() == 4);
+
+        REQUIRE(buffer.add(10) == std::nullopt);
+        REQUIRE(buffer.add(11) == std::nullopt);
+        REQUIRE(buffer.add(12) == 6);
+        REQUIRE(buffer[0] == 7);
+        REQUIRE(buffer[5] == 12);
+    }
+
+    SECTION("Invalid sizes")
+    {
+        REQUIRE_THROWS_AS(buffer.resize(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(buffer.resize(9), std::length_error);
+    }
+}
+
+TEST_CASE("CircularBuffer bulk functions")
+{
+    CircularBuffer<int, 5> buffer;
+    const int packet[] = { 1, 2, 3, 4, 5, 6, 7 };
+
+    SECTION("Push bulk across the wrap point")
+    {
+        REQUIRE(buffer.push_bulk(packet, 3) == 0);
+        REQUIRE(buffer.push_bulk(packet + 3, 4) == 2);
+        REQUIRE(buffer.size() == 5);
+        REQUIRE(buffer.realSize() == 7);
+
+        for (int i = 0; i < 5; ++i)
+            REQUIRE(buffer[i] == i + 3);
+    }
+
+    SECTION("Push bulk larger than the capacity")
+    {
+        buffer.add(0);
+        REQUIRE(buffer.push_bulk(packet, 7) == 3);
+        REQUIRE(buffer.top() == 3);
+        REQUIRE(buffer[4] == 7);
+    }
+
+    SECTION("Pop bulk takes the oldest elements")
+    {
+        buffer.push_bulk(packet, 7);
+
+        int out[5] = {};
+        REQUIRE(buffer.pop_bulk(out, 2) == 2);
+        REQUIRE(out[0] == 3);
+        REQUIRE(out[1] == 4);
+        REQUIRE(buffer.size() == 3);
+
+        REQUIRE(buffer.pop_bulk(out, 5) == 3);
+        REQUIRE(out[0] == 5);
+        REQUIRE(out[2] == 7);
+        REQUIRE(buffer.empty());
+    }
+
+    SECTION("Spans cover the readable region in order")
+    {
+        buffer.push_bulk(packet, 7);
+
+        auto [first, second] = buffer.spans();
+        REQUIRE(first.size() + second.size() == 5);
+        REQUIRE(first[0] == 3);
+        REQUIRE(second.data() == &buffer[first.size()]);
+
+        REQUIRE(buffer.consume(first.size()) == first.size());
+        REQUIRE(buffer.top() == second[0]);
+
+        auto [rest, none] = buffer.spans();
+        REQUIRE(rest.size() == second.size());
+        REQUIRE(none.empty());
+    }
+}
+
+TEST_CASE("CircularBuffer iterators")
+{
+    CircularBuffer<int, 5> buffer;
+
+    for (int i = 1; i <= 7; ++i)
+        buffer.add(i);
+
+    SECTION("Logical order")
+    {
+        std::vector<int> copy(buffer.begin(), buffer.end());
+        REQUIRE(copy == std::vector<int>{ 3, 4, 5, 6, 7 });
+        REQUIRE(std::accumulate(buffer.cbegin(), buffer.cend(), 0) == 25);
+        REQUIRE(*buffer.rbegin() == 7);
+    }
+
+    SECTION("Random access")
+    {
+        auto it = buffer.begin();
+        REQUIRE(buffer.end() - it == 5);
+        REQUIRE(it[4] == 7);
+        REQUIRE(*(it + 2) == 5);
+        REQUIRE(it < buffer.end());
+
+        CircularBuffer<int, 5>::const_iterator cit = it + 1;
+        REQUIRE(*cit == 4);
+    }
+
+    SECTION("Algorithms write through")
+    {
+        std::sort(buffer.begin(), buffer.end(), std::greater<>());
+        REQUIRE(buffer[0] == 7);
+        REQUIRE(buffer[4] == 3);
+    }
+
+    SECTION("Segments")
+    {
+        int sum = 0;
+        int segments = 0;
+        buffer.forEachSegment([&](auto segment)
+        {
+            sum = std::accumulate(segment.begin(), segment.end(), sum);
+            ++segments;
+        });
+
+        REQUIRE(sum == 25);
+        REQUIRE(segments == 2);
+    }
+}
+
+TEST_CASE("DynamicCircularBuffer")
+{
+    SECTION("Same semantics as the fixed buffer")
+    {
+        DynamicCircularBuffer<int> buffer(5);
+        REQUIRE(buffer.maxSize() == 5);
+
+        for (int i = 1; i <= 5; ++i)
+            REQUIRE(buffer.add(i) == std::nullopt);
+
+        REQUIRE(buffer.add(6) == 1);
+        REQUIRE(buffer.size() == 5);
+        REQUIRE(buffer.realSize() == 6);
+        REQUIRE(buffer[0] == 2);
+        REQUIRE(buffer.pop() == 6);
+
+        buffer.resize(2);
+        REQUIRE(buffer.top() == 4);
+        REQUIRE(buffer.add(7) == 4);
+        REQUIRE_THROWS_AS(buffer.resize(6), std::length_error);
+    }
+
+    SECTION("Power of two capacity")
+    {
+        DynamicCircularBuffer<int> buffer(8);
+        for (int i = 0; i < 20; ++i)
+            buffer.add(i);
+
+        std::vector<int> copy(buffer.begin(), buffer.end());
+        REQUIRE(copy == std::vector<int>{ 12, 13, 14, 15, 16, 17, 18, 19 });
+    }
+
+    SECTION("Copies are deep")
+    {
+        DynamicCircularBuffer<int> buffer(3);
+        buffer.add(1);
+
+        auto copy = buffer;
+        copy[0] = 2;
+        REQUIRE(buffer[0] == 1);
+    }
+
+    SECTION("Aligned storage")
+    {
+        DynamicCircularBuffer<int, AlignedAllocator<int, 64>> aligned(100);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(&aligned.spans().first[0]) % 64 == 0);
+
+        DynamicCircularBuffer<int, HugePageAllocator<int>> huge(1000);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(&huge.spans().first[0]) % HugePageAllocator<int>::HugePageSize == 0);
+        huge.push_bulk(std::vector<int>(1500, 1).data(), 1500);
+        REQUIRE(std::accumulate(huge.begin(), huge.end(), 0) == 1000);
+    }
+
+    SECTION("Invalid capacity")
+    {
+        REQUIRE_THROWS_AS(DynamicCircularBuffer<int>(0), std::invalid_argument);
+    }
+
+    SECTION("Moved-from buffers are empty and usable")
+    {
+        DynamicCircularBuffer<int> buffer(6);
+        for (int i = 0; i < 4; ++i)
+            buffer.add(i);
+
+        DynamicCircularBuffer<int> moved(std::move(buffer));
+        REQUIRE(moved.size() == 4);
+        REQUIRE(moved[3] == 3);
+
+        // No storage left, so nothing is kept
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.maxSize() == 0);
+        REQUIRE(buffer.add(9) == 9);
+        REQUIRE(buffer.push_bulk(std::vector<int>(3, 1).data(), 3) == 3);
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.begin() == buffer.end());
+        REQUIRE_THROWS_AS(buffer.pop(), std::underflow_error);
+        REQUIRE_THROWS_AS(buffer.resize(2), std::length_error);
+
+        auto copy = buffer;
+        REQUIRE(copy.empty());
+
+        // Assigning gives it storage again
+        buffer = std::move(moved);
+        REQUIRE(buffer.size() == 4);
+        REQUIRE(buffer.add(4) == std::nullopt);
+        REQUIRE(buffer.add(5) == std::nullopt);
+        REQUIRE(buffer.add(6) == 0);
+        REQUIRE(moved.add(1) == 1);
+
+        // Fixed buffers keep their inline storage
+        CircularBuffer<int, 3> fixed;
+        fixed.add(1);
+        CircularBuffer<int, 3> fixedMoved(std::move(fixed));
+        REQUIRE(fixedMoved.size() == 1);
+        REQUIRE(fixed.empty());
+        REQUIRE(fixed.add(2) == std::nullopt);
+        REQUIRE(fixed.top() == 2);
+    }
+}
+
+#if defined(__linux__)
+TEST_CASE("MirroredCircularBuffer")
+{
+    MirroredCircularBuffer<std::uint32_t> buffer(1000);
+    const size_t capacity = buffer.maxSize();
+    REQUIRE(capacity >= 1000);
+
+    // Wrap part way through the storage
+    for (std::uint32_t i = 0; i < capacity + capacity / 2; ++i)
+        buffer.add(i);
+
+    REQUIRE(buffer.size() == capacity);
+    REQUIRE(buffer.realSize() == capacity + capacity / 2);
+    REQUIRE(buffer.add(0) == capacity / 2);
+
+    // The readable region is contiguous even though the buffer wraps
+    auto readable = buffer.readable();
+    REQUIRE(readable.size() == capacity);
+    for (size_t i = 0; i < readable.size(); ++i)
+        REQUIRE(readable[i] == buffer[static_cast<int>(i)]);
+
+    std::vector<std::uint32_t> out(capacity / 2);
+    REQUIRE(buffer.pop_bulk(out.data(), out.size()) == out.size());
+    REQUIRE(out.front() == capacity / 2 + 1);
+    REQUIRE(buffer.readable().size() == capacity - out.size());
+    REQUIRE(buffer.readable()[0] == buffer.top());
+}
+#endif
+
+TEST_CASE("SpscCircularBuffer try_push and try_pop functions")
+{
+    SpscCircularBuffer<int, 3> buffer;
+
+    REQUIRE(buffer.empty());
+    REQUIRE(buffer.try_pop() == std::nullopt);
+
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE(buffer.try_push(3));
+
+    // A full buffer rejects new elements instead of overwriting
+    REQUIRE_FALSE(buffer.try_push(4));
+    REQUIRE(buffer.size() == 3);
+
+    // Elements come out oldest first
+    REQUIRE(buffer.try_pop() == 1);
+    REQUIRE(buffer.try_push(4));
+    REQUIRE(buffer.try_pop() == 2);
+    REQUIRE(buffer.try_pop() == 3);
+    REQUIRE(buffer.try_pop() == 4);
+    REQUIRE(buffer.try_pop() == std::nullopt);
+}
+
+TEST_CASE("SpscCircularBuffer producer and consumer threads")
+{
+    constexpr int count = 100000;
+    SpscCircularBuffer<int, 64> buffer;
+
+    std::thread producer([&buffer]
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            while (!buffer.try_push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    // Every element must arrive exactly once and in order
+    bool ordered = true;
+    for (int expected = 0; expected < count;)
+    {
+        if (auto elem = buffer.try_pop())
+            ordered &= (*elem == expected++);
+        else
+            std::this_thread::yield();
+    }
+
+    producer.join();
+
+    REQUIRE(ordered);
+    REQUIRE(buffer.empty());
+}
+
+TEST_CASE("MpmcCircularBuffer try_push and try_pop functions")
+{
+    MpmcCircularBuffer<int, 3> buffer;
+
+    REQUIRE(buffer.try_pop() == std::nullopt);
+
+    REQUIRE(buffer.try_push(1));
+    REQUIRE(buffer.try_push(2));
+    REQUIRE(buffer.try_push(3));
+    REQUIRE_FALSE(buffer.try_push(4));
+    REQUIRE(buffer.size() == 3);
+
+    REQUIRE(buffer.try_pop() == 1);
+    REQUIRE(buffer.try_push(4));
+    REQUIRE(buffer.pop() == 2);
+    REQUIRE(buffer.pop() == 3);
+    REQUIRE(buffer.pop() == 4);
+    REQUIRE(buffer.empty());
+}
+
+TEST_CASE("MpmcCircularBuffer multiple producers and consumers")
+{
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr int perProducer = 20000;
+    MpmcCircularBuffer<int, 128> buffer;
+
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(consumers, 0);
+
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&buffer, p]
+        {
+            for (int i = 0; i < perProducer; ++i)
+                buffer.push(p * perProducer + i);
+        });
+    }
+
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&buffer, &sums, c]
+        {
+            for (int i = 0; i < producers * perProducer / consumers; ++i)
+                sums[c] += buffer.pop();
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    // Every element must be consumed exactly once
+    constexpr long long total = producers * perProducer;
+    long long sum = 0;
+    for (auto s : sums)
+        sum += s;
+
+    REQUIRE(sum == total * (total - 1) / 2);
+    REQUIRE(buffer.empty());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("SharedCircularBuffer between processes")
+{
+    constexpr std::uint32_t count = 100000;
+    const std::string name = "/utils_test_" + std::to_string(getpid());
+
+    auto consumer = SharedCircularBuffer<std::uint32_t>::create(name, 64);
+    REQUIRE(consumer.capacity() == 64);
+    REQUIRE_THROWS(SharedCircularBuffer<std::uint32_t>::create(name, 64));
+    REQUIRE_THROWS(SharedCircularBuffer<std::uint64_t>::attach(name));
+
+    const pid_t child = fork();
+    REQUIRE(child != -1);
+
+    if (child == 0)
+    {
+        // Never return into Catch2 from the child
+        int status = 0;
+        try
+        {
+            auto producer = SharedCircularBuffer<std::uint32_t>::attach(name);
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                while (!producer.try_push(i))
+                    std::this_thread::yield();
+            }
+        }
+        catch (...)
+        {
+            status = 1;
+        }
+        _exit(status);
+    }
+
+    bool ordered = true;
+    bool childFailed = false;
+    for (std::uint32_t expected = 0; expected < count && !childFailed;)
+    {
+        if (auto elem = consumer.try_pop())
+        {
+            ordered &= (*elem == expected++);
+        }
+        else
+        {
+            int status = 0;
+            childFailed = waitpid(child, &status, WNOHANG) == child && consumer.empty();
+            std::this_thread::yield();
+        }
+    }
+
+    int status = 0;
+    if (!childFailed)
+        waitpid(child, &status, 0);
+
+    REQUIRE_FALSE(childFailed);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(ordered);
+    REQUIRE(consumer.empty());
+}
+
+TEST_CASE("SharedCircularBuffer rejects foreign segments")
+{
+    const std::string name = "/utils_test_foreign_" + std::to_string(getpid());
+
+    REQUIRE_THROWS_AS(SharedCircularBuffer<std::uint32_t>::create(name, 100), std::invalid_argument);
+
+    SECTION("Smaller than a header")
+    {
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        REQUIRE(fd != -1);
+        REQUIRE(ftruncate(fd, 8) == 0);
+        close(fd);
+
+        // Not a std::system_error, no call failed
+        bool rejected = false;
+        try
+        {
+            SharedCircularBuffer<std::uint32_t>::attach(name);
+        }
+        catch (const std::system_error&)
+        {
+        }
+        catch (const std::runtime_error&)
+        {
+            rejected = true;
+        }
+        shm_unlink(name.c_str());
+        REQUIRE(rejected);
+    }
+
+    SECTION("A corrupt capacity")
+    {
+        auto owner = SharedCircularBuffer<std::uint32_t>::create(name, 64);
+
+        // The capacity follows the magic and element size words
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        REQUIRE(fd != -1);
+        void* segment = mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        REQUIRE(segment != MAP_FAILED);
+
+        for (const std::uint64_t capacity : { std::uint64_t{ 0 }, std::uint64_t{ 48 }, std::uint64_t{ 1 } << 40 })
+        {
+            std::memcpy(static_cast<unsigned char*>(segment) + 16, &capacity, sizeof(capacity));
+            REQUIRE_THROWS_AS(SharedCircularBuffer<std::uint32_t>::attach(name), std::runtime_error);
+        }
+        munmap(segment, 64);
+    }
+}
+#endif
+
+TEST_CASE("SeqlockCircularBuffer add and snapshot functions")
+{
+    SeqlockCircularBuffer<int, 4> buffer;
+
+    REQUIRE(buffer.empty());
+    REQUIRE(buffer.read(0) == std::nullopt);
+
+    for (int i = 0; i < 10; ++i)
+        buffer.add(i);
+
+    REQUIRE(buffer.written() == 10);
+    REQUIRE(buffer.size() == 4);
+
+    // Overwritten and not yet written entries are detected
+    REQUIRE(buffer.read(5) == std::nullopt);
+    REQUIRE(buffer.read(10) == std::nullopt);
+    REQUIRE(buffer.read(9) == 9);
+
+    int out[8] = {};
+    REQUIRE(buffer.snapshot(out, 8) == 4);
+    REQUIRE(out[0] == 6);
+    REQUIRE(out[3] == 9);
+
+    REQUIRE(buffer.snapshot(out, 2) == 2);
+    REQUIRE(out[0] == 8);
+}
+
+TEST_CASE("SeqlockCircularBuffer entries need not be default constructible")
+{
+    struct Reading
+    {
+        explicit Reading(int value) : value{ value } {}
+        int value;
+    };
+
+    SeqlockCircularBuffer<Reading, 4> buffer;
+    buffer.add(Reading{ 7 });
+
+    const auto reading = buffer.read(0);
+    REQUIRE(reading.has_value());
+    REQUIRE(reading->value == 7);
+}
+
+TEST_CASE("SeqlockCircularBuffer readers never see torn entries")
+{
+    struct Record
+    {
+        std::uint64_t id;
+        std::uint64_t twice;
+        std::uint64_t inverted;
+    };
+
+    SeqlockCircularBuffer<Record, 16> buffer;
+    std::atomic<bool> done{ false };
+
+    std::thread writer([&]
+    {
+        for (std::uint64_t i = 0; i < 200000; ++i)
+            buffer.add({ i, i * 2, ~i });
+        done = true;
+    });
+
+    bool consistent = true;
+    Record out[16];
+    while (!done)
+    {
+        const size_t count = buffer.snapshot(out, 16);
+        for (size_t i = 0; i < count; ++i)
+        {
+            consistent &= out[i].twice == out[i].id * 2 && out[i].inverted == ~out[i].id;
+            consistent &= i == 0 || out[i].id > out[i - 1].id;
+        }
+    }
+
+    writer.join();
+
+    REQUIRE(consistent);
+    REQUIRE(buffer.snapshot(out, 16) == 16);
+    REQUIRE(out[15].id == 199999);
+}
+
+TEST_CASE("CircularBuffer masked vs modulo indexing", "[.][benchmark]")
+{
+    constexpr std::uint32_t count = 1 << 20;
+
+    // Same capacity, but resizing the larger buffer forces the modulo path
+    CircularBuffer<std::uint32_t, 1024> masked;
+    CircularBuffer<std::uint32_t, 2048> modulo;
+    modulo.resize(1024);
+
+    BENCHMARK("Masked add")
+    {
+        for (std::uint32_t i = 0; i < count; ++i)
+            masked.add(i);
+        return masked.size();
+    };
+
+    BENCHMARK("Modulo add")
+    {
+        for (std::uint32_t i = 0; i < count; ++i)
+            modulo.add(i);
+        return modulo.size();
+    };
+
+    BENCHMARK("Masked operator[]")
+    {
+        std::uint32_t sum = 0;
+        for (std::uint32_t i = 0; i < count; ++i)
+            sum += masked[static_cast<int>(i % 1024)];
+        return sum;
+    };
+
+    BENCHMARK("Modulo operator[]")
+    {
+        std::uint32_t sum = 0;
+        for (std::uint32_t i = 0; i < count; ++i)
+            sum += modulo[static_cast<int>(i % 1024)];
+        return sum;
+    };
+}
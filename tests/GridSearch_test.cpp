@@ -0,0 +1,489 @@
+#include "GridSearch.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Point = vec2d::GridSearch::Point;
+
+    const auto isFree = [](std::uint8_t cell) { return cell == 0; };
+
+    /**
+     * An occupancy grid, 1 for walls.
+     */
+    Vec2D<std::uint8_t> randomOccupancy(std::size_t width, std::size_t height, double walls, unsigned seed)
+    {
+        std::mt19937 random(seed);
+        std::bernoulli_distribution wall(walls);
+        Vec2D<std::uint8_t> grid(width, height);
+        for (auto& cell : grid)
+            cell = wall(random) ? 1 : 0;
+        return grid;
+    }
+
+    /**
+     * The ad hoc BFS the engine replaces, a queue and operator().
+     */
+    Vec2D<std::uint32_t> naiveDistances(const Vec2D<std::uint8_t>& grid, std::size_t sx, std::size_t sy)
+    {
+        const auto [width, height] = grid.dim();
+        Vec2D<std::uint32_t> distance(width, height, vec2d::GridSearch::Unreached);
+        if (grid(sx, sy) != 0)
+            return distance;
+
+        std::queue<Point> queue;
+        queue.push({ sx, sy });
+        distance(sx, sy) = 0;
+        while (!queue.empty())
+        {
+            const auto [x, y] = queue.front();
+            queue.pop();
+
+            const std::ptrdiff_t steps[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+            for (const auto& step : steps)
+            {
+                const auto nx = static_cast<std::ptrdiff_t>(x) + step[0];
+                const auto ny = static_cast<std::ptrdiff_t>(y) + step[1];
+                if (nx < 0 || ny < 0 || nx >= static_cast<std::ptrdiff_t>(width) || ny >= static_cast<std::ptrdiff_t>(height))
+                    continue;
+                if (grid(nx, ny) != 0 || distance(nx, ny) != vec2d::GridSearch::Unreached)
+                    continue;
+
+                distance(nx, ny) = distance(x, y) + 1;
+                queue.push({ static_cast<std::size_t>(nx), static_cast<std::size_t>(ny) });
+            }
+        }
+
+        return distance;
+    }
+
+    /**
+     * Dijkstra over 8 neighbours without corner cutting, the reference for path costs.
+     */
+    std::optional<vec2d::PathCost> naivePathCost(const Vec2D<std::uint8_t>& grid, Point start, Point goal)
+    {
+        const auto [width, height] = grid.dim();
+        const auto free = [&](std::ptrdiff_t x, std::ptrdiff_t y)
+        {
+            return x >= 0 && y >= 0 && x < static_cast<std::ptrdiff_t>(width) && y < static_cast<std::ptrdiff_t>(height) && grid(x, y) == 0;
+        };
+
+        if (!free(start.first, start.second) || !free(goal.first, goal.second))
+            return std::nullopt;
+
+        Vec2D<vec2d::PathCost> best(width, height, std::numeric_limits<vec2d::PathCost>::max());
+        using Entry = std::pair<vec2d::PathCost, Point>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+        best(start.first, start.second) = 0;
+        open.push({ 0, start });
+
+        while (!open.empty())
+        {
+            const auto [cost, point] = open.top();
+            open.pop();
+            if (point == goal)
+                return cost;
+            if (cost != best(point.first, point.second))
+                continue;
+
+            const auto x = static_cast<std::ptrdiff_t>(point.first);
+            const auto y = static_cast<std::ptrdiff_t>(point.second);
+            for (std::ptrdiff_t dy = -1; dy <= 1; ++dy)
+            {
+                for (std::ptrdiff_t dx = -1; dx <= 1; ++dx)
+                {
+                    if ((dx == 0 && dy == 0) || !free(x + dx, y + dy))
+                        continue;
+                    if (dx != 0 && dy != 0 && (!free(x + dx, y) || !free(x, y + dy)))
+                        continue;
+
+                    const vec2d::PathCost next = cost + (dx != 0 && dy != 0 ? vec2d::DiagonalCost : vec2d::StraightCost);
+                    if (next < best(x + dx, y + dy))
+                    {
+                        best(x + dx, y + dy) = next;
+                        open.push({ next, { static_cast<std::size_t>(x + dx), static_cast<std::size_t>(y + dy) } });
+                    }
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * Checks a path goes from start to goal through free cells one legal step at a time, and costs cost.
+     */
+    bool validPath(const Vec2D<std::uint8_t>& grid, const std::vector<Point>& path, Point start, Point goal, vec2d::PathCost cost, bool diagonals)
+    {
+        if (path.empty() || path.front() != start || path.back() != goal)
+            return false;
+
+        vec2d::PathCost total = 0;
+        for (std::size_t i = 0; i < path.size(); ++i)
+        {
+            const auto [x, y] = path[i];
+            if (grid(x, y) != 0)
+                return false;
+            if (i == 0)
+                continue;
+
+            const auto [px, py] = path[i - 1];
+            const auto dx = static_cast<std::ptrdiff_t>(x) - static_cast<std::ptrdiff_t>(px);
+            const auto dy = static_cast<std::ptrdiff_t>(y) - static_cast<std::ptrdiff_t>(py);
+            if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0))
+                return false;
+
+            if (dx != 0 && dy != 0)
+            {
+                if (!diagonals || grid(px + dx, py) != 0 || grid(px, py + dy) != 0)
+                    return false;
+                total += vec2d::DiagonalCost;
+            }
+            else
+            {
+                total += vec2d::StraightCost;
+            }
+        }
+
+        return total == cost;
+    }
+}
+
+TEST_CASE("Scanline flood fill")
+{
+    vec2d::GridSearch search(1, 1);
+
+    SECTION("Fills exactly the 4-connected region")
+    {
+        auto grid = randomOccupancy(97, 61, 0.4, 1);
+        grid(40, 30) = 0;
+        const auto expected = naiveDistances(grid, 40, 30);
+
+        const std::size_t filled = search.fill(grid.view(), 40, 30, std::uint8_t{ 7 });
+
+        std::size_t reachable = 0;
+        for (std::size_t y = 0; y < 61; ++y)
+        {
+            for (std::size_t x = 0; x < 97; ++x)
+            {
+                const bool inRegion = expected(x, y) != vec2d::GridSearch::Unreached;
+                reachable += inRegion;
+                REQUIRE((grid(x, y) == 7) == inRegion);
+            }
+        }
+        REQUIRE(filled == reachable);
+
+        // Filling with the current value changes nothing
+        REQUIRE(search.fill(grid.view(), 40, 30, std::uint8_t{ 7 }) == 0);
+    }
+
+    SECTION("Spirals and sub-views")
+    {
+        // A spiral corridor, every turn makes the fill go back on itself
+        const std::vector<std::vector<int>> rows =
+        {
+            { 0, 0, 0, 0, 0, 0, 0 },
+            { 1, 1, 1, 1, 1, 1, 0 },
+            { 0, 0, 0, 0, 0, 1, 0 },
+            { 0, 1, 1, 1, 0, 1, 0 },
+            { 0, 1, 0, 0, 0, 1, 0 },
+            { 0, 1, 1, 1, 1, 1, 0 },
+            { 0, 0, 0, 0, 0, 0, 0 },
+        };
+        Vec2D<int> grid(rows);
+        REQUIRE(search.fill(grid.view(), 2, 4, 5) == 31);
+        REQUIRE(grid(4, 3) == 5);
+        REQUIRE(grid(0, 0) == 5);
+        REQUIRE(grid(1, 1) == 1);
+
+        // Only inside the view
+        Vec2D<int> blank(10, 10, 0);
+        REQUIRE(search.fill(blank.subview(2, 3, 4, 5), 1, 1, 9) == 20);
+        REQUIRE(blank(2, 3) == 9);
+        REQUIRE(blank(5, 7) == 9);
+        REQUIRE(blank(6, 7) == 0);
+        REQUIRE(blank(1, 3) == 0);
+        REQUIRE_THROWS_AS(search.fill(blank.view(), 10, 0, 1), std::out_of_range);
+    }
+}
+
+TEST_CASE("Breadth-first distances")
+{
+    // Width across a word boundary, not a multiple of 64, sequential and level-parallel alike
+    const auto grid = randomOccupancy(130, 90, 0.3, 2);
+    vec2d::GridSearch search(130, 90);
+
+    for (const auto& [x, y] : { Point{ 0, 0 }, Point{ 64, 45 }, Point{ 129, 89 }, Point{ 63, 10 } })
+    {
+        Vec2D<std::uint8_t> copy(grid);
+        copy(x, y) = 0;
+        const auto expected = naiveDistances(copy, x, y);
+
+        std::size_t reachable = 0;
+        for (const auto d : expected)
+            reachable += d != vec2d::GridSearch::Unreached;
+
+        REQUIRE(search.distancesFrom(copy.view(), x, y, isFree) == reachable);
+        REQUIRE(search.distances() == expected);
+        REQUIRE(search.distancesFrom(std::execution::par, copy.view(), x, y, isFree) == reachable);
+        REQUIRE(search.distances() == expected);
+    }
+
+    // Walled in, and starting on a wall
+    Vec2D<std::uint8_t> walled(130, 90, 1);
+    walled(5, 5) = 0;
+    REQUIRE(search.distancesFrom(walled.view(), 5, 5, isFree) == 1);
+    REQUIRE(search.distancesFrom(walled.view(), 6, 5, isFree) == 0);
+    REQUIRE(search.distances()(5, 5) == vec2d::GridSearch::Unreached);
+
+    REQUIRE_THROWS_AS(search.distancesFrom(Vec2D<std::uint8_t>(10, 10, 0).view(), 0, 0, isFree), std::invalid_argument);
+}
+
+TEST_CASE("Shortest paths")
+{
+    vec2d::GridSearch search(80, 60);
+
+    SECTION("A* and JPS find the cheapest path")
+    {
+        for (unsigned seed = 0; seed < 6; ++seed)
+        {
+            const auto grid = randomOccupancy(80, 60, 0.1 + 0.05 * seed, seed);
+            std::mt19937 random(seed);
+
+            for (int i = 0; i < 15; ++i)
+            {
+                const Point start{ random() % 80, random() % 60 };
+                const Point goal{ random() % 80, random() % 60 };
+                const auto expected = naivePathCost(grid, start, goal);
+
+                const auto aStar = search.aStar(grid.view(), start, goal, isFree);
+                REQUIRE(aStar == expected);
+                if (aStar)
+                    REQUIRE(validPath(grid, search.path(), start, goal, *aStar, true));
+                else
+                    REQUIRE(search.path().empty());
+
+                const auto jps = search.jumpPointSearch(grid.view(), start, goal, isFree);
+                REQUIRE(jps == expected);
+                if (jps)
+                    REQUIRE(validPath(grid, search.path(), start, goal, *jps, true));
+            }
+        }
+    }
+
+    SECTION("Four-connected paths cost their BFS distance")
+    {
+        const auto grid = randomOccupancy(80, 60, 0.25, 9);
+        Vec2D<std::uint8_t> copy(grid);
+        copy(3, 4) = 0;
+        search.distancesFrom(copy.view(), 3, 4, isFree);
+
+        for (const auto& goal : { Point{ 70, 50 }, Point{ 3, 5 }, Point{ 40, 0 } })
+        {
+            const auto cost = search.aStar(copy.view(), { 3, 4 }, goal, isFree, vec2d::Connectivity::Four);
+            const std::uint32_t steps = search.distances()(goal.first, goal.second);
+            if (steps == vec2d::GridSearch::Unreached)
+            {
+                REQUIRE_FALSE(cost);
+                continue;
+            }
+
+            REQUIRE(cost == steps * vec2d::StraightCost);
+            REQUIRE(validPath(copy, search.path(), { 3, 4 }, goal, *cost, false));
+        }
+    }
+
+    SECTION("Corners are not cut")
+    {
+        // The only diagonal squeezes between two walls
+        Vec2D<std::uint8_t> grid(80, 60, 0);
+        for (std::size_t x = 0; x < 80; ++x)
+            grid(x, 30) = 1;
+        for (std::size_t y = 0; y < 60; ++y)
+            grid(40, y) = y == 30 ? 1 : (y < 30 ? 1 : 0);
+        grid(39, 30) = 0;
+
+        const auto cost = search.jumpPointSearch(grid.view(), { 10, 10 }, { 60, 50 }, isFree);
+        REQUIRE(cost == naivePathCost(grid, { 10, 10 }, { 60, 50 }));
+        REQUIRE(validPath(grid, search.path(), { 10, 10 }, { 60, 50 }, *cost, true));
+
+        // Fully walled off
+        grid(39, 30) = 1;
+        REQUIRE_FALSE(search.aStar(grid.view(), { 10, 10 }, { 60, 50 }, isFree));
+        REQUIRE_FALSE(search.jumpPointSearch(grid.view(), { 10, 10 }, { 60, 50 }, isFree));
+        REQUIRE(search.aStar(grid.view(), { 10, 10 }, { 10, 10 }, isFree) == 0u);
+        REQUIRE(search.path().size() == 1);
+    }
+
+    SECTION("Oversized grids are rejected before allocating")
+    {
+        REQUIRE_THROWS_AS(vec2d::GridSearch(std::size_t{ 1 } << 20, std::size_t{ 1 } << 20), std::invalid_argument);
+        REQUIRE_THROWS_AS(vec2d::GridSearch(std::numeric_limits<std::size_t>::max(), 2), std::invalid_argument);
+
+        // Empty, but sides beyond the node indices are still rejected
+        REQUIRE_THROWS_AS(vec2d::GridSearch(std::size_t{ 1 } << 40, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(vec2d::GridSearch(0, std::size_t{ 1 } << 40), std::invalid_argument);
+    }
+
+    SECTION("Long empty grids reserve nothing")
+    {
+        vec2d::GridSearch empty(std::numeric_limits<std::uint32_t>::max() - 1, 0);
+        REQUIRE(empty.dim() == std::make_pair(std::size_t{ std::numeric_limits<std::uint32_t>::max() - 1 }, std::size_t{ 0 }));
+    }
+}
+
+TEST_CASE("Paths longer than 2^32 thousandths of a step")
+{
+    // A serpentine maze, every other row a wall open at alternating ends: over 4.3M steps end to end
+    constexpr std::size_t width = 4096;
+    constexpr std::size_t height = 2101;
+    Vec2D<std::uint8_t> maze(width, height, 0);
+    for (std::size_t y = 1; y < height; y += 2)
+    {
+        for (std::size_t x = 0; x < width; ++x)
+            maze(x, y) = 1;
+        maze(y % 4 == 1 ? width - 1 : 0, y) = 0;
+    }
+
+    // The last row is entered at the goal, no diagonal fits through a gap
+    const Point goal{ 0, height - 1 };
+    const std::uint64_t steps = (height / 2) * (width - 1) + height - 1;
+    REQUIRE(steps * vec2d::StraightCost > std::numeric_limits<std::uint32_t>::max());
+
+    vec2d::GridSearch search(width, height);
+    search.distancesFrom(maze.view(), 0, 0, isFree);
+    REQUIRE(search.distances()(goal.first, goal.second) == steps);
+
+    const auto jps = search.jumpPointSearch(maze.view(), { 0, 0 }, goal, isFree);
+    REQUIRE(jps == steps * vec2d::StraightCost);
+    REQUIRE(search.path().size() == steps + 1);
+
+    REQUIRE(search.aStar(maze.view(), { 0, 0 }, goal, isFree) == steps * vec2d::StraightCost);
+}
+
+TEST_CASE("Connected-component labelling")
+{
+    vec2d::GridSearch search(97, 61);
+    const auto grid = randomOccupancy(97, 61, 0.45, 4);
+
+    // Every free cell's region is the set a flood from it reaches
+    const std::size_t regions = search.label(grid.view(), isFree);
+    const auto labels = search.labels();
+
+    std::uint32_t highest = 0;
+    std::vector<bool> checked(regions + 1, false);
+    for (std::size_t y = 0; y < 61; ++y)
+    {
+        for (std::size_t x = 0; x < 97; ++x)
+        {
+            REQUIRE((labels(x, y) == 0) == (grid(x, y) != 0));
+            if (labels(x, y) == 0 || checked[labels(x, y)])
+                continue;
+
+            // Numbered in order of first cell
+            REQUIRE(labels(x, y) == highest + 1);
+            highest = labels(x, y);
+            checked[labels(x, y)] = true;
+
+            const auto reach = naiveDistances(grid, x, y);
+            bool sameRegion = true;
+            for (std::size_t i = 0; i < 97 * 61; ++i)
+                sameRegion &= (reach.getData()[i] != vec2d::GridSearch::Unreached) == (labels.getData()[i] == labels(x, y));
+            REQUIRE(sameRegion);
+        }
+    }
+    REQUIRE(highest == regions);
+
+    // Diagonal neighbours join under 8-connectivity
+    const Vec2D<int> checkers(std::vector<std::vector<int>>
+    {
+        { 1, 0, 1 },
+        { 0, 1, 0 },
+        { 1, 0, 1 },
+    });
+    vec2d::GridSearch small(3, 3);
+    const auto one = [](int cell) { return cell == 1; };
+    REQUIRE(small.label(checkers.view(), one) == 5);
+    REQUIRE(small.label(checkers.view(), one, vec2d::Connectivity::Eight) == 1);
+    REQUIRE(small.labels()(2, 2) == 1);
+
+    // A U shape whose arms only meet at the bottom, labels merge late
+    const Vec2D<int> u(std::vector<std::vector<int>>
+    {
+        { 1, 0, 1, 0, 1 },
+        { 1, 0, 1, 0, 1 },
+        { 1, 1, 1, 1, 1 },
+    });
+    vec2d::GridSearch wide(5, 3);
+    REQUIRE(wide.label(u.view(), one) == 1);
+}
+
+TEST_CASE("Grid search throughput", "[.][benchmark]")
+{
+    // 1K x 1K occupancy grid, a fifth walls
+    constexpr std::size_t side = 1024;
+    auto grid = randomOccupancy(side, side, 0.2, 11);
+    grid(0, 0) = 0;
+    grid(side - 1, side - 1) = 0;
+    vec2d::GridSearch search(side, side);
+
+    BENCHMARK("Ad hoc BFS with operator()")
+    {
+        return naiveDistances(grid, 0, 0)(side / 2, side / 2);
+    };
+
+    BENCHMARK("Engine BFS")
+    {
+        return search.distancesFrom(grid.view(), 0, 0, isFree);
+    };
+
+    BENCHMARK("Engine BFS, parallel")
+    {
+        return search.distancesFrom(std::execution::par, grid.view(), 0, 0, isFree);
+    };
+
+    BENCHMARK("Dijkstra, corner to corner")
+    {
+        return naivePathCost(grid, { 0, 0 }, { side - 1, side - 1 });
+    };
+
+    BENCHMARK("A*, corner to corner")
+    {
+        return search.aStar(grid.view(), { 0, 0 }, { side - 1, side - 1 }, isFree);
+    };
+
+    BENCHMARK("JPS, corner to corner")
+    {
+        return search.jumpPointSearch(grid.view(), { 0, 0 }, { side - 1, side - 1 }, isFree);
+    };
+
+    // Open rooms, where jumping pays off most
+    Vec2D<std::uint8_t> rooms(side, side, 0);
+    for (std::size_t i = 128; i < side; i += 128)
+        for (std::size_t j = 0; j < side; ++j)
+            if (j % 128 != 64)
+                rooms(i, j) = rooms(j, i) = 1;
+
+    BENCHMARK("A*, rooms")
+    {
+        return search.aStar(rooms.view(), { 5, 5 }, { side - 5, side - 5 }, isFree);
+    };
+
+    BENCHMARK("JPS, rooms")
+    {
+        return search.jumpPointSearch(rooms.view(), { 5, 5 }, { side - 5, side - 5 }, isFree);
+    };
+
+    BENCHMARK("Label components")
+    {
+        return search.label(grid.view(), isFree);
+    };
+}
@@ -0,0 +1,286 @@
+#include "Reduce.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    Vec2D<int> randomInts(std::size_t width, std::size_t height, int low, int high)
+    {
+        std::mt19937 random(22);
+        std::uniform_int_distribution<int> distribution(low, high);
+        Vec2D<int> grid(width, height);
+        for (auto& element : grid)
+            element = distribution(random);
+        return grid;
+    }
+
+    /**
+     * The region loop reductions replace, one at() per element.
+     */
+    std::int64_t naiveSum(const Vec2D<int>& grid, std::size_t x0, std::size_t y0, std::size_t w, std::size_t h)
+    {
+        std::int64_t sum = 0;
+        for (std::size_t y = y0; y < y0 + h; ++y)
+            for (std::size_t x = x0; x < x0 + w; ++x)
+                sum += grid(x, y);
+        return sum;
+    }
+}
+
+TEST_CASE("Whole-view reductions")
+{
+    // Tall enough for several row blocks, odd width for the vector tails
+    const auto grid = randomInts(301, 700, -1000, 1000);
+    const auto view = grid.view();
+
+    std::int64_t expectedSum = 0;
+    for (const int element : grid)
+        expectedSum += element;
+
+    SECTION("Sum and mean")
+    {
+        REQUIRE(vec2d::sum(view) == expectedSum);
+        REQUIRE(vec2d::sum(std::execution::par, view) == expectedSum);
+        REQUIRE(vec2d::mean(view) == static_cast<double>(expectedSum) / (301.0 * 700.0));
+
+        // Regions and strided views
+        REQUIRE(vec2d::sum(grid.subview(13, 27, 100, 600)) == naiveSum(grid, 13, 27, 100, 600));
+        REQUIRE(vec2d::sum(std::execution::par, view.column(5)) == naiveSum(grid, 5, 0, 1, 700));
+
+        std::int64_t everyOther = 0;
+        for (std::size_t y = 0; y < 700; y += 2)
+            for (std::size_t x = 0; x < 301; x += 3)
+                everyOther += grid(x, y);
+        REQUIRE(vec2d::sum(view.strided(3, 2)) == everyOther);
+
+        // Narrow elements do not overflow
+        const Vec2D<std::uint8_t> bytes(1000, 1000, 255);
+        REQUIRE(vec2d::sum(bytes.view()) == 255000000u);
+
+        // Every policy adds floats in the same order
+        Vec2D<float> floats(513, 517);
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        for (auto& element : floats)
+            element = distribution(random);
+        REQUIRE(vec2d::sum(floats.view()) == vec2d::sum(std::execution::par, floats.view()));
+        REQUIRE(std::abs(vec2d::sum(floats.view()) - std::accumulate(floats.begin(), floats.end(), 0.0)) < 1e-9);
+    }
+
+    SECTION("Min, max, argmin and argmax")
+    {
+        Vec2D<int> copy(grid);
+        copy(17, 400) = -5000;
+        copy(200, 650) = -5000;
+        copy(3, 2) = 5000;
+
+        REQUIRE(vec2d::min(copy.view()) == -5000);
+        REQUIRE(vec2d::max(std::execution::par, copy.view()) == 5000);
+        REQUIRE(vec2d::argmin(copy.view()) == std::make_pair(std::size_t{ 17 }, std::size_t{ 400 }));
+        REQUIRE(vec2d::argmin(std::execution::par, copy.view()) == std::make_pair(std::size_t{ 17 }, std::size_t{ 400 }));
+        REQUIRE(vec2d::argmax(std::execution::par, copy.view()) == std::make_pair(std::size_t{ 3 }, std::size_t{ 2 }));
+
+        // Positions are relative to the view
+        REQUIRE(vec2d::argmin(copy.subview(100, 500, 150, 200)) == std::make_pair(std::size_t{ 100 }, std::size_t{ 150 }));
+        REQUIRE(vec2d::argmax(copy.view().column(3)) == std::make_pair(std::size_t{ 0 }, std::size_t{ 2 }));
+
+        const Vec2D<double> empty(0, 4);
+        REQUIRE_FALSE(vec2d::min(empty.view()));
+        REQUIRE_FALSE(vec2d::argmax(empty.view()));
+
+        // Ties go to the first in row-major order
+        const Vec2D<float> flat(40, 40, 2.5f);
+        REQUIRE(vec2d::argmin(flat.view()) == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+        REQUIRE(vec2d::max(flat.view()) == 2.5f);
+    }
+
+    SECTION("Count")
+    {
+        const auto positive = [](int element) { return element > 0; };
+        const auto expected = static_cast<std::size_t>(std::count_if(grid.begin(), grid.end(), positive));
+        REQUIRE(vec2d::countIf(view, positive) == expected);
+        REQUIRE(vec2d::countIf(std::execution::par, view, positive) == expected);
+        REQUIRE(vec2d::countIf(view.strided(1, 700), positive) == static_cast<std::size_t>(std::count_if(grid.begin(), grid.begin() + 301, positive)));
+    }
+
+    SECTION("A throwing predicate throws on the caller")
+    {
+        const auto throwing = [](int element) -> bool
+        {
+            if (element > 990)
+                throw std::runtime_error("predicate failed");
+            return false;
+        };
+        REQUIRE_THROWS_AS(vec2d::countIf(std::execution::par, view, throwing), std::runtime_error);
+        REQUIRE(vec2d::countIf(std::execution::par, view, [](int) { return true; }) == 301 * 700);
+    }
+}
+
+TEST_CASE("Row and column reductions")
+{
+    const auto grid = randomInts(150, 90, -50, 50);
+    const auto view = grid.view();
+
+    const auto rows = vec2d::rowSums(std::execution::par, view);
+    const auto columns = vec2d::columnSums(std::execution::par, view);
+    REQUIRE(rows.size() == 90);
+    REQUIRE(columns.size() == 150);
+    for (std::size_t y = 0; y < 90; ++y)
+        REQUIRE(rows[y] == naiveSum(grid, 0, y, 150, 1));
+    for (std::size_t x = 0; x < 150; ++x)
+        REQUIRE(columns[x] == naiveSum(grid, x, 0, 1, 90));
+    REQUIRE(vec2d::rowSums(view) == rows);
+    REQUIRE(vec2d::columnSums(view.strided(1, 1)) == columns);
+
+    const auto largest = [](int a, int b) { return std::max(a, b); };
+    const auto rowMaxima = vec2d::reduceRows(std::execution::par, view, std::numeric_limits<int>::lowest(), largest);
+    const auto columnMaxima = vec2d::reduceColumns(view, std::numeric_limits<int>::lowest(), largest);
+    for (std::size_t y = 0; y < 90; ++y)
+        REQUIRE(rowMaxima[y] == vec2d::max(view.row(y)));
+    for (std::size_t x = 0; x < 150; ++x)
+        REQUIRE(columnMaxima[x] == vec2d::max(view.column(x)));
+
+    // Counts per row, the accumulator need not be the element type
+    const auto negatives = vec2d::reduceRows(view.subview(10, 10, 20, 5), std::size_t{ 0 }, [](std::size_t n, int element) { return n + (element < 0); });
+    REQUIRE(negatives.size() == 5);
+    REQUIRE(negatives[2] == vec2d::countIf(view.subview(10, 12, 20, 1), [](int element) { return element < 0; }));
+}
+
+TEST_CASE("Summed-area tables")
+{
+    const auto grid = randomInts(333, 257, -100, 100);
+
+    const vec2d::SummedAreaTable table(grid.view());
+    const vec2d::SummedAreaTable parallelTable(std::execution::par, grid.view());
+    static_assert(std::is_same_v<decltype(table), const vec2d::SummedAreaTable<std::int64_t>>);
+
+    REQUIRE(table.dim() == grid.dim());
+    REQUIRE(table.entries() == parallelTable.entries());
+    REQUIRE(table.total() == vec2d::sum(grid.view()));
+
+    std::mt19937 random(5);
+    for (int i = 0; i < 200; ++i)
+    {
+        const std::size_t x = random() % 334;
+        const std::size_t y = random() % 258;
+        const std::size_t w = random() % (334 - x);
+        const std::size_t h = random() % (258 - y);
+        REQUIRE(table.sum(x, y, w, h) == naiveSum(grid, x, y, w, h));
+    }
+
+    REQUIRE(table.sum(0, 0, 333, 257) == table.total());
+    REQUIRE(table.sum(333, 257, 0, 0) == 0);
+    REQUIRE(table.mean(10, 20, 4, 5) == static_cast<double>(naiveSum(grid, 10, 20, 4, 5)) / 20.0);
+    REQUIRE_THROWS_AS(table.sum(300, 0, 34, 1), std::out_of_range);
+
+    // Tables of regions, and of floats in double
+    const vec2d::SummedAreaTable region(grid.subview(50, 60, 70, 80));
+    REQUIRE(region.sum(5, 6, 7, 8) == naiveSum(grid, 55, 66, 7, 8));
+
+    // Rebuilt in place, or resized
+    auto rebuilt = table;
+    Vec2D<int> changed(grid);
+    changed(100, 100) += 1000;
+    rebuilt.rebuild(std::execution::par, changed.view());
+    REQUIRE(rebuilt.sum(100, 100, 1, 1) == grid(100, 100) + 1000);
+    REQUIRE(rebuilt.total() == table.total() + 1000);
+    rebuilt.rebuild(grid.subview(0, 0, 10, 10));
+    REQUIRE(rebuilt.dim() == std::make_pair(std::size_t{ 10 }, std::size_t{ 10 }));
+    REQUIRE(rebuilt.total() == naiveSum(grid, 0, 0, 10, 10));
+
+    const Vec2D<float> halves(64, 64, 0.5f);
+    const vec2d::SummedAreaTable<double> floats(std::execution::par, halves.view());
+    REQUIRE(floats.sum(1, 1, 10, 10) == 50.0);
+}
+
+TEST_CASE("Reduction throughput", "[.][benchmark]")
+{
+    // 4K x 4K floats, 64 MiB
+    constexpr std::size_t side = 4096;
+    Vec2D<float> grid(side, side);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    for (auto& element : grid)
+        element = distribution(random);
+
+    BENCHMARK("Sum with at()")
+    {
+        double sum = 0;
+        for (std::size_t y = 0; y < side; ++y)
+            for (std::size_t x = 0; x < side; ++x)
+                sum += grid.at(y, x);
+        return sum;
+    };
+
+    BENCHMARK("Vector sum")
+    {
+        return vec2d::sum(grid.view());
+    };
+
+    BENCHMARK("Vector sum, parallel")
+    {
+        return vec2d::sum(std::execution::par, grid.view());
+    };
+
+    BENCHMARK("Vector argmax")
+    {
+        return vec2d::argmax(grid.view());
+    };
+
+    BENCHMARK("Column sums")
+    {
+        return vec2d::columnSums(grid.view());
+    };
+
+    // 10K region sums of 64x64, the per-frame workload
+    std::vector<std::pair<std::size_t, std::size_t>> corners;
+    for (int i = 0; i < 10000; ++i)
+        corners.emplace_back(random() % (side - 64), random() % (side - 64));
+
+    BENCHMARK("10K region sums with at()")
+    {
+        double total = 0;
+        for (const auto& [x0, y0] : corners)
+            for (std::size_t y = y0; y < y0 + 64; ++y)
+                for (std::size_t x = x0; x < x0 + 64; ++x)
+                    total += grid.at(y, x);
+        return total;
+    };
+
+    BENCHMARK("10K region sums with vector sum")
+    {
+        double total = 0;
+        for (const auto& [x0, y0] : corners)
+            total += vec2d::sum(grid.subview(x0, y0, 64, 64));
+        return total;
+    };
+
+    BENCHMARK("Build a summed-area table")
+    {
+        return vec2d::SummedAreaTable(std::execution::par, grid.view()).total();
+    };
+
+    vec2d::SummedAreaTable table(grid.view());
+    BENCHMARK("Rebuild a summed-area table")
+    {
+        table.rebuild(std::execution::par, grid.view());
+        return table.total();
+    };
+
+    BENCHMARK("10K region sums with a summed-area table")
+    {
+        double total = 0;
+        for (const auto& [x0, y0] : corners)
+            total += table.sum(x0, y0, 64, 64);
+        return total;
+    };
+}
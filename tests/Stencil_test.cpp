@@ -0,0 +1,286 @@
+#include "Stencil.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /**
+     * The textbook definition, one bounds-resolved read per tap.
+     */
+    template <typename T>
+    Vec2D<T> naiveConvolve(const Vec2D<T>& src, const vec2d::Kernel<T>& kernel, vec2d::Boundary boundary)
+    {
+        const auto [width, height] = src.dim();
+        const auto [kw, kh] = kernel.dim();
+        Vec2D<T> dst(width, height);
+
+        for (std::size_t y = 0; y < height; ++y)
+        {
+            for (std::size_t x = 0; x < width; ++x)
+            {
+                T sum{};
+                for (std::size_t j = 0; j < kh; ++j)
+                {
+                    for (std::size_t i = 0; i < kw; ++i)
+                    {
+                        const auto sx = vec2d::resolve(static_cast<std::ptrdiff_t>(x + i) - static_cast<std::ptrdiff_t>(kernel.radiusX()), width, boundary);
+                        const auto sy = vec2d::resolve(static_cast<std::ptrdiff_t>(y + j) - static_cast<std::ptrdiff_t>(kernel.radiusY()), height, boundary);
+                        if (sx != width && sy != height)
+                            sum += kernel(i, j) * src(sx, sy);
+                    }
+                }
+                dst(x, y) = sum;
+            }
+        }
+
+        return dst;
+    }
+
+    template <typename T>
+    bool nearlyEqual(const Vec2D<T>& a, const Vec2D<T>& b, T tolerance)
+    {
+        return a.dim() == b.dim() && std::equal(a.begin(), a.end(), b.begin(), [&](T x, T y) { return std::abs(x - y) <= tolerance; });
+    }
+
+    Vec2D<float> randomGrid(std::size_t width, std::size_t height)
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> values(-1.0f, 1.0f);
+
+        Vec2D<float> grid(width, height);
+        for (auto& value : grid)
+            value = values(random);
+        return grid;
+    }
+}
+
+TEST_CASE("Kernels")
+{
+    SECTION("Separable kernels are detected")
+    {
+        const vec2d::Kernel<int> sobel(3, 3, { -1, 0, 1, -2, 0, 2, -1, 0, 1 });
+        REQUIRE(sobel.separableFactors());
+
+        const auto& [horizontal, vertical] = *sobel.separableFactors();
+        for (std::size_t y = 0; y < 3; ++y)
+            for (std::size_t x = 0; x < 3; ++x)
+                REQUIRE(horizontal[x] * vertical[y] == sobel(x, y));
+
+        const auto gaussian = vec2d::Kernel<float>::gaussian(2, 1.0);
+        REQUIRE(gaussian.dim() == std::make_pair(std::size_t{ 5 }, std::size_t{ 5 }));
+        REQUIRE(gaussian.separableFactors());
+
+        const vec2d::Kernel<float> blur(3, 1, { 0.25f, 0.5f, 0.25f });
+        REQUIRE(blur.separableFactors());
+
+        // Integral factors come from whichever side the pivot divides
+        const vec2d::Kernel<int> row(3, 1, { 2, 3, 2 });
+        REQUIRE(row.separableFactors() == std::make_pair(std::vector<int>{ 2, 3, 2 }, std::vector<int>{ 1 }));
+        const vec2d::Kernel<int> column(1, 3, { 6, 9, 6 });
+        REQUIRE(column.separableFactors() == std::make_pair(std::vector<int>{ 1 }, std::vector<int>{ 6, 9, 6 }));
+    }
+
+    SECTION("Other kernels are not")
+    {
+        const vec2d::Kernel<float> laplacian(3, 3, { 0, 1, 0, 1, -4, 1, 0, 1, 0 });
+        REQUIRE_FALSE(laplacian.separableFactors());
+
+        // Rank one, but without integral factors
+        const vec2d::Kernel<int> noIntegralFactors(3, 3, { 4, 6, 4, 6, 9, 6, 4, 6, 4 });
+        REQUIRE_FALSE(noIntegralFactors.separableFactors());
+    }
+
+    SECTION("Invalid kernels")
+    {
+        REQUIRE_THROWS_AS(vec2d::Kernel<int>(2, 3, std::vector<int>(6)), std::invalid_argument);
+        REQUIRE_THROWS_AS(vec2d::Kernel<int>(3, 3, std::vector<int>(8)), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Convolution matches the naive definition")
+{
+    const auto src = randomGrid(70, 37);
+    const vec2d::Kernel<float> laplacian(3, 3, { 0, 1, 0, 1, -4, 1, 0, 1, 0 });
+    const auto gaussian = vec2d::Kernel<float>::gaussian(2, 1.5);
+    const auto wide = vec2d::Kernel<float>::separable({ 1, 2, 3, 2, 1 }, { 1, 0, -1 });
+
+    for (const auto boundary : { vec2d::Boundary::Clamp, vec2d::Boundary::Wrap, vec2d::Boundary::Zero })
+    {
+        for (const auto* kernel : { &laplacian, &gaussian, &wide })
+        {
+            const auto expected = naiveConvolve(src, *kernel, boundary);
+
+            Vec2D<float> dst(70, 37);
+            vec2d::convolve(src.view(), dst.view(), *kernel, boundary);
+            REQUIRE(nearlyEqual(dst, expected, 1e-5f));
+
+            Vec2D<float> parallelDst(70, 37);
+            vec2d::convolve(std::execution::par, src.view(), parallelDst.view(), *kernel, boundary);
+            REQUIRE(parallelDst == dst);
+        }
+    }
+
+    SECTION("Kernels wider than the grid")
+    {
+        const auto tiny = randomGrid(2, 3);
+        const auto big = vec2d::Kernel<float>::gaussian(3, 2.0);
+        for (const auto boundary : { vec2d::Boundary::Clamp, vec2d::Boundary::Wrap, vec2d::Boundary::Zero })
+        {
+            Vec2D<float> dst(2, 3);
+            vec2d::convolve(tiny.view(), dst.view(), big, boundary);
+            REQUIRE(nearlyEqual(dst, naiveConvolve(tiny, big, boundary), 1e-5f));
+        }
+    }
+
+    SECTION("Views")
+    {
+        // A strided source and a sub-grid destination
+        Vec2D<float> dst(70, 37, 100.0f);
+        const auto source = src.view().strided(2, 1);
+        vec2d::convolve(source, dst.subview(1, 0, 35, 37), laplacian, vec2d::Boundary::Wrap);
+
+        const Vec2D<float> dense(source);
+        const auto expected = naiveConvolve(dense, laplacian, vec2d::Boundary::Wrap);
+        REQUIRE(nearlyEqual(Vec2D<float>(dst.subview(1, 0, 35, 37)), expected, 1e-5f));
+        REQUIRE(dst(0, 5) == 100.0f);
+        REQUIRE(dst(36, 5) == 100.0f);
+
+        REQUIRE_THROWS_AS(vec2d::convolve(src.view(), dst.subview(0, 0, 70, 36), laplacian, vec2d::Boundary::Zero), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Stencil rules")
+{
+    SECTION("Game of life on a torus")
+    {
+        Vec2D<int> board(6, 6, 0);
+        board(4, 0) = board(4, 1) = board(4, 5) = 1;	// A blinker across the top / bottom edge
+
+        const auto life = [](const vec2d::Window<int>& cell)
+        {
+            int neighbours = 0;
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    neighbours += (dx != 0 || dy != 0) ? cell(dx, dy) : 0;
+            return neighbours == 3 || (neighbours == 2 && cell.centre() == 1) ? 1 : 0;
+        };
+
+        const Vec2D<int> start(board);
+        vec2d::PingPong<int> grids(std::move(board));
+        grids.step([&](const Vec2D<int>& current, Vec2D<int>& next)
+        {
+            vec2d::stencil(current.view(), next.view(), 1, vec2d::Boundary::Wrap, life);
+        });
+
+        REQUIRE(grids.current()(3, 0) == 1);
+        REQUIRE(grids.current()(4, 0) == 1);
+        REQUIRE(grids.current()(5, 0) == 1);
+        REQUIRE(grids.current()(4, 1) == 0);
+        REQUIRE(grids.current()(4, 5) == 0);
+
+        grids.step([&](const Vec2D<int>& current, Vec2D<int>& next)
+        {
+            vec2d::stencil(std::execution::par, current.view(), next.view(), 1, vec2d::Boundary::Wrap, life);
+        });
+        REQUIRE(grids.current() == start);
+    }
+
+    SECTION("Boundaries")
+    {
+        const Vec2D<int> grid(std::vector<std::vector<int>>{ { 1, 2, 3 }, { 4, 5, 6 } });
+        Vec2D<int> out(3, 2);
+
+        const auto upLeft = [](const vec2d::Window<int>& cell) { return cell(-1, -1); };
+
+        vec2d::stencil(grid.view(), out.view(), 1, vec2d::Boundary::Clamp, upLeft);
+        REQUIRE(out == Vec2D<int>(std::vector<std::vector<int>>{ { 1, 1, 2 }, { 1, 1, 2 } }));
+
+        vec2d::stencil(grid.view(), out.view(), 1, vec2d::Boundary::Wrap, upLeft);
+        REQUIRE(out == Vec2D<int>(std::vector<std::vector<int>>{ { 6, 4, 5 }, { 3, 1, 2 } }));
+
+        vec2d::stencil(grid.view(), out.view(), 1, vec2d::Boundary::Zero, upLeft);
+        REQUIRE(out == Vec2D<int>(std::vector<std::vector<int>>{ { 0, 0, 0 }, { 0, 1, 2 } }));
+    }
+
+    SECTION("Empty grids")
+    {
+        const auto identity = [](const vec2d::Window<float>& cell) { return cell.centre(); };
+        const auto gaussian = vec2d::Kernel<float>::gaussian(1, 1.0);
+        const vec2d::Kernel<float> laplacian(3, 3, { 0, 1, 0, 1, -4, 1, 0, 1, 0 });
+
+        for (const auto& [width, height] : { std::make_pair(0, 4), std::make_pair(4, 0), std::make_pair(0, 0) })
+        {
+            const Vec2D<float> src(width, height);
+            Vec2D<float> dst(width, height);
+            for (const auto boundary : { vec2d::Boundary::Clamp, vec2d::Boundary::Wrap, vec2d::Boundary::Zero })
+            {
+                vec2d::stencil(src.view(), dst.view(), 1, boundary, identity);
+                vec2d::stencil(std::execution::par, src.view(), dst.view(), 2, boundary, identity);
+                vec2d::convolve(src.view(), dst.view(), gaussian, boundary);
+                vec2d::convolve(std::execution::par, src.view(), dst.view(), laplacian, boundary);
+                REQUIRE(dst.empty());
+            }
+        }
+
+        REQUIRE(vec2d::resolve(-1, 0, vec2d::Boundary::Clamp) == 0);
+        REQUIRE(vec2d::resolve(3, 0, vec2d::Boundary::Wrap) == 0);
+    }
+}
+
+TEST_CASE("Stencil throughput", "[.][benchmark]")
+{
+    // 4K x 4K floats
+    constexpr std::size_t side = 4096;
+    const auto src = randomGrid(side, side);
+    Vec2D<float> dst(side, side);
+
+    const auto gaussian = vec2d::Kernel<float>::gaussian(2, 1.0);
+    std::vector<float> weights(25);
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        weights[i] = gaussian(i % 5, i / 5) + (i == 7 ? 0.01f : 0.0f);
+    const vec2d::Kernel<float> general(5, 5, weights);
+
+    BENCHMARK("5x5 with at() and clamped indices")
+    {
+        for (std::size_t y = 0; y < side; ++y)
+        {
+            for (std::size_t x = 0; x < side; ++x)
+            {
+                float sum = 0;
+                for (std::size_t j = 0; j < 5; ++j)
+                {
+                    const std::size_t sy = std::min(side - 1, static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, static_cast<std::ptrdiff_t>(y + j) - 2)));
+                    for (std::size_t i = 0; i < 5; ++i)
+                    {
+                        const std::size_t sx = std::min(side - 1, static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, static_cast<std::ptrdiff_t>(x + i) - 2)));
+                        sum += general(i, j) * src.at(sy, sx);
+                    }
+                }
+                dst.at(y, x) = sum;
+            }
+        }
+        return dst(1, 1);
+    };
+
+    BENCHMARK("5x5 general kernel")
+    {
+        vec2d::convolve(src.view(), dst.view(), general, vec2d::Boundary::Clamp);
+        return dst(1, 1);
+    };
+
+    BENCHMARK("5x5 separable Gaussian")
+    {
+        vec2d::convolve(src.view(), dst.view(), gaussian, vec2d::Boundary::Clamp);
+        return dst(1, 1);
+    };
+
+    BENCHMARK("5x5 separable Gaussian, parallel")
+    {
+        vec2d::convolve(std::execution::par, src.view(), dst.view(), gaussian, vec2d::Boundary::Clamp);
+        return dst(1, 1);
+    };
+}
@@ -1,5 +1,21 @@
 #include "Vec2D.hpp"
+#include "MappedVec2D.hpp"
+#include "SparseVec2D.hpp"
+#include "StaticVec2D.hpp"
+#include "Vec2DFile.hpp"
 #include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 TEST_CASE("Test case 1", "[Vec2D]")
@@ -62,6 +78,66 @@ TEST_CASE("Construction")
         REQUIRE(vec2D(1, 2) == 8);
         REQUIRE(vec2D(2, 2) == 9);
     }
+
+    SECTION("Consuming a raw 2D vector")
+    {
+        std::vector<std::vector<std::string>> rows = {
+            { "a", "long enough not to be stored inline" },
+            { "c" },
+        };
+        Vec2D<std::string> vec2D(std::move(rows));
+        REQUIRE(vec2D.dim() == std::make_pair(std::size_t{ 2 }, std::size_t{ 2 }));
+        REQUIRE(vec2D(1, 0) == "long enough not to be stored inline");
+        REQUIRE(vec2D(0, 1) == "c");
+        REQUIRE(vec2D(1, 1).empty());
+        REQUIRE(rows.empty());
+
+        // Other layouts too
+        Vec2D<int, Tiled<2, 2>> tiled(std::vector<std::vector<int>>{ { 1, 2, 3 }, { 4 } });
+        REQUIRE(tiled(2, 0) == 3);
+        REQUIRE(tiled(2, 1) == 0);
+    }
+
+    SECTION("Adopting a flat buffer")
+    {
+        std::vector<int> buffer(12, 7);
+        const int* elements = buffer.data();
+        Vec2D<int> vec2D(vec2d::adopt, 4, 3, std::move(buffer));
+        REQUIRE(vec2D.getData().data() == elements);
+        REQUIRE_THROWS_AS(Vec2D<int>(vec2d::adopt, 4, 4, std::vector<int>(12)), std::invalid_argument);
+
+        // Braced default values stay unambiguous
+        const Vec2D<int> fives(3, 3, { 5 });
+        REQUIRE(fives(2, 2) == 5);
+        const Vec2D<int> zeros(3, 3, {});
+        REQUIRE(zeros(2, 2) == 0);
+
+        // The default storage is a plain std::vector<T>
+        std::vector<int>& data = vec2D.getData();
+        REQUIRE(data.size() == 12);
+    }
+
+    SECTION("Uninitialized and moved-from grids")
+    {
+        Vec2D<float> vec2D(vec2d::uninitialized, 6, 5);
+        REQUIRE(vec2D.dim() == std::make_pair(std::size_t{ 6 }, std::size_t{ 5 }));
+        REQUIRE(vec2D.getData().size() == 30);
+        vec2D.fill(1.5f);
+
+        Vec2D<float> moved(std::move(vec2D));
+        REQUIRE(moved(5, 4) == 1.5f);
+        REQUIRE(vec2D.dim() == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+        REQUIRE(vec2D.empty());
+
+        vec2D = std::move(moved);
+        REQUIRE(vec2D(5, 4) == 1.5f);
+        REQUIRE(moved.dim() == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+
+        DefaultInitVec2D<float> defaultInit(std::execution::par, 6, 5, 2.5f);
+        REQUIRE(defaultInit(5, 4) == 2.5f);
+        defaultInit = DefaultInitVec2D<float>(vec2d::uninitialized, 3, 2);
+        REQUIRE(defaultInit.getData().size() == 6);
+    }
 }
 
 TEST_CASE("Modifiers")
@@ -86,6 +162,67 @@ TEST_CASE("Modifiers")
     {
         vec2D.clear();
         REQUIRE(vec2D.empty());
+        REQUIRE(vec2D.dim() == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+    }
+
+    SECTION("Resize")
+    {
+        // Every combination of growing and shrinking, in place or not
+        const auto check = [](auto grid, std::size_t w, std::size_t h, bool reserve)
+        {
+            using Grid = decltype(grid);
+            const auto [oldWidth, oldHeight] = grid.dim();
+            const Grid original(grid);
+            if (reserve)
+                grid.reserve(w * h);
+
+            grid.resize(w, h, -1);
+            REQUIRE(grid.dim() == std::make_pair(w, h));
+            bool kept = true;
+            for (std::size_t y = 0; y < h; ++y)
+                for (std::size_t x = 0; x < w; ++x)
+                    kept = kept && grid(x, y) == (x < oldWidth && y < oldHeight ? original(x, y) : -1);
+            REQUIRE(kept);
+        };
+
+        Vec2D<int> numbered(7, 5);
+        std::iota(numbered.begin(), numbered.end(), 0);
+        Vec2D<int, Tiled<4, 4>> tiled(7, 5);
+        std::iota(tiled.begin(), tiled.end(), 0);
+
+        for (const auto& [w, h] : { std::make_pair(10, 5), std::make_pair(4, 5), std::make_pair(7, 9), std::make_pair(7, 2),
+                 std::make_pair(10, 3), std::make_pair(3, 10), std::make_pair(12, 12), std::make_pair(1, 1), std::make_pair(0, 4) })
+        {
+            check(numbered, w, h, false);
+            check(numbered, w, h, true);
+            check(tiled, w, h, false);
+        }
+
+        // Rows growing in place keep the buffer
+        numbered.reserve(100);
+        const int* elements = numbered.getData().data();
+        numbered.resize(10, 10);
+        REQUIRE(numbered.getData().data() == elements);
+        REQUIRE(numbered(6, 4) == 34);
+        REQUIRE(numbered(7, 4) == 0);
+
+        Vec2D<std::string> strings(std::vector<std::vector<std::string>>{ { "a", "b" }, { "c", "d" } });
+        strings.resize(3, 1, "e");
+        REQUIRE(strings(1, 0) == "b");
+        REQUIRE(strings(2, 0) == "e");
+    }
+
+    SECTION("Reshape")
+    {
+        Vec2D<int> grid(6, 2);
+        std::iota(grid.begin(), grid.end(), 0);
+        const int* elements = grid.getData().data();
+        grid.reshape(3, 4);
+        REQUIRE(grid.dim() == std::make_pair(std::size_t{ 3 }, std::size_t{ 4 }));
+        REQUIRE(grid(2, 1) == 5);
+        REQUIRE(grid(0, 3) == 9);
+        REQUIRE(grid.getData().data() == elements);
+        REQUIRE_THROWS_AS(grid.reshape(5, 2), std::invalid_argument);
     }
 }
 
@@ -223,4 +360,1617 @@ TEST_CASE("Hash function")
     REQUIRE(set.count(vec) == 1);
     REQUIRE(set.count(vec2) == 1);
     REQUIRE(set.count(vec3) == 1);
-}
\ No newline at end of file
+
+    SECTION("Position and dimensions are hashed")
+    {
+        const auto hash = std::hash<Vec2D<int>>();
+
+        // Same elements, moved around
+        Vec2D<int> swapped(rvec);
+        std::swap(swapped(0, 0), swapped(2, 2));
+        Vec2D<int> transposed(rvec);
+        transposed.transpose();
+        REQUIRE(hash(swapped) != hash(vec));
+        REQUIRE(hash(transposed) != hash(vec));
+
+        // Same elements, other shapes
+        const Vec2D<int> row(4, 1, 7);
+        const Vec2D<int> column(1, 4, 7);
+        const Vec2D<int> square(2, 2, 7);
+        REQUIRE(hash(row) != hash(column));
+        REQUIRE(hash(row) != hash(square));
+        REQUIRE(hash(Vec2D<int>(0, 3)) != hash(Vec2D<int>(3, 0)));
+
+        // -0 equals 0, so hashes as 0
+        REQUIRE(std::hash<Vec2D<float>>()(Vec2D<float>(3, 2, -0.0f)) == std::hash<Vec2D<float>>()(Vec2D<float>(3, 2, 0.0f)));
+    }
+
+    SECTION("Incremental updates")
+    {
+        Vec2D<int> grid(300, 200, 0);
+        std::size_t h = grid.hash(std::execution::par);
+
+        std::mt19937 random(21);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::size_t x = random() % 300;
+            const std::size_t y = random() % 200;
+            const int value = static_cast<int>(random() % 5);
+            h = grid.updateHash(h, x, y, grid(x, y), value);
+            grid(x, y) = value;
+        }
+
+        REQUIRE(h == grid.hash(std::execution::seq));
+        REQUIRE(h == grid.hash(std::execution::par));
+    }
+
+    SECTION("Boards hash apart")
+    {
+        // Every placement of three pieces on a 4x4 board, as a dedup cache would see them
+        std::unordered_set<std::size_t> hashes;
+        std::size_t boards = 0;
+        for (std::size_t a = 0; a < 16; ++a)
+            for (std::size_t b = 0; b < 16; ++b)
+                for (std::size_t c = 0; c < 16; ++c)
+                {
+                    if (a == b || a == c || b == c)
+                        continue;
+
+                    Vec2D<int> board(4, 4, 0);
+                    board(a % 4, a / 4) = 1;
+                    board(b % 4, b / 4) = 2;
+                    board(c % 4, c / 4) = 2;
+                    hashes.insert(std::hash<Vec2D<int>>()(board));
+                    ++boards;
+                }
+
+        // Pieces 2 and 3 are interchangeable, so every board is seen twice
+        REQUIRE(hashes.size() == boards / 2);
+    }
+}
+
+TEST_CASE("Element-wise arithmetic")
+{
+    Vec2D<int> vec2D1(3, 3, 6);
+    Vec2D<int> vec2D2(3, 3, 2);
+
+    SECTION("Grid operands")
+    {
+        REQUIRE((vec2D1 * vec2D2).at(1, 1) == 12);
+        REQUIRE((vec2D1 / vec2D2).at(1, 1) == 3);
+
+        vec2D2.at(0, 0) = 9;
+        REQUIRE(Vec2D<int>(vec2D1).minWith(vec2D2).at(0, 0) == 6);
+        REQUIRE(Vec2D<int>(vec2D1).minWith(vec2D2).at(2, 2) == 2);
+        REQUIRE(Vec2D<int>(vec2D1).maxWith(vec2D2).at(0, 0) == 9);
+        REQUIRE(Vec2D<int>(vec2D1).maxWith(vec2D2).at(2, 2) == 6);
+    }
+
+    SECTION("Scalar operands")
+    {
+        REQUIRE((vec2D1 + 1).at(2, 2) == 7);
+        REQUIRE((vec2D1 - 1).at(2, 2) == 5);
+        REQUIRE((vec2D1 * 2).at(2, 2) == 12);
+        REQUIRE((2 * vec2D1).at(2, 2) == 12);
+        REQUIRE((vec2D1 / 2).at(2, 2) == 3);
+        REQUIRE(Vec2D<int>(vec2D1).minWith(4).at(0, 0) == 4);
+        REQUIRE(Vec2D<int>(vec2D1).maxWith(8).at(0, 0) == 8);
+    }
+
+    SECTION("Clamp")
+    {
+        std::vector<std::vector<int>> rvec = { { -5, 0, 5, 10, 15 } };
+        Vec2D<int> vec(rvec);
+        vec.clamp(0, 10);
+        REQUIRE(vec == Vec2D<int>(std::vector<std::vector<int>>{ { 0, 0, 5, 10, 10 } }));
+    }
+
+    SECTION("Multiply-add")
+    {
+        vec2D1.multiplyAdd(vec2D2, vec2D2);
+        REQUIRE(vec2D1.at(1, 2) == 10);
+
+        vec2D1.multiplyAdd(3, -1);
+        REQUIRE(vec2D1.at(1, 2) == 29);
+    }
+}
+
+TEST_CASE("Expressions")
+{
+    Vec2D<int> a(3, 2, 1);
+    Vec2D<int> b(3, 2, 2);
+    Vec2D<int> c(3, 2, 3);
+
+    SECTION("Evaluated on assignment")
+    {
+        Vec2D<int> result = a + b * c - 4 / a;
+        REQUIRE(result.dim() == std::make_pair(std::size_t{ 3 }, std::size_t{ 2 }));
+        REQUIRE(result.at(1, 2) == 3);
+    }
+
+    SECTION("Lazy element access")
+    {
+        auto expr = (a + b) * 2;
+        REQUIRE(expr.at(1, 1) == 6);
+        REQUIRE(expr(2, 1) == 6);
+
+        // Referenced grids are read at evaluation time
+        a.fill(5);
+        REQUIRE(expr.at(1, 1) == 14);
+    }
+
+    SECTION("Temporaries are owned by the expression")
+    {
+        auto expr = Vec2D<int>(3, 2, 10) - a;
+        Vec2D<int> result(expr);
+        REQUIRE(result.at(0, 0) == 9);
+    }
+
+    SECTION("Assignment may alias")
+    {
+        a = a + a * b;
+        REQUIRE(a.at(1, 2) == 3);
+
+        a += b * c;
+        REQUIRE(a.at(1, 2) == 9);
+
+        a = Vec2D<int>(1, 1, 7) + 1;
+        REQUIRE(a.dim() == std::make_pair(std::size_t{ 1 }, std::size_t{ 1 }));
+        REQUIRE(a.at(0, 0) == 8);
+    }
+}
+
+TEST_CASE("Execution policies")
+{
+    // Wide and tall enough to be split into many row blocks
+    constexpr std::size_t width = 1000;
+    constexpr std::size_t height = 300;
+
+    Vec2D<int> grid(std::execution::par, width, height, 3);
+    REQUIRE(grid.dim() == std::make_pair(width, height));
+    REQUIRE(grid == Vec2D<int>(width, height, 3));
+
+    SECTION("Fill")
+    {
+        grid.fill(std::execution::par, 7);
+        REQUIRE(grid == Vec2D<int>(width, height, 7));
+    }
+
+    SECTION("Find returns the first match in row-major order")
+    {
+        REQUIRE_FALSE(grid.find(std::execution::par, 9));
+
+        grid.at(250, 10) = 9;
+        grid.at(120, 900) = 9;
+        grid.at(120, 901) = 9;
+        REQUIRE(grid.find(std::execution::par, 9) == std::make_pair(std::size_t{ 900 }, std::size_t{ 120 }));
+        REQUIRE(grid.find(std::execution::par, 9) == grid.find(9));
+        REQUIRE(grid.find(std::execution::seq, 9) == grid.find(9));
+    }
+
+    SECTION("Arithmetic, equality and hash")
+    {
+        Vec2D<int> other(width, height, 2);
+        other.at(299, 999) = 5;
+
+        Vec2D<int> expected(grid);
+        expected += other;
+        grid.add(std::execution::par, other);
+        REQUIRE(grid.equals(std::execution::par, expected));
+        REQUIRE(grid.hash(std::execution::par) == std::hash<Vec2D<int>>()(expected));
+
+        grid.subtract(std::execution::par_unseq, other);
+        REQUIRE(grid.at(299, 999) == 3);
+        REQUIRE_FALSE(grid.equals(std::execution::par, expected));
+        REQUIRE_FALSE(grid.equals(std::execution::par, Vec2D<int>(height, width, 3)));
+    }
+
+    SECTION("A throwing task is rethrown on the caller")
+    {
+        parallel::ThreadPool pool(4);
+        std::atomic<std::size_t> ran{ 0 };
+
+        const auto throwing = [&](std::size_t i)
+        {
+            ++ran;
+            if (i % 7 == 3)
+                throw std::runtime_error("task failed");
+        };
+        REQUIRE_THROWS_AS(pool.run(64, throwing), std::runtime_error);
+        REQUIRE(ran <= 64);
+
+        // The pool is left in a usable state
+        std::vector<int> hits(64, 0);
+        pool.run(hits.size(), [&](std::size_t i) { ++hits[i]; });
+        REQUIRE(std::all_of(hits.begin(), hits.end(), [](int n) { return n == 1; }));
+    }
+}
+
+TEST_CASE("Layouts")
+{
+    // Odd sizes leave partial edge tiles and padded Morton blocks
+    constexpr std::size_t width = 37;
+    constexpr std::size_t height = 21;
+
+    Vec2D<int> reference(width, height);
+    for (std::size_t y = 0; y < height; ++y)
+        for (std::size_t x = 0; x < width; ++x)
+            reference(x, y) = static_cast<int>(x + y * width);
+
+    const auto check = [&](auto grid)
+    {
+        using Grid = decltype(grid);
+        using Layout = typename Grid::layout_type;
+
+        // Every element has its own slot
+        std::unordered_set<std::size_t> slots;
+        for (std::size_t y = 0; y < height; ++y)
+            for (std::size_t x = 0; x < width; ++x)
+                slots.insert(Layout::index(x, y, width, height));
+        REQUIRE(slots.size() == width * height);
+        REQUIRE(*std::max_element(slots.begin(), slots.end()) < Layout::size(width, height));
+
+        for (std::size_t y = 0; y < height; ++y)
+            for (std::size_t x = 0; x < width; ++x)
+                grid(x, y) = reference(x, y);
+
+        // Iteration is row-major whatever the storage order
+        REQUIRE(std::equal(grid.begin(), grid.end(), reference.begin(), reference.end()));
+        REQUIRE(std::equal(grid.rbegin(), grid.rend(), reference.rbegin(), reference.rend()));
+
+        REQUIRE(grid.find(40) == std::make_pair(std::size_t{ 3 }, std::size_t{ 1 }));
+        grid.at(20, 1) = 40;
+        REQUIRE(grid.find(40) == std::make_pair(std::size_t{ 3 }, std::size_t{ 1 }));
+        REQUIRE(grid.find(std::execution::par, 40) == grid.find(40));
+        grid.at(20, 1) = reference.at(20, 1);
+
+        // Arithmetic and expressions only touch real elements, never padding
+        Grid ones(width, height, 1);
+        Grid result = grid * 2 + ones;
+        result -= ones;
+        result /= 2;
+        REQUIRE(result == grid);
+        REQUIRE(result.at(20, 36) == reference.at(20, 36));
+        REQUIRE((grid + ones).at(20, 36) == reference.at(20, 36) + 1);
+        REQUIRE(std::hash<Grid>()(grid) == std::hash<Vec2D<int>>()(reference));
+
+        result.add(std::execution::par, ones);
+        REQUIRE(result != grid);
+        REQUIRE(result.at(5, 5) == reference.at(5, 5) + 1);
+    };
+
+    SECTION("Row-major")
+    {
+        check(Vec2D<int>(width, height));
+    }
+
+    SECTION("Tiled")
+    {
+        check(Vec2D<int, Tiled<8, 4>>(width, height));
+        check(Vec2D<int, Tiled<>>(width, height));
+    }
+
+    SECTION("Morton")
+    {
+        check(Vec2D<int, Morton>(width, height));
+
+        // Tall grids stack their square blocks vertically
+        std::unordered_set<std::size_t> slots;
+        for (std::size_t y = 0; y < width; ++y)
+            for (std::size_t x = 0; x < height; ++x)
+                slots.insert(Morton::index(x, y, height, width));
+        REQUIRE(slots.size() == width * height);
+
+        std::size_t covered = 0;
+        Morton::forEachRun(height, width, 0, width, [&](std::size_t, std::size_t length) { covered += length; });
+        REQUIRE(covered == width * height);
+    }
+
+    SECTION("Expressions across layouts are evaluated by position")
+    {
+        Vec2D<int> a(10, 3);
+        Vec2D<int> b(10, 3, 100);
+        for (std::size_t y = 0; y < 3; ++y)
+            for (std::size_t x = 0; x < 10; ++x)
+                a(x, y) = static_cast<int>(x + y * 10);
+
+        Vec2D<int, Tiled<4, 4>> tiled = a + b;
+        REQUIRE(std::equal(tiled.begin(), tiled.end(), a.begin(), a.end(), [](int t, int r) { return t == r + 100; }));
+
+        tiled = a.view();
+        REQUIRE(std::equal(tiled.begin(), tiled.end(), a.begin(), a.end()));
+        tiled += b.subview(0, 0, 10, 3);
+        REQUIRE(tiled.at(2, 9) == 129);
+
+        Vec2D<int, Morton> morton(10, 3, 1);
+        morton *= a.view();
+        REQUIRE(std::equal(morton.begin(), morton.end(), a.begin(), a.end()));
+
+        // And back into row-major grids and views
+        const Vec2D<int> rowMajor = tiled - 100;
+        REQUIRE(rowMajor == a);
+        Vec2D<int> target(10, 3, 0);
+        target.view().assign(tiled * 2);
+        REQUIRE(target.at(2, 9) == 258);
+    }
+
+    SECTION("Tiles cover every element once")
+    {
+        Vec2D<int, Tiled<8, 4>> grid(width, height, 0);
+        std::size_t tiles = 0;
+        grid.forEachTile([&](const Vec2DTile<int>& tile)
+        {
+            ++tiles;
+            for (std::size_t row = 0; row < tile.height; ++row)
+                for (std::size_t col = 0; col < tile.width; ++col)
+                    tile.at(row, col) += static_cast<int>(tile.x + col + (tile.y + row) * width) + 1;
+        });
+
+        REQUIRE(tiles == 5 * 6);
+        grid -= 1;
+        REQUIRE(std::equal(grid.begin(), grid.end(), reference.begin()));
+
+        std::size_t elements = 0;
+        reference.forEachTile([&](const Vec2DTile<const int>& tile)
+        {
+            REQUIRE(tile.stride == width);
+            REQUIRE(tile(0, 0) == reference(tile.x, tile.y));
+            elements += tile.width * tile.height;
+        });
+        REQUIRE(elements == width * height);
+    }
+}
+
+TEST_CASE("Views")
+{
+    // 6 x 4 grid holding 10 * y + x
+    Vec2D<int> grid(6, 4);
+    for (std::size_t y = 0; y < 4; ++y)
+        for (std::size_t x = 0; x < 6; ++x)
+            grid(x, y) = static_cast<int>(10 * y + x);
+    const Vec2D<int> original(grid);
+
+    SECTION("Slicing, striding, rows and columns")
+    {
+        Vec2DView<int> sub = grid.subview(1, 1, 4, 2);
+        REQUIRE(sub.dim() == std::make_pair(std::size_t{ 4 }, std::size_t{ 2 }));
+        REQUIRE(sub(0, 0) == 11);
+        REQUIRE(sub.at(1, 3) == 24);
+        REQUIRE(sub.stride() == 6);
+
+        REQUIRE(sub.subview(1, 1, 2, 1)(1, 0) == 23);
+        REQUIRE(sub.row(1)(2, 0) == 23);
+        REQUIRE(sub.column(3).dim() == std::make_pair(std::size_t{ 1 }, std::size_t{ 2 }));
+        REQUIRE(sub.column(3)(0, 1) == 24);
+
+        auto every2nd = grid.view().strided(2, 3);
+        REQUIRE(every2nd.dim() == std::make_pair(std::size_t{ 3 }, std::size_t{ 2 }));
+        REQUIRE(every2nd(2, 1) == 34);
+
+        // Views write through to the grid
+        sub(0, 0) = -1;
+        REQUIRE(grid(1, 1) == -1);
+
+        REQUIRE_THROWS_AS(sub.subview(2, 0, 3, 1), std::out_of_range);
+        REQUIRE_THROWS_AS(grid.subview(0, 0, 6, 5), std::out_of_range);
+        REQUIRE_THROWS_AS(sub.strided(0, 1), std::invalid_argument);
+    }
+
+    SECTION("Const views")
+    {
+        ConstVec2DView<int> view = original.subview(2, 2, 2, 2);
+        REQUIRE(view(1, 1) == 33);
+
+        ConstVec2DView<int> fromMutable = grid.view();
+        REQUIRE(fromMutable(5, 3) == 35);
+    }
+
+    SECTION("Fill and find")
+    {
+        auto sub = grid.subview(2, 1, 3, 3);
+        REQUIRE(sub.find(23) == std::make_pair(std::size_t{ 1 }, std::size_t{ 1 }));
+        REQUIRE_FALSE(sub.find(10));
+
+        sub.strided(2, 1).fill(0);
+        REQUIRE(grid(2, 1) == 0);
+        REQUIRE(grid(3, 1) == 13);
+        REQUIRE(grid(4, 3) == 0);
+        REQUIRE(sub.find(0) == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+        REQUIRE(grid.find(0) == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+
+        sub.fill(7);
+        REQUIRE(grid(2, 1) == 7);
+        REQUIRE(grid(4, 3) == 7);
+        REQUIRE(grid(5, 3) == 35);
+    }
+
+    SECTION("Arithmetic")
+    {
+        auto left = grid.subview(0, 0, 3, 4);
+        auto right = grid.subview(3, 0, 3, 4);
+
+        // Lazy expressions mix views, grids and scalars
+        Vec2D<int> sum = left + right * 2;
+        REQUIRE(sum.dim() == std::make_pair(std::size_t{ 3 }, std::size_t{ 4 }));
+        REQUIRE(sum(1, 2) == 21 + 2 * 24);
+
+        Vec2D<int> copy(right);
+        REQUIRE(copy(0, 0) == 3);
+        copy += left;
+        REQUIRE(copy(2, 3) == 35 + 32);
+
+        left += right;
+        REQUIRE(grid(2, 3) == 32 + 35);
+        REQUIRE(grid(5, 3) == 35);
+
+        left -= Vec2D<int>(3, 4, 1);
+        left *= 2;
+        right.column(0) /= 3;
+        REQUIRE(grid(0, 0) == 2 * (0 + 3 - 1));
+        REQUIRE(grid(3, 1) == 13 / 3);
+
+        right.assign(original.subview(0, 0, 3, 4) * 10);
+        REQUIRE(grid(4, 2) == 210);
+        REQUIRE(grid.subview(3, 0, 3, 4).find(210) == std::make_pair(std::size_t{ 1 }, std::size_t{ 2 }));
+    }
+}
+
+TEST_CASE("Transpose, rotations and flips")
+{
+    // Sizes around the block and register tile sides, square and not
+    const std::size_t sides[] = { 1, 3, 4, 31, 32, 33, 70, 129 };
+    const std::size_t others[] = { 1, 7, 64, 100 };
+
+    const auto fill = [](auto& grid)
+    {
+        const auto [width, height] = grid.dim();
+        for (std::size_t y = 0; y < height; ++y)
+            for (std::size_t x = 0; x < width; ++x)
+                grid(x, y) = static_cast<typename std::decay_t<decltype(grid)>::value_type>(x + y * 1000);
+    };
+
+    const auto check = [&](auto grid)
+    {
+        fill(grid);
+        const auto [w, h] = grid.dim();
+        const auto source = grid;
+
+        const auto transposed = grid.transposed();
+        const auto rotated90 = grid.rotated90();
+        const auto rotated180 = grid.rotated180();
+        const auto rotated270 = grid.rotated270();
+        const auto flippedHorizontal = grid.flippedHorizontal();
+        const auto flippedVertical = grid.flippedVertical();
+
+        REQUIRE(transposed.dim() == std::make_pair(h, w));
+        REQUIRE(rotated90.dim() == std::make_pair(h, w));
+        REQUIRE(rotated180.dim() == std::make_pair(w, h));
+
+        bool matches = true;
+        for (std::size_t y = 0; y < h; ++y)
+        {
+            for (std::size_t x = 0; x < w; ++x)
+            {
+                const auto v = source(x, y);
+                matches = matches && transposed(y, x) == v;
+                matches = matches && rotated90(h - 1 - y, x) == v;
+                matches = matches && rotated180(w - 1 - x, h - 1 - y) == v;
+                matches = matches && rotated270(y, w - 1 - x) == v;
+                matches = matches && flippedHorizontal(w - 1 - x, y) == v;
+                matches = matches && flippedVertical(x, h - 1 - y) == v;
+            }
+        }
+        REQUIRE(matches);
+
+        // In place versions agree with the out of place ones
+        REQUIRE(Vec2D(source).transpose() == transposed);
+        REQUIRE(Vec2D(source).rotate90() == rotated90);
+        REQUIRE(Vec2D(source).rotate180() == rotated180);
+        REQUIRE(Vec2D(source).rotate270() == rotated270);
+        REQUIRE(Vec2D(source).flipHorizontal() == flippedHorizontal);
+        REQUIRE(Vec2D(source).flipVertical() == flippedVertical);
+        REQUIRE(Vec2D(source).rotate90().rotate90().rotate90().rotate90() == source);
+    };
+
+    for (const std::size_t side : sides)
+    {
+        for (const std::size_t other : others)
+        {
+            check(Vec2D<float>(side, other));
+            check(Vec2D<double>(other, side));
+        }
+
+        check(Vec2D<std::int16_t>(side, side));
+        check(Vec2D<int>(side, side));
+    }
+}
+
+TEST_CASE("Transforms between views")
+{
+    Vec2D<int> grid(8, 6);
+    for (std::size_t y = 0; y < 6; ++y)
+        for (std::size_t x = 0; x < 8; ++x)
+            grid(x, y) = static_cast<int>(10 * y + x);
+
+    Vec2D<int> out(6, 8, -1);
+
+    SECTION("Into a sub-grid")
+    {
+        Vec2D<int> small(3, 2, 0);
+        vec2d::transpose(grid.subview(1, 1, 2, 3), small.subview(0, 0, 3, 2));
+        REQUIRE(small(0, 0) == 11);
+        REQUIRE(small(2, 1) == 32);
+
+        vec2d::rotate90(grid.subview(1, 1, 2, 3), small.view());
+        REQUIRE(small(0, 0) == 31);
+        REQUIRE(small(2, 1) == 12);
+    }
+
+    SECTION("Strided views")
+    {
+        const auto every2nd = grid.view().strided(2, 1);
+        Vec2D<int> result(6, 4);
+        vec2d::transpose(every2nd, result.view());
+        REQUIRE(result(5, 3) == 56);
+
+        vec2d::flipHorizontal(every2nd, Vec2D<int>(4, 6).view());
+        vec2d::transposeInPlace(grid.subview(0, 0, 6, 6).strided(2, 2));
+        REQUIRE(grid(2, 0) == 20);
+        REQUIRE(grid(0, 2) == 2);
+    }
+
+    SECTION("Large elements are swapped in place")
+    {
+        using Element = std::array<std::uint64_t, 8>;
+        Vec2D<Element> large(70, 70);
+        for (std::size_t y = 0; y < 70; ++y)
+            for (std::size_t x = 0; x < 70; ++x)
+                large(x, y) = Element{ x, y };
+
+        large.transpose();
+        REQUIRE(large(3, 65) == Element{ 65, 3 });
+        REQUIRE(large(69, 0) == Element{ 0, 69 });
+    }
+
+    SECTION("Dimensions are checked")
+    {
+        REQUIRE_THROWS_AS(vec2d::transpose(grid.view(), grid.view()), std::invalid_argument);
+        REQUIRE_THROWS_AS(vec2d::flipVertical(grid.view(), out.view()), std::invalid_argument);
+        REQUIRE_THROWS_AS(vec2d::transposeInPlace(grid.view()), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Sparse grids")
+{
+    // A million by a million, only the top level of the chunk table is allocated
+    SparseVec2D<int> world(1000000, 1000000, -1);
+    REQUIRE(world.dim() == std::make_pair(std::size_t{ 1000000 }, std::size_t{ 1000000 }));
+    REQUIRE(world.empty());
+
+    const auto& constWorld = world;
+    REQUIRE(constWorld(999999, 999999) == -1);
+    REQUIRE(constWorld.at(5, 123456) == -1);
+    REQUIRE(world.chunkCount() == 0);
+
+    SECTION("Writes populate chunks")
+    {
+        world(999999, 999999) = 7;
+        world.at(70, 130) = 3;
+        world.set(131, 70, 4);
+        world.set(500000, 500000, -1);	// The default, nothing to store
+        REQUIRE(world.chunkCount() == 2);
+
+        REQUIRE(constWorld(999999, 999999) == 7);
+        REQUIRE(constWorld(130, 70) == 3);
+        REQUIRE(constWorld(131, 70) == 4);
+        REQUIRE(constWorld(132, 70) == -1);
+        REQUIRE(constWorld(999998, 999999) == -1);
+
+        std::size_t populated = 0;
+        world.forEachChunk([&](const Vec2DTile<int>& tile)
+        {
+            ++populated;
+            REQUIRE(tile.width == 64);
+            for (std::size_t row = 0; row < tile.height; ++row)
+                for (std::size_t col = 0; col < tile.width; ++col)
+                    tile.at(row, col) += 1;
+        });
+        REQUIRE(populated == 2);
+        REQUIRE(constWorld(130, 70) == 4);
+        REQUIRE(constWorld(0, 0) == -1);
+    }
+
+    SECTION("Edge chunks are clipped")
+    {
+        SparseVec2D<char, 8, 4> small(10, 5, '.');
+        small(9, 4) = '#';
+
+        small.forEachChunk([](const Vec2DTile<char>& tile)
+        {
+            REQUIRE(tile.x == 8);
+            REQUIRE(tile.y == 4);
+            REQUIRE(tile.width == 2);
+            REQUIRE(tile.height == 1);
+            REQUIRE(tile(1, 0) == '#');
+        });
+    }
+
+    SECTION("Find")
+    {
+        REQUIRE_FALSE(world.find(5));
+        REQUIRE(world.find(-1) == std::make_pair(std::size_t{ 0 }, std::size_t{ 0 }));
+
+        // Row-major order across chunks, whatever order they were populated in
+        world(700000, 3) = 5;
+        world(200, 10) = 5;
+        world(300000, 2) = 5;
+        REQUIRE(world.find(5) == std::make_pair(std::size_t{ 300000 }, std::size_t{ 2 }));
+
+        // Default cells inside populated chunks count too
+        SparseVec2D<int, 4, 4> full(8, 4, 0);
+        for (std::size_t y = 0; y < 4; ++y)
+            for (std::size_t x = 0; x < 8; ++x)
+                full(x, y) = 1;
+        REQUIRE_FALSE(full.find(0));
+        full(6, 1) = 0;
+        full(1, 2) = 0;
+        REQUIRE(full.find(0) == std::make_pair(std::size_t{ 6 }, std::size_t{ 1 }));
+    }
+
+    SECTION("Copies and clear")
+    {
+        world(12, 34) = 56;
+        auto copy = world;
+        copy(12, 34) = 0;
+        REQUIRE(world(12, 34) == 56);
+        REQUIRE(copy.chunkCount() == 1);
+
+        world.clear();
+        REQUIRE(world.empty());
+        REQUIRE(constWorld(12, 34) == -1);
+
+        // Chunks come back from the pool filled with the default value
+        world(13, 34) = 1;
+        REQUIRE(constWorld(12, 34) == -1);
+    }
+}
+
+TEST_CASE("Static grids")
+{
+    using Board = StaticVec2D<std::uint8_t, 8, 8>;
+    using Chunk = StaticVec2D<int, 16, 16>;
+
+    // No heap, no runtime dimensions, aligned
+    static_assert(sizeof(Board) == 64 && alignof(Board) == 64);
+    static_assert(sizeof(Chunk) == 16 * 16 * sizeof(int) && alignof(Chunk) == 64);
+    static_assert(alignof(StaticVec2D<std::uint8_t, 2, 2>) == 4);
+    static_assert(Board::dim() == std::make_pair(std::size_t{ 8 }, std::size_t{ 8 }));
+
+    SECTION("Usable in constant expressions")
+    {
+        constexpr StaticVec2D<int, 3, 2> grid{ { 1, 2, 3 }, { 4, 5 } };
+        static_assert(grid(2, 0) == 3 && grid.at(1, 1) == 5 && grid(2, 1) == 0);
+        static_assert(grid.find(5) == std::make_pair(std::size_t{ 1 }, std::size_t{ 1 }));
+        static_assert(!grid.find(9));
+
+        constexpr auto doubled = grid * 2 + grid;
+        static_assert(doubled(0, 1) == 12);
+        constexpr auto transposed = grid.transposed();
+        static_assert(transposed.dim() == std::make_pair(std::size_t{ 2 }, std::size_t{ 3 }));
+        static_assert(transposed(0, 2) == 3 && transposed(1, 1) == 5);
+        static_assert(grid.rotated180().rotated180() == grid);
+        static_assert(grid.rotated90().rotated270() == grid);
+
+        constexpr Board empty;
+        static_assert(!empty.find(1) && empty == Board(0));
+        REQUIRE_THROWS_AS((StaticVec2D<int, 2, 1>{ { 1, 2, 3 } }), std::invalid_argument);
+    }
+
+    SECTION("Matches Vec2D")
+    {
+        std::mt19937 random(24);
+        Chunk a;
+        Chunk b;
+        Vec2D<int> dynamicA(16, 16);
+        Vec2D<int> dynamicB(16, 16);
+        for (std::size_t y = 0; y < 16; ++y)
+        {
+            for (std::size_t x = 0; x < 16; ++x)
+            {
+                a(x, y) = dynamicA(x, y) = static_cast<int>(random() % 100);
+                b(x, y) = dynamicB(x, y) = static_cast<int>(random() % 100) + 1;
+            }
+        }
+
+        const auto same = [](const Chunk& grid, const Vec2D<int>& expected)
+        {
+            return std::equal(grid.begin(), grid.end(), expected.begin());
+        };
+
+        REQUIRE(same(a + b, Vec2D<int>(dynamicA + dynamicB)));
+        REQUIRE(same(a * b - a, Vec2D<int>(dynamicA * dynamicB - dynamicA)));
+        REQUIRE(same(Chunk(a).minWith(b).clamp(10, 50), Vec2D<int>(dynamicA).minWith(dynamicB).clamp(10, 50)));
+        REQUIRE(same(a.rotated90(), dynamicA.rotated90()));
+        REQUIRE(same(a.rotated270(), dynamicA.rotated270()));
+        REQUIRE(same(a.flippedHorizontal(), dynamicA.flippedHorizontal()));
+        REQUIRE(same(a.flippedVertical(), dynamicA.flippedVertical()));
+        REQUIRE(a.find(a(7, 9))->second <= 9);
+        REQUIRE(a.find(a(7, 9)) == dynamicA.find(a(7, 9)));
+
+        // Same hash as the dynamic grid, incremental updates included
+        REQUIRE(a.hash() == dynamicA.hash(std::execution::seq));
+        REQUIRE(std::hash<Chunk>{}(a) == std::hash<Vec2D<int>>{}(dynamicA));
+        const std::size_t before = a.hash();
+        const int old = a(3, 4);
+        a(3, 4) = 1000;
+        REQUIRE(a.updateHash(before, 3, 4, old, 1000) == a.hash());
+
+        // Views over the array
+        auto region = a.subview(2, 3, 4, 5);
+        region.at(0, 0) = -1;
+        REQUIRE(a(2, 3) == -1);
+        REQUIRE(std::as_const(a).view().dim() == Chunk::dim());
+
+        a.swap(b);
+        REQUIRE(b(2, 3) == -1);
+    }
+}
+
+TEST_CASE("Block compression")
+{
+    const auto roundTrip = [](const std::vector<std::byte>& raw)
+    {
+        std::vector<std::byte> packed(lz::compressBound(raw.size()));
+        packed.resize(lz::compress(raw.data(), raw.size(), packed.data()));
+
+        std::vector<std::byte> unpacked(raw.size());
+        lz::decompress(packed.data(), packed.size(), unpacked.data(), unpacked.size());
+        REQUIRE(unpacked == raw);
+        return packed.size();
+    };
+
+    std::mt19937 random(7);
+    std::vector<std::byte> noise(100000);
+    for (auto& b : noise)
+        b = static_cast<std::byte>(random());
+
+    REQUIRE(roundTrip({}) == 1);
+    REQUIRE(roundTrip(std::vector<std::byte>(12, std::byte{ 1 })) == 13);
+    REQUIRE(roundTrip(std::vector<std::byte>(100000, std::byte{ 0 })) < 500);
+    REQUIRE(roundTrip(noise) <= lz::compressBound(noise.size()));
+
+    // Repeats of a short pattern, overlapping matches
+    std::vector<std::byte> pattern(5000);
+    for (std::size_t i = 0; i < pattern.size(); ++i)
+        pattern[i] = static_cast<std::byte>(i % 3 == 0 ? i % 7 : 1);
+    REQUIRE(roundTrip(pattern) < 200);
+
+    // Malformed blocks never write past the output
+    std::vector<std::byte> packed(lz::compressBound(pattern.size()));
+    packed.resize(lz::compress(pattern.data(), pattern.size(), packed.data()));
+    std::vector<std::byte> out(pattern.size());
+    REQUIRE_THROWS_AS(lz::decompress(packed.data(), packed.size() - 1, out.data(), out.size()), std::runtime_error);
+    REQUIRE_THROWS_AS(lz::decompress(packed.data(), packed.size(), out.data(), out.size() - 1), std::runtime_error);
+
+    // One literal, then a match reaching back before the start
+    const std::vector<std::byte> backwards{ std::byte{ 0x10 }, std::byte{ 'a' }, std::byte{ 5 }, std::byte{ 0 }, std::byte{ 0 } };
+    REQUIRE_THROWS_AS(lz::decompress(backwards.data(), backwards.size(), out.data(), out.size()), std::runtime_error);
+}
+
+TEST_CASE("Binary save and load")
+{
+    Vec2D<float> grid(513, 300);
+    std::iota(grid.begin(), grid.end(), 0.0f);
+    grid.subview(100, 100, 200, 100).fill(0.0f);
+
+    SECTION("Round trips")
+    {
+        for (const auto compression : { vec2d::Compression::None, vec2d::Compression::Lz })
+        {
+            std::stringstream stream;
+            vec2d::save(stream, grid, compression);
+            REQUIRE(vec2d::load<float>(stream) == grid);
+
+            // Into storage which is not zero-filled first
+            stream.seekg(0);
+            const auto loaded = vec2d::load<float, RowMajor, DefaultInitStorage<float>>(stream);
+            REQUIRE(std::equal(loaded.begin(), loaded.end(), grid.begin(), grid.end()));
+        }
+
+        Vec2D<std::int32_t, Tiled<16, 16>> tiled(40, 33, 3);
+        tiled(39, 32) = -1;
+        std::stringstream stream;
+        vec2d::save(stream, tiled, vec2d::Compression::Lz);
+        REQUIRE((vec2d::load<std::int32_t, Tiled<16, 16>>(stream)) == tiled);
+
+        const Vec2D<double> empty(0, 0);
+        std::stringstream emptyStream;
+        vec2d::save(emptyStream, empty);
+        REQUIRE(vec2d::load<double>(emptyStream).empty());
+    }
+
+    SECTION("Compression")
+    {
+        std::stringstream raw;
+        std::stringstream packed;
+        const Vec2D<std::uint16_t> flat(1000, 1000, 42);
+        vec2d::save(raw, flat);
+        vec2d::save(packed, flat, vec2d::Compression::Lz);
+        REQUIRE(raw.str().size() == sizeof(vec2d::FileHeader) + 1000 * 1000 * sizeof(std::uint16_t));
+        REQUIRE(packed.str().size() < raw.str().size() / 100);
+        REQUIRE(vec2d::load<std::uint16_t>(packed) == flat);
+    }
+
+    SECTION("Other byte order")
+    {
+        std::stringstream stream;
+        vec2d::save(stream, grid);
+
+        // What a machine of the other byte order would have written
+        std::string bytes = stream.str();
+        auto header = vec2d::FileHeader{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.checksum = vec2d::checksum(reinterpret_cast<const std::byte*>(bytes.data()) + sizeof(header), bytes.size() - sizeof(header));
+        vec2d::byteSwap(header);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        for (std::size_t i = sizeof(header); i < bytes.size(); i += sizeof(float))
+            std::reverse(bytes.begin() + i, bytes.begin() + i + sizeof(float));
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        vec2d::byteSwap(header);
+        header.checksum = vec2d::checksum(reinterpret_cast<const std::byte*>(bytes.data()) + sizeof(header), bytes.size() - sizeof(header));
+        vec2d::byteSwap(header);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+
+        std::stringstream swapped(bytes);
+        REQUIRE(vec2d::load<float>(swapped) == grid);
+    }
+
+    SECTION("Damaged streams are rejected")
+    {
+        std::stringstream stream;
+        vec2d::save(stream, grid, vec2d::Compression::Lz);
+        const std::string bytes = stream.str();
+
+        std::string flipped = bytes;
+        flipped[bytes.size() / 2] = static_cast<char>(flipped[bytes.size() / 2] ^ 0x10);
+        std::stringstream damaged(flipped);
+        REQUIRE_THROWS_AS(vec2d::load<float>(damaged), std::runtime_error);
+
+        std::stringstream truncated(bytes.substr(0, bytes.size() - 10));
+        REQUIRE_THROWS_AS(vec2d::load<float>(truncated), std::runtime_error);
+
+        std::stringstream otherType(bytes);
+        REQUIRE_THROWS_AS(vec2d::load<std::int32_t>(otherType), std::runtime_error);
+
+        std::stringstream garbage("definitely not a grid, but long enough to hold a whole header of 64 bytes");
+        REQUIRE_THROWS_AS(vec2d::load<float>(garbage), std::runtime_error);
+    }
+
+    SECTION("Headers claiming more than the stream holds are rejected before allocating")
+    {
+        for (const auto compression : { vec2d::Compression::None, vec2d::Compression::Lz })
+        {
+            std::stringstream stream;
+            vec2d::save(stream, Vec2D<float>(4, 4, 1.0f), compression);
+            std::string bytes = stream.str();
+
+            // 2^47 elements, a 512 TiB allocation if the header were believed
+            auto header = vec2d::FileHeader{};
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            header.width = std::uint64_t{ 1 } << 24;
+            header.height = std::uint64_t{ 1 } << 23;
+            std::memcpy(bytes.data(), &header, sizeof(header));
+
+            std::stringstream claimed(bytes);
+            REQUIRE_THROWS_AS(vec2d::load<float>(claimed), std::runtime_error);
+        }
+    }
+
+    SECTION("A corrupt block among many throws instead of aborting")
+    {
+        // Several compression blocks, decompressed as one parallel batch
+        Vec2D<std::uint32_t> large(1024, 1024);
+        for (std::size_t i = 0; i < large.getData().size(); ++i)
+            large.getData()[i] = static_cast<std::uint32_t>(i % 1000);
+
+        std::stringstream stream;
+        vec2d::save(stream, large, vec2d::Compression::Lz);
+        std::string bytes = stream.str();
+
+        // Every block's size word claims its last byte is missing
+        for (std::size_t offset = sizeof(vec2d::FileHeader); offset < bytes.size();)
+        {
+            std::uint32_t word;
+            std::memcpy(&word, bytes.data() + offset, sizeof(word));
+            REQUIRE((word & vec2d::RawBlock) == 0);
+            const std::uint32_t shorter = word - 1;
+            std::memcpy(bytes.data() + offset, &shorter, sizeof(shorter));
+            offset += sizeof(word) + word;
+            bytes.erase(offset - 1, 1);
+            --offset;
+        }
+
+        std::stringstream corrupt(bytes);
+        REQUIRE_THROWS_AS(vec2d::load<std::uint32_t>(corrupt), std::runtime_error);
+    }
+
+    SECTION("An empty compressed block throws instead of leaving its elements unwritten")
+    {
+        Vec2D<std::uint32_t> small(16, 16, 7u);
+
+        std::stringstream stream;
+        vec2d::save(stream, small, vec2d::Compression::Lz);
+        std::string bytes = stream.str();
+
+        // Without a checksum, and with the old payload left trailing, nothing else would notice the block
+        // was never decompressed
+        auto header = vec2d::FileHeader{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.flags &= ~vec2d::FileHeader::Checksummed;
+        std::memcpy(bytes.data(), &header, sizeof(header));
+
+        std::uint32_t word;
+        std::memcpy(&word, bytes.data() + sizeof(header), sizeof(word));
+        REQUIRE((word & vec2d::RawBlock) == 0);
+        const std::uint32_t empty = 0;
+        std::memcpy(bytes.data() + sizeof(header), &empty, sizeof(empty));
+
+        std::stringstream corrupt(bytes);
+        REQUIRE_THROWS_AS(vec2d::load<std::uint32_t>(corrupt), std::runtime_error);
+    }
+
+#if defined(__linux__)
+    SECTION("Files")
+    {
+        const auto path = (std::filesystem::temp_directory_path() / "Vec2D_save_test.grid").string();
+
+        vec2d::save(path, grid, vec2d::Compression::Lz);
+        REQUIRE(vec2d::load<float>(path) == grid);
+        REQUIRE_THROWS_AS(vec2d::openMapped<float>(path), std::runtime_error);
+
+        // Uncompressed files map as they are, a shared mapping drops the checksum it could make stale
+        vec2d::save(path, grid);
+        {
+            auto mapped = vec2d::openMapped<float>(path);
+            REQUIRE(std::equal(mapped.begin(), mapped.end(), grid.begin(), grid.end()));
+            mapped(0, 0) = 1.0f;
+        }
+        REQUIRE(vec2d::load<float>(path)(0, 0) == 1.0f);
+
+        std::filesystem::remove(path);
+        REQUIRE_THROWS_AS(vec2d::load<float>(path), std::runtime_error);
+    }
+#endif
+}
+
+#if defined(__linux__)
+TEST_CASE("Memory-mapped grids")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "Vec2D_mapped_test.grid").string();
+
+    SECTION("Writes reach the file")
+    {
+        {
+            auto grid = vec2d::createMapped<float>(path, 300, 200);
+            REQUIRE(grid.dim() == std::make_pair(std::size_t{ 300 }, std::size_t{ 200 }));
+            REQUIRE(std::all_of(grid.begin(), grid.end(), [](float v) { return v == 0.0f; }));
+
+            std::iota(grid.begin(), grid.end(), 0.0f);
+            grid(7, 3) = -1.0f;
+            grid.getData().flush();
+        }
+
+        REQUIRE(std::filesystem::file_size(path) == sizeof(vec2d::FileHeader) + 300 * 200 * sizeof(float));
+
+        const auto grid = vec2d::openMapped<float>(path, vec2d::MapMode::Shared, vec2d::Access::Sequential);
+        REQUIRE(grid.at(3, 7) == -1.0f);
+        REQUIRE(grid(299, 199) == 300.0f * 200.0f - 1.0f);
+
+        // The whole interface works on mapped grids, and they mix with heap grids
+        const Vec2D<float> ones(300, 200, 1.0f);
+        const Vec2D<float> sum = grid + ones;
+        REQUIRE(sum(0, 0) == 1.0f);
+        REQUIRE(grid.find(-1.0f) == std::make_pair(std::size_t{ 7 }, std::size_t{ 3 }));
+        REQUIRE(grid.transposed()(3, 7) == -1.0f);
+    }
+
+    SECTION("Private mappings leave the file alone")
+    {
+        {
+            auto grid = vec2d::createMapped<int>(path, 16, 16);
+            grid.fill(5);
+        }
+
+        {
+            auto grid = vec2d::openMapped<int>(path, vec2d::MapMode::Private, vec2d::Access::Random);
+            grid.fill(9);
+            grid += 1;
+            REQUIRE(grid(3, 3) == 10);
+
+            // Writes survive being advised away
+            grid.getData().advise(vec2d::Access::DontNeed);
+            REQUIRE(grid(3, 3) == 10);
+            REQUIRE(std::all_of(grid.begin(), grid.end(), [](int v) { return v == 10; }));
+        }
+
+        auto grid = vec2d::openMapped<int>(path);
+        REQUIRE(grid(3, 3) == 5);
+
+        // Copies are anonymous memory
+        auto copy = grid;
+        copy(3, 3) = 1;
+        REQUIRE(grid(3, 3) == 5);
+
+        auto anonymous = grid;
+        anonymous.fill(7);
+        anonymous.getData().advise(vec2d::Access::DontNeed);
+        REQUIRE(std::all_of(anonymous.begin(), anonymous.end(), [](int v) { return v == 7; }));
+
+        // Resizing rebuilds into anonymous memory, the file keeps its size
+        copy.reserve(1000);
+        copy.resize(20, 10, -1);
+        REQUIRE(copy.dim() == std::make_pair(std::size_t{ 20 }, std::size_t{ 10 }));
+        REQUIRE(copy(3, 3) == 1);
+        REQUIRE(copy(15, 9) == 5);
+        REQUIRE(copy(16, 2) == -1);
+        grid.resize(4, 4);
+        REQUIRE(grid(3, 3) == 5);
+        REQUIRE(std::filesystem::file_size(path) == sizeof(vec2d::FileHeader) + 16 * 16 * sizeof(int));
+    }
+
+    SECTION("Other layouts")
+    {
+        {
+            auto grid = vec2d::createMapped<std::uint16_t, Tiled<8, 8>>(path, 20, 13);
+            for (std::size_t y = 0; y < 13; ++y)
+                for (std::size_t x = 0; x < 20; ++x)
+                    grid(x, y) = static_cast<std::uint16_t>(x + y * 20);
+        }
+
+        const auto grid = vec2d::openMapped<std::uint16_t, Tiled<8, 8>>(path);
+        std::vector<std::uint16_t> expected(20 * 13);
+        std::iota(expected.begin(), expected.end(), std::uint16_t{ 0 });
+        REQUIRE(std::equal(grid.begin(), grid.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("Mismatched files are rejected")
+    {
+        vec2d::createMapped<float>(path, 4, 4);
+
+        REQUIRE_THROWS_AS(vec2d::openMapped<int>(path), std::runtime_error);
+        REQUIRE_THROWS_AS(vec2d::openMapped<double>(path), std::runtime_error);
+        REQUIRE_THROWS_AS((vec2d::openMapped<float, Morton>(path)), std::runtime_error);
+        REQUIRE_THROWS_AS((vec2d::openMapped<float, Tiled<>>(path)), std::runtime_error);
+
+        std::filesystem::resize_file(path, sizeof(vec2d::FileHeader) + 15 * sizeof(float));
+        REQUIRE_THROWS_AS(vec2d::openMapped<float>(path), std::runtime_error);
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a grid";
+        REQUIRE_THROWS_AS(vec2d::openMapped<float>(path), std::runtime_error);
+
+        std::filesystem::remove(path);
+        REQUIRE_THROWS_AS(vec2d::openMapped<float>(path), std::system_error);
+    }
+
+    std::filesystem::remove(path);
+}
+#endif
+
+TEST_CASE("SIMD kernels match the scalar reference")
+{
+    // Odd sizes exercise the scalar tail of every vector width
+    constexpr std::size_t n = 1000 + 13;
+    std::vector<float> a(n), b(n);
+    std::vector<std::int16_t> c(n), d(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = static_cast<float>(i % 97) - 40.0f;
+        b[i] = static_cast<float>(i % 13) + 1.0f;
+        c[i] = static_cast<std::int16_t>(i % 251) - 100;
+        d[i] = static_cast<std::int16_t>(i % 7) + 1;
+    }
+
+    const auto best = simd::detectIsa();
+    for (auto isa : { simd::Isa::Scalar, simd::Isa::Sse, simd::Isa::Avx2, simd::Isa::Avx512 })
+    {
+        if (isa > best)
+            break;
+
+        std::vector<float> floats(n), expectedFloats(n);
+        simd::run<simd::Op::Div>(isa, floats.data(), a.data(), b.data(), 0.0f, 0.0f, n);
+        simd::scalarKernel<simd::Op::Div>(expectedFloats.data(), a.data(), b.data(), 0.0f, 0.0f, n);
+        REQUIRE(floats == expectedFloats);
+
+        simd::run<simd::Op::Clamp>(isa, floats.data(), a.data(), b.data(), -10.0f, 10.0f, n);
+        simd::scalarKernel<simd::Op::Clamp>(expectedFloats.data(), a.data(), b.data(), -10.0f, 10.0f, n);
+        REQUIRE(floats == expectedFloats);
+
+        std::vector<std::int16_t> shorts(n), expectedShorts(n);
+        simd::run<simd::Op::Mul>(isa, shorts.data(), c.data(), d.data(), std::int16_t{}, std::int16_t{}, n);
+        simd::scalarKernel<simd::Op::Mul>(expectedShorts.data(), c.data(), d.data(), std::int16_t{}, std::int16_t{}, n);
+        REQUIRE(shorts == expectedShorts);
+
+        simd::run<simd::Op::MaxScalar>(isa, shorts.data(), c.data(), d.data(), std::int16_t{ 3 }, std::int16_t{}, n);
+        simd::scalarKernel<simd::Op::MaxScalar>(expectedShorts.data(), c.data(), d.data(), std::int16_t{ 3 }, std::int16_t{}, n);
+        REQUIRE(shorts == expectedShorts);
+
+        // Small integer sums are exact in any order
+        REQUIRE(simd::reduce<simd::Reduction::Sum>(isa, a.data(), n, 0.0) == simd::scalarReduce<simd::Reduction::Sum>(a.data(), n, 0.0));
+        REQUIRE(simd::reduce<simd::Reduction::Sum>(isa, c.data(), n, std::int64_t{ 7 }) == simd::scalarReduce<simd::Reduction::Sum>(c.data(), n, std::int64_t{ 7 }));
+        REQUIRE(simd::reduce<simd::Reduction::Min>(isa, a.data(), n, 0.0f) == -40.0f);
+        REQUIRE(simd::reduce<simd::Reduction::Max>(isa, c.data(), n, std::int16_t{ -500 }) == 150);
+        REQUIRE(simd::reduce<simd::Reduction::Max>(isa, c.data(), 3, std::int16_t{ 500 }) == 500);
+    }
+}
+
+TEST_CASE("Vec2D element-wise throughput", "[.][benchmark]")
+{
+    // 4K x 4K floats, every pass reads two 64 MiB grids and writes one ( 192 MiB )
+    constexpr std::size_t side = 4096;
+    Vec2D<float> lhs(side, side, 1.0f);
+    Vec2D<float> rhs(side, side, 2.0f);
+
+    BENCHMARK("std::transform add")
+    {
+        auto& data = lhs.getData();
+        std::transform(data.begin(), data.end(), rhs.getData().begin(), data.begin(), std::plus<float>());
+        return data[0];
+    };
+
+    BENCHMARK("Dispatched add")
+    {
+        lhs += rhs;
+        return lhs.at(0, 0);
+    };
+
+    BENCHMARK("Dispatched multiply-add")
+    {
+        lhs.multiplyAdd(rhs, rhs);
+        return lhs.at(0, 0);
+    };
+
+    BENCHMARK("Dispatched clamp")
+    {
+        lhs.clamp(0.0f, 100.0f);
+        return lhs.at(0, 0);
+    };
+}
+
+TEST_CASE("Vec2D expression bandwidth", "[.][benchmark]")
+{
+    // a + b - c + d over 4K x 4K floats
+    constexpr std::size_t side = 4096;
+    Vec2D<float> a(side, side, 1.0f);
+    Vec2D<float> b(side, side, 2.0f);
+    Vec2D<float> c(side, side, 3.0f);
+    Vec2D<float> d(side, side, 4.0f);
+
+    BENCHMARK("Temporary per operator")
+    {
+        // What operator+( Vec2D lhs, const Vec2D& rhs ) used to do: copy, then update in place, per step
+        Vec2D<float> step1(a);
+        step1 += b;
+        Vec2D<float> step2(step1);
+        step2 -= c;
+        Vec2D<float> step3(step2);
+        step3 += d;
+        return step3.at(0, 0);
+    };
+
+    BENCHMARK("Fused expression")
+    {
+        Vec2D<float> result = a + b - c + d;
+        return result.at(0, 0);
+    };
+}
+
+TEST_CASE("Vec2D layout transpose and stencil", "[.][benchmark]")
+{
+    // 4K x 4K floats, 64 MiB per grid: rows are 16 KiB apart, so column walks miss cache and TLB
+    constexpr std::size_t side = 4096;
+
+    Vec2D<float> rowMajor(side, side, 1.0f);
+    Vec2D<float> rowMajorOut(side, side);
+    Vec2D<float, Tiled<>> tiled(side, side, 1.0f);
+    Vec2D<float, Tiled<>> tiledOut(side, side);
+
+    const auto transpose = [&](const auto& in, auto& out)
+    {
+        for (std::size_t y = 0; y < side; ++y)
+            for (std::size_t x = 0; x < side; ++x)
+                out(y, x) = in(x, y);
+        return out(1, 0);
+    };
+
+    const auto stencil = [&](const auto& in, auto& out)
+    {
+        for (std::size_t y = 1; y + 1 < side; ++y)
+            for (std::size_t x = 1; x + 1 < side; ++x)
+                out(x, y) = 0.2f * (in(x, y) + in(x - 1, y) + in(x + 1, y) + in(x, y - 1) + in(x, y + 1));
+        return out(1, 1);
+    };
+
+    BENCHMARK("Row-major transpose")
+    {
+        return transpose(rowMajor, rowMajorOut);
+    };
+
+    BENCHMARK("Tiled transpose")
+    {
+        return transpose(tiled, tiledOut);
+    };
+
+    BENCHMARK("Tiled transpose, tile by tile")
+    {
+        // Tile x, y lands in tile y, x of the output, both 16 KiB and contiguous
+        tiled.forEachTile([&](const Vec2DTile<const float>& tile)
+        {
+            for (std::size_t row = 0; row < tile.height; ++row)
+                for (std::size_t col = 0; col < tile.width; ++col)
+                    tiledOut(tile.y + row, tile.x + col) = tile.at(row, col);
+        });
+        return tiledOut(1, 0);
+    };
+
+    BENCHMARK("Row-major 5-point stencil")
+    {
+        return stencil(rowMajor, rowMajorOut);
+    };
+
+    BENCHMARK("Tiled 5-point stencil")
+    {
+        return stencil(tiled, tiledOut);
+    };
+
+    BENCHMARK("Tiled 5-point stencil, tile by tile")
+    {
+        tiledOut.forEachTile([&](const Vec2DTile<float>& tile)
+        {
+            // Same layout, so the input tile has the same shape and stride
+            const float* src = &tiled(tile.x, tile.y);
+            const std::size_t stride = tile.stride;
+
+            for (std::size_t row = 0; row < tile.height; ++row)
+            {
+                const std::size_t y = tile.y + row;
+                if (y == 0 || y + 1 == side)
+                    continue;
+
+                for (std::size_t col = 0; col < tile.width; ++col)
+                {
+                    const std::size_t x = tile.x + col;
+                    if (x == 0 || x + 1 == side)
+                        continue;
+
+                    // Neighbours across a tile edge live in another tile
+                    if (row == 0 || col == 0 || row + 1 == tile.height || col + 1 == tile.width)
+                    {
+                        tile.at(row, col) = 0.2f * (tiled(x, y) + tiled(x - 1, y) + tiled(x + 1, y) + tiled(x, y - 1) + tiled(x, y + 1));
+                        continue;
+                    }
+
+                    const float* p = src + col + row * stride;
+                    tile.at(row, col) = 0.2f * (p[0] + p[-1] + p[1] + p[-static_cast<std::ptrdiff_t>(stride)] + p[stride]);
+                }
+            }
+        });
+        return tiledOut(1, 1);
+    };
+}
+
+TEST_CASE("Vec2D transpose and rotation", "[.][benchmark]")
+{
+    // 4K x 2K floats, 32 MiB each way
+    Vec2D<float> grid(4096, 2048, 1.0f);
+    Vec2D<float> out(2048, 4096);
+    Vec2D<float> square(4096, 4096, 1.0f);
+
+    BENCHMARK("Naive transpose with at()")
+    {
+        for (std::size_t y = 0; y < 2048; ++y)
+            for (std::size_t x = 0; x < 4096; ++x)
+                out(y, x) = grid(x, y);
+        return out(1, 0);
+    };
+
+    BENCHMARK("Blocked transpose")
+    {
+        vec2d::transpose(grid.view(), out.view());
+        return out(1, 0);
+    };
+
+    BENCHMARK("Blocked rotate90")
+    {
+        vec2d::rotate90(grid.view(), out.view());
+        return out(1, 0);
+    };
+
+    BENCHMARK("In place square transpose")
+    {
+        square.transpose();
+        return square(1, 0);
+    };
+}
+
+#if defined(__linux__)
+TEST_CASE("Vec2D file-backed startup", "[.][benchmark]")
+{
+    // 8K x 8K floats, 256 MiB on disk
+    constexpr std::size_t side = 8192;
+    const auto path = (std::filesystem::temp_directory_path() / "Vec2D_startup_bench.grid").string();
+    {
+        auto grid = vec2d::createMapped<float>(path, side, side);
+        grid.fill(1.0f);
+    }
+
+    BENCHMARK("Read the whole file into a Vec2D")
+    {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(sizeof(vec2d::FileHeader));
+        Vec2D<float> grid(side, side);
+        file.read(reinterpret_cast<char*>(grid.getData().data()), static_cast<std::streamsize>(side * side * sizeof(float)));
+        return grid(side / 2, side / 2);
+    };
+
+    BENCHMARK("Map the file and read one element")
+    {
+        const auto grid = vec2d::openMapped<float>(path, vec2d::MapMode::Private, vec2d::Access::Random);
+        return grid(side / 2, side / 2);
+    };
+
+    BENCHMARK("Map the file and sum every element")
+    {
+        const auto grid = vec2d::openMapped<float>(path, vec2d::MapMode::Private, vec2d::Access::Sequential);
+        return std::accumulate(grid.begin(), grid.end(), 0.0);
+    };
+
+    std::filesystem::remove(path);
+}
+#endif
+
+#if defined(__linux__)
+TEST_CASE("Vec2D save and load throughput", "[.][benchmark]")
+{
+    // 4K x 4K floats, 64 MiB, smooth enough to compress. Files stay in the page cache, this measures everything but the disk
+    constexpr std::size_t side = 4096;
+    Vec2D<float> grid(side, side);
+    for (std::size_t y = 0; y < side; ++y)
+        for (std::size_t x = 0; x < side; ++x)
+            grid(x, y) = static_cast<float>((x / 16) * (y / 16) % 251);
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto elementwise = (directory / "Vec2D_elementwise_bench.bin").string();
+    const auto raw = (directory / "Vec2D_raw_bench.grid").string();
+    const auto packed = (directory / "Vec2D_packed_bench.grid").string();
+
+    BENCHMARK("Save element by element")
+    {
+        std::ofstream out(elementwise, std::ios::binary | std::ios::trunc);
+        for (const float value : grid)
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        return out.tellp();
+    };
+
+    BENCHMARK("Save raw")
+    {
+        vec2d::save(raw, grid);
+    };
+
+    BENCHMARK("Save compressed")
+    {
+        vec2d::save(packed, grid, vec2d::Compression::Lz);
+    };
+
+    BENCHMARK("Load element by element")
+    {
+        std::ifstream in(elementwise, std::ios::binary);
+        Vec2D<float> loaded(side, side);
+        for (float& value : loaded)
+            in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return loaded(1, 1);
+    };
+
+    BENCHMARK("Load raw")
+    {
+        return vec2d::load<float>(raw)(1, 1);
+    };
+
+    BENCHMARK("Load raw, no zero fill")
+    {
+        return vec2d::load<float, RowMajor, DefaultInitStorage<float>>(raw)(1, 1);
+    };
+
+    BENCHMARK("Load compressed")
+    {
+        return vec2d::load<float>(packed)(1, 1);
+    };
+
+    BENCHMARK("Load compressed, no zero fill")
+    {
+        return vec2d::load<float, RowMajor, DefaultInitStorage<float>>(packed)(1, 1);
+    };
+
+    WARN("Compressed to " << std::filesystem::file_size(packed) << " bytes from " << std::filesystem::file_size(raw));
+    std::filesystem::remove(elementwise);
+    std::filesystem::remove(raw);
+    std::filesystem::remove(packed);
+}
+#endif
+
+TEST_CASE("Sparse grid access", "[.][benchmark]")
+{
+    // 1M points in 100 dense clusters over a 1M x 1M world
+    std::mt19937 random(3);
+    std::vector<std::pair<std::size_t, std::size_t>> points;
+    for (int cluster = 0; cluster < 100; ++cluster)
+    {
+        const std::size_t cx = random() % 999000;
+        const std::size_t cy = random() % 999000;
+        for (int i = 0; i < 10000; ++i)
+            points.emplace_back(cx + random() % 256, cy + random() % 256);
+    }
+
+    const auto key = [](std::size_t x, std::size_t y) { return x + y * 1000000; };
+
+    BENCHMARK("Cell map, write then read")
+    {
+        std::unordered_map<std::size_t, int> cells;
+        for (const auto& [x, y] : points)
+            cells[key(x, y)] = 1;
+
+        int sum = 0;
+        for (const auto& [x, y] : points)
+        {
+            const auto it = cells.find(key(x + 1, y));
+            sum += it == cells.end() ? 0 : it->second;
+        }
+        return sum;
+    };
+
+    BENCHMARK("Sparse grid, write then read")
+    {
+        SparseVec2D<int> world(1000000, 1000000, 0);
+        for (const auto& [x, y] : points)
+            world(x, y) = 1;
+
+        const auto& constWorld = world;
+        int sum = 0;
+        for (const auto& [x, y] : points)
+            sum += constWorld(x + 1, y);
+        return sum;
+    };
+}
+
+TEST_CASE("Vec2D hash throughput", "[.][benchmark]")
+{
+    // 4K x 4K ints, 64 MiB
+    constexpr std::size_t side = 4096;
+    Vec2D<int> grid(side, side);
+    std::iota(grid.begin(), grid.end(), 0);
+
+    BENCHMARK("XOR of std::hash")
+    {
+        std::size_t h = 0;
+        for (const int value : grid.getData())
+            h ^= std::hash<int>()(value);
+        return h;
+    };
+
+    BENCHMARK("Positional hash")
+    {
+        return grid.hash(std::execution::seq);
+    };
+
+    BENCHMARK("Positional hash, parallel")
+    {
+        return grid.hash(std::execution::par);
+    };
+
+    std::size_t h = grid.hash(std::execution::seq);
+    BENCHMARK("Incremental update of one cell")
+    {
+        h = grid.updateHash(h, 17, 42, grid(17, 42), grid(17, 42) + 1);
+        return h;
+    };
+}
+
+TEST_CASE("Static grid construction", "[.][benchmark]")
+{
+    // A million 8x8 boards, e.g. the positions of a game tree search
+    constexpr std::size_t count = 1000000;
+
+    BENCHMARK("Vec2D boards")
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Vec2D<std::uint8_t> board(8, 8, 0);
+            board(i % 8, (i / 8) % 8) = 1;
+            total += board(3, 3);
+        }
+        return total;
+    };
+
+    BENCHMARK("Static boards")
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            StaticVec2D<std::uint8_t, 8, 8> board;
+            board(i % 8, (i / 8) % 8) = 1;
+            total += board(3, 3);
+        }
+        return total;
+    };
+
+    std::vector<Vec2D<std::uint8_t>> dynamicBoards(1000, Vec2D<std::uint8_t>(8, 8, 1));
+    std::vector<StaticVec2D<std::uint8_t, 8, 8>> staticBoards(1000, StaticVec2D<std::uint8_t, 8, 8>(1));
+
+    BENCHMARK("Vec2D boards, at() over every cell")
+    {
+        std::size_t total = 0;
+        for (const auto& board : dynamicBoards)
+            for (std::size_t y = 0; y < 8; ++y)
+                for (std::size_t x = 0; x < 8; ++x)
+                    total += board.at(y, x);
+        return total;
+    };
+
+    BENCHMARK("Static boards, at() over every cell")
+    {
+        std::size_t total = 0;
+        for (const auto& board : staticBoards)
+            for (std::size_t y = 0; y < 8; ++y)
+                for (std::size_t x = 0; x < 8; ++x)
+                    total += board.at(y, x);
+        return total;
+    };
+}
+
+TEST_CASE("Vec2D construction and resize", "[.][benchmark]")
+{
+    // 2K x 2K ints, 16 MiB
+    constexpr std::size_t side = 2048;
+    const std::vector<std::vector<int>> rows(side, std::vector<int>(side, 1));
+    const std::vector<std::vector<std::string>> names(256, std::vector<std::string>(256, "a name too long for inline storage"));
+
+    BENCHMARK("Rows of ints, copied")
+    {
+        return Vec2D<int>(rows).dim();
+    };
+
+    BENCHMARK_ADVANCED("Rows of strings, copied")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure([&] { return Vec2D<std::string>(names).dim(); });
+    };
+
+    BENCHMARK_ADVANCED("Rows of strings, consumed")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::vector<std::vector<std::string>>> copies(meter.runs(), names);
+        meter.measure([&](int i) { return Vec2D<std::string>(std::move(copies[i])).dim(); });
+    };
+
+    const Vec2D<int> grid(rows);
+
+    BENCHMARK("Transposed")
+    {
+        return grid.transposed().dim();
+    };
+
+    BENCHMARK("Grow by rebuilding")
+    {
+        Vec2D<int> grown(side + 64, side, 0);
+        for (std::size_t y = 0; y < side; ++y)
+            for (std::size_t x = 0; x < side; ++x)
+                grown(x, y) = grid(x, y);
+        return grown.dim();
+    };
+
+    BENCHMARK_ADVANCED("Grow in place")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Vec2D<int>> copies(meter.runs(), grid);
+        for (auto& copy : copies)
+            copy.reserve((side + 64) * side);
+        meter.measure([&](int i) { copies[i].resize(side + 64, side, 0); return copies[i].dim(); });
+    };
+}
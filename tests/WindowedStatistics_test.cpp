@@ -0,0 +1,105 @@
+#include "WindowedStatistics.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /**
+     * Recomputes everything from scratch over the window.
+     */
+    template <typename Stats>
+    void requireMatchesWindow(const Stats& stats)
+    {
+        const auto& samples = stats.samples();
+        const auto count = static_cast<double>(samples.size());
+        const double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+        const double mean = sum / count;
+
+        double squares = 0.0;
+        for (auto sample : samples)
+            squares += (sample - mean) * (sample - mean);
+
+        REQUIRE(stats.min() == *std::min_element(samples.begin(), samples.end()));
+        REQUIRE(stats.max() == *std::max_element(samples.begin(), samples.end()));
+        REQUIRE(std::abs(stats.sum() - sum) < 1e-6);
+        REQUIRE(std::abs(stats.mean() - mean) < 1e-9);
+        REQUIRE(std::abs(stats.variance() - squares / count) < 1e-6);
+    }
+}
+
+TEST_CASE("WindowedStatistics add function")
+{
+    WindowedStatistics<int, 3> stats;
+
+    REQUIRE(stats.empty());
+    REQUIRE(stats.mean() == 0.0);
+    REQUIRE_THROWS_AS(stats.min(), std::underflow_error);
+
+    REQUIRE(stats.add(4) == std::nullopt);
+    REQUIRE(stats.add(2) == std::nullopt);
+    REQUIRE(stats.add(9) == std::nullopt);
+    REQUIRE(stats.min() == 2);
+    REQUIRE(stats.max() == 9);
+    REQUIRE(stats.sum() == 15.0);
+    REQUIRE(stats.mean() == 5.0);
+
+    // 4 leaves the window
+    REQUIRE(stats.add(3) == 4);
+    REQUIRE(stats.min() == 2);
+    REQUIRE(stats.sum() == 14.0);
+
+    // 2 leaves the window, the minimum moves on
+    REQUIRE(stats.add(5) == 2);
+    REQUIRE(stats.min() == 3);
+    REQUIRE(stats.max() == 9);
+
+    // 9 leaves the window, the maximum moves on
+    REQUIRE(stats.add(1) == 9);
+    REQUIRE(stats.min() == 1);
+    REQUIRE(stats.max() == 5);
+    REQUIRE(std::abs(stats.variance() - 8.0 / 3.0) < 1e-12);
+    REQUIRE(std::abs(stats.sampleVariance() - 4.0) < 1e-12);
+}
+
+TEST_CASE("WindowedStatistics matches a full recomputation")
+{
+    WindowedStatistics<double, 16> stats;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(-100.0, 100.0);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        stats.add(dist(rng));
+        requireMatchesWindow(stats);
+    }
+
+    SECTION("Resize shrinks the window")
+    {
+        stats.resize(5);
+        REQUIRE(stats.size() == 5);
+        requireMatchesWindow(stats);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            stats.add(dist(rng));
+            REQUIRE(stats.size() == 5);
+            requireMatchesWindow(stats);
+        }
+    }
+
+    SECTION("Clear")
+    {
+        stats.clear();
+        REQUIRE(stats.empty());
+        REQUIRE(stats.sum() == 0.0);
+
+        stats.add(2.0);
+        REQUIRE(stats.min() == 2.0);
+        REQUIRE(stats.variance() == 0.0);
+    }
+}